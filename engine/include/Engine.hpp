@@ -47,6 +47,7 @@
 #include <Engine/Actor.hpp>
 #include <Engine/DefaultBitmapHelpers.hpp>
 #include <Engine/GameClock.hpp>
+#include <Engine/PathFinder.hpp>
 #include <Engine/Resource.hpp>
 #include <Engine/ResourcePtr.hpp>
 #include <Engine/World.hpp>
@@ -63,6 +64,9 @@
 #include <Engine/Platform/InputSystem.hpp>
 #include <Engine/Platform/Painter.hpp>
 #include <Engine/Platform/Stream.hpp>
+#include <Engine/Platform/BufferedStream.hpp>
+#include <Engine/Platform/ArchiveFormat.hpp>
+#include <Engine/Platform/MapFormat.hpp>
 #include <Engine/Platform/ResourceLoader.hpp>
 #include <Engine/Platform/ResourceLoaderOptions.hpp>
 #include <Engine/Platform/ResourceManager.hpp>
@@ -26,6 +26,8 @@ public:
 
   [[nodiscard]] auto Size() const { return _size; }
 
+  void Type(BodyType newType) noexcept { _type = newType; }
+
   [[nodiscard]] auto Type() const noexcept { return _type; }
 };
 }// namespace e00
@@ -69,5 +69,21 @@ E00_ALWAYS_INLINE T relaxed_load(T const *t) {
 }
 
 constexpr size_t MaxActorsInWorld = 512;
+
+// Tiles the path finder of the current world may look at every tick
+constexpr size_t PathSearchBudgetPerTick = 4096;
+
+// Resources loaded in the background at the same time, each on its own thread
+constexpr size_t BackgroundLoadsInFlight = 4;
+
+// DOS threads are cooperative and nothing switches to them, background loads happen during ResourceManager::Tick()
+#ifdef __DJGPP__
+constexpr bool BackgroundLoadThreads = false;
+#else
+constexpr bool BackgroundLoadThreads = true;
+#endif
+
+// Bytes a buffered stream reads ahead at a time, see BufferedStream
+constexpr size_t StreamBlockSize = 4096;
 }// namespace detail
 }// namespace e00
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <bit>
 #include <cstdint>
 #include <cstring>
@@ -122,6 +123,27 @@ struct BitmapDepth1 {
       lineData[byteIndex] &= static_cast<uint8_t>(~bitMask);
     }
   }
+
+  static void Fill(std::span<uint8_t> &lineData, BitmapSizeType x, BitmapSizeType count, bool color) {
+    size_t first = x;
+    const size_t last = std::min<size_t>(first + count, lineData.size() * 8);
+    const uint8_t fill = color ? 0xFF : 0x00;
+
+    // Leading bits up to the first byte boundary
+    for (; first < last && (first % 8) != 0; ++first) {
+      WriteColor(lineData, static_cast<BitmapSizeType>(first), color);
+    }
+
+    // Whole bytes
+    const size_t wholeBytes = (last - first) / 8;
+    std::memset(lineData.data() + first / 8, fill, wholeBytes);
+    first += wholeBytes * 8;
+
+    // Trailing bits
+    for (; first < last; ++first) {
+      WriteColor(lineData, static_cast<BitmapSizeType>(first), color);
+    }
+  }
 };
 
 struct BitmapDepth8 {
@@ -140,6 +162,13 @@ struct BitmapDepth8 {
   static void WriteColor(std::span<uint8_t> &lineData, BitmapSizeType x, uint8_t color) {
     lineData[x] = color;
   }
+
+  static void Fill(std::span<uint8_t> &lineData, BitmapSizeType x, BitmapSizeType count, uint8_t color) {
+    if (x >= lineData.size())
+      return;
+
+    std::memset(lineData.data() + x, color, std::min<size_t>(count, lineData.size() - x));
+  }
 };
 
 struct BitmapDepth16 {
@@ -166,6 +195,16 @@ struct BitmapDepth16 {
         ExtractAndScaleChannel(raw, shift.blue, mask.blue)};
   }
 
+  static constexpr Type PackColor(const Color &color,
+                                  const DrawableSurface::RGBInfo &shift = DefaultShift,
+                                  const DrawableSurface::RGBInfo &mask = DefaultMask) {
+    Type dstColor = 0;
+    dstColor |= CompressAndShiftChannel<Type>(color.red, shift.red, mask.red);
+    dstColor |= CompressAndShiftChannel<Type>(color.green, shift.green, mask.green);
+    dstColor |= CompressAndShiftChannel<Type>(color.blue, shift.blue, mask.blue);
+    return dstColor;
+  }
+
   static void WriteColor(std::span<uint8_t> &lineData,
                          BitmapSizeType x,
                          const Color &color,
@@ -174,12 +213,19 @@ struct BitmapDepth16 {
     if (x >= lineData.size() / sizeof(Type))
       return;
 
-    Type dstColor = 0;
-    dstColor |= CompressAndShiftChannel<Type>(color.red, shift.red, mask.red);
-    dstColor |= CompressAndShiftChannel<Type>(color.green, shift.green, mask.green);
-    dstColor |= CompressAndShiftChannel<Type>(color.blue, shift.blue, mask.blue);
+    store_pixel<Type>(lineData, x, PackColor(color, shift, mask));
+  }
 
-    store_pixel<Type>(lineData, x, dstColor);
+  // Writes `count` copies of an already packed pixel; the loop is simple enough to be turned into wide stores
+  static void Fill(std::span<uint8_t> &lineData, BitmapSizeType x, BitmapSizeType count, Type raw) {
+    const size_t pixels = lineData.size() / sizeof(Type);
+    if (x >= pixels)
+      return;
+
+    const size_t end = std::min<size_t>(static_cast<size_t>(x) + count, pixels);
+    for (size_t i = x; i < end; ++i) {
+      store_pixel<Type>(lineData, i, raw);
+    }
   }
 };
 
@@ -207,6 +253,16 @@ struct BitmapDepth32 {
         ExtractAndScaleChannel(raw, shift.blue, mask.blue)};
   }
 
+  static constexpr Type PackColor(const Color &color,
+                                  const DrawableSurface::RGBInfo &shift = DefaultShift,
+                                  const DrawableSurface::RGBInfo &mask = DefaultMask) {
+    Type dstColor = 0;
+    dstColor |= CompressAndShiftChannel<Type>(color.red, shift.red, mask.red);
+    dstColor |= CompressAndShiftChannel<Type>(color.green, shift.green, mask.green);
+    dstColor |= CompressAndShiftChannel<Type>(color.blue, shift.blue, mask.blue);
+    return dstColor;
+  }
+
   static void WriteColor(std::span<uint8_t> &lineData,
                          BitmapSizeType x,
                          const Color &color,
@@ -215,12 +271,19 @@ struct BitmapDepth32 {
     if (x >= lineData.size() / sizeof(Type))
       return;
 
-    Type dstColor = 0;
-    dstColor |= CompressAndShiftChannel<Type>(color.red, shift.red, mask.red);
-    dstColor |= CompressAndShiftChannel<Type>(color.green, shift.green, mask.green);
-    dstColor |= CompressAndShiftChannel<Type>(color.blue, shift.blue, mask.blue);
+    store_pixel<Type>(lineData, x, PackColor(color, shift, mask));
+  }
+
+  // Writes `count` copies of an already packed pixel; the loop is simple enough to be turned into wide stores
+  static void Fill(std::span<uint8_t> &lineData, BitmapSizeType x, BitmapSizeType count, Type raw) {
+    const size_t pixels = lineData.size() / sizeof(Type);
+    if (x >= pixels)
+      return;
 
-    store_pixel<Type>(lineData, x, dstColor);
+    const size_t end = std::min<size_t>(static_cast<size_t>(x) + count, pixels);
+    for (size_t i = x; i < end; ++i) {
+      store_pixel<Type>(lineData, i, raw);
+    }
   }
 };
 
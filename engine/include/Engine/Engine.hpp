@@ -7,7 +7,9 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <span>
 #include <system_error>
+#include <vector>
 
 namespace e00 {
 
@@ -40,11 +42,25 @@ class Engine {
   std::unique_ptr<World> _current_world;                  //< Currently main world
   std::unique_ptr<Widget> _root_widget;                   //< Root widget where we draw from
   std::unique_ptr<TranslatableText> _strings;             //< Strings dictionary
+  std::vector<World::OverlapPair> _overlaps;              //< Overlapping actors found this tick
+  std::string _prefetch_world_name;                       //< World PrefetchWorld() is loading, empty if none
+  std::vector<ResourcePtrT<Resource>> _prefetch_dependencies;//< What its map needs, loaded first
+  ResourcePtrT<Map> _prefetch_map;                        //< Its map, once the dependencies are in
+  bool _switch_when_prefetched{};                         //< LoadWorldAsync() asked for it
 
   PlatformData *_platform_data;// << Opaque data associated with this instance, platform is responsible for managing it
 
   void ExecuteActionsAtTime(const GameClock::time_point &tp);
 
+  // Replaces the current world with a new one around `map`
+  void SwitchWorld(const std::string &world_name, ResourcePtrT<Map> &&map);
+
+  // Moves the prefetch along, switching to the world once its map is in if LoadWorldAsync() asked for it
+  void UpdatePrefetch();
+
+  // Forgets the prefetched world
+  void ClearPrefetch();
+
 protected:
   explicit Engine();
 
@@ -84,6 +100,14 @@ protected:
    */
   virtual void OnWorldLoaded(const std::unique_ptr<World> &new_world) {}
 
+  /**
+   * Called every tick the actors of the current world overlap, see World::FindOverlaps
+   *
+   * @param world the current world
+   * @param overlaps the overlapping pairs, only valid during the call
+   */
+  virtual void OnActorsOverlap(World &/*world*/, std::span<const World::OverlapPair> /*overlaps*/) {}
+
   /**
    * 
    * @param locale the locale of the text to add
@@ -174,13 +198,38 @@ public:
   [[nodiscard]] GameClock::time_point Now() const noexcept { return _current_game_time; }
 
   /**
-   * Load a new world
+   * Load a new world; if its map can't be loaded, the current world stays
    * 
    * @param world_name the ressource name
    * @return any errors
    */
   std::error_code LoadWorld(const std::string &world_name);
 
+  /**
+   * Starts loading a world in the background, while the current one keeps running. Everything its map
+   * needed the last time it was loaded (see ResourceManager::DependenciesOf()) is loaded first, in
+   * parallel, then the map itself. LoadWorld() or LoadWorldAsync() on that world later finds it loaded.
+   * Prefetching another world drops this one.
+   *
+   * @param world_name the ressource name
+   * @return any errors
+   */
+  std::error_code PrefetchWorld(const std::string &world_name);
+
+  /**
+   * Load a new world in the background; the current world keeps ticking and drawing until the new one
+   * is loaded, then they are swapped during Tick(). Loading another world before that replaces this one.
+   *
+   * @param world_name the ressource name
+   * @return any errors
+   */
+  std::error_code LoadWorldAsync(const std::string &world_name);
+
+  /**
+   * @return true while LoadWorldAsync() is loading a world
+   */
+  [[nodiscard]] bool IsLoadingWorld() const noexcept { return _switch_when_prefetched; }
+
   /**
    * Processes a delta tick
    *
@@ -33,10 +33,10 @@ public:
   void SetFont(Font &font);
   [[nodiscard]] Font &GetFont() const noexcept;
 
-  void SetForegroundColor(const Color &color) noexcept { _foreground_color = color; }
+  void SetForegroundColor(const Color &color);
   [[nodiscard]] const Color &ForegroundColor() const noexcept { return _foreground_color; }
 
-  void SetBackgroundColor(const Color &color) noexcept { _background_color = color; }
+  void SetBackgroundColor(const Color &color);
   [[nodiscard]] const Color &BackgroundColor() const noexcept { return _background_color; }
 
   void Paint(Painter &painterObj) override;
@@ -56,6 +56,14 @@ private:
   BackgroundType _background_type = BackgroundType::None;
   Color _background_color;
 
+  // Repainting; the dirty rects are only kept on the root widget, in absolute coordinates
+  std::vector<RectT<SIZE_TYPE>> _dirty_rects;
+  bool _always_repaint = false;
+
+  Widget *Root();
+  void AddDirtyRect(RectT<SIZE_TYPE> rect);
+  void CollectAlwaysRepaint(std::vector<RectT<SIZE_TYPE>> &rects) const;
+
 protected:
   virtual void ResizeEvent() {
     _has_computed_size = false;
@@ -177,6 +185,46 @@ public:
   [[nodiscard]] bool HasFocus() const { return _has_focus; }
   [[nodiscard]] bool CanHaveFocus() const { return _can_have_focus; }
 
+  // Past this many separate dirty rects, they are merged into their bounding rect
+  static constexpr size_t MAX_DIRTY_RECTS = 16;
+
+  /**
+   * @brief Marks the whole area of this widget as needing a repaint.
+   */
+  void Invalidate();
+
+  /**
+   * @brief Marks an area as needing a repaint.
+   *
+   * The area is recorded on the root widget; touching or overlapping areas are merged.
+   *
+   * @param absoluteRect The area, in absolute coordinates.
+   */
+  void Invalidate(const RectT<SIZE_TYPE> &absoluteRect);
+
+  /**
+   * @brief Repaints this widget on every frame, for content that changes on its own (e.g. the world view).
+   */
+  void SetAlwaysRepaint(bool alwaysRepaint);
+  [[nodiscard]] bool AlwaysRepaint() const { return _always_repaint; }
+
+  /**
+   * @brief Returns the areas needing a repaint, and clears them.
+   *
+   * Only meaningful on the root widget. Widgets that always repaint are included.
+   *
+   * @return The dirty areas, in absolute coordinates; empty if nothing changed.
+   */
+  [[nodiscard]] std::vector<RectT<SIZE_TYPE>> TakeDirtyRects();
+
+  /**
+   * @brief Paints only the given areas, the painter being clipped to each area in turn.
+   *
+   * @param painterObj Painter to draw with.
+   * @param rects The areas to repaint, in absolute coordinates.
+   */
+  void PaintDirtyRects(Painter &painterObj, std::span<const RectT<SIZE_TYPE>> rects);
+
   void SetCanProcessActions(bool canProcessActions);
   [[nodiscard]] bool CanProcessActions() const { return _can_process_actions; }
   virtual ActionProcessResult ProcessAction(const ActionInstance &);
@@ -6,17 +6,57 @@ class WorldWidget : public Widget {
   const std::unique_ptr<World> &_worldToDraw;
   Vec2D<uint16_t> _cameraCenter;
 
-  void DrawWorld(Painter &painter, const World &world);
+  // Camera center in map pixels; when following a tile, it's the middle of `_cameraCenter`
+  Vec2D<uint32_t> _cameraCenterPixels;
+  bool _cameraFollowsTile = true;
+
+  /**
+   * The map as seen at the last paint, in the target's format. When the camera moves by less than the view,
+   * the pixels still visible are moved and only the newly exposed strips are painted.
+   */
+  struct ScrollBuffer {
+    std::unique_ptr<Bitmap> pixels;
+    Vec2D<uint32_t> worldOrigin;// Map pixel at the top left of the buffer
 
-protected:
-  void ResizeEvent() override;
+    // What the content was painted from; any change means a full repaint
+    const Map *map{};
+    uint32_t mapRevision{};
+    DrawableSurface::TargetInformation format{};
+    uint32_t paletteRevision{};
+  } _scroll;
+
+  void DrawWorld(Painter &painter, const World &world);
+  void UpdateScrollBuffer(const DrawableSurface::TargetInformation &format, Map &map, const Vec2D<uint32_t> &worldOrigin, const Vec2D<BitmapSizeType> &size);
 
 public:
   explicit WorldWidget(const std::unique_ptr<World> &worldToDraw);
   ~WorldWidget() override = default;
 
+  /**
+   * @return the tile the camera is centered on
+   */
   [[nodiscard]] const Vec2D<uint16_t> &CameraCenter() const { return _cameraCenter; }
-  void SetCameraCenter(const Vec2D<uint16_t> &camera_center) { _cameraCenter = camera_center; }
+
+  /**
+   * Centers the camera on the middle of tile `camera_center`
+   */
+  void SetCameraCenter(const Vec2D<uint16_t> &camera_center) {
+    _cameraCenter = camera_center;
+    _cameraFollowsTile = true;
+  }
+
+  /**
+   * @return the camera center, in map pixels, as of the last paint
+   */
+  [[nodiscard]] const Vec2D<uint32_t> &CameraCenterPixels() const { return _cameraCenterPixels; }
+
+  /**
+   * Centers the camera on map pixel `center`, for scrolling smoother than a tile at a time
+   */
+  void SetCameraCenterPixels(const Vec2D<uint32_t> &center) {
+    _cameraCenterPixels = center;
+    _cameraFollowsTile = false;
+  }
 
   void Paint(Painter &painterObj) override;
 };
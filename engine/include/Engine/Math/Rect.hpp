@@ -2,6 +2,8 @@
 
 #include "Engine/Math/Vec2D.hpp"
 
+#include <algorithm>
+
 namespace e00 {
 template<typename T>
 struct RectT {
@@ -27,6 +29,10 @@ struct RectT {
   constexpr RectT(T x, T y, T width, T height) noexcept : origin(x, y), size(width, height) {}
   constexpr RectT(const Vec2D<T> &pos, const Vec2D<T> &size) noexcept : origin(pos), size(size) {}
 
+  constexpr RectT &operator=(const RectT &other) noexcept = default;
+
+  constexpr bool operator==(const RectT &rhs) const { return origin == rhs.origin && size == rhs.size; }
+
   constexpr Vec2D<T> From() const { return origin; }
   constexpr Vec2D<T> To() const { return Vec2D<T>(origin.x + size.x, origin.y + size.y); }
 
@@ -65,6 +71,20 @@ struct RectT {
     };
   }
 
+  // Overlapping part of both rectangles; size is 0 if they don't overlap
+  [[nodiscard]] constexpr RectT Intersect(const RectT &r2) const {
+    const auto x0 = origin.x > r2.origin.x ? origin.x : r2.origin.x;
+    const auto y0 = origin.y > r2.origin.y ? origin.y : r2.origin.y;
+    const auto x1 = std::min<long long>(static_cast<long long>(origin.x) + size.x, static_cast<long long>(r2.origin.x) + r2.size.x);
+    const auto y1 = std::min<long long>(static_cast<long long>(origin.y) + size.y, static_cast<long long>(r2.origin.y) + r2.size.y);
+
+    if (x1 <= x0 || y1 <= y0) {
+      return {Vec2D<T>(x0, y0), Vec2D<T>(0, 0)};
+    }
+
+    return {Vec2D<T>(x0, y0), Vec2D<T>(static_cast<T>(x1 - x0), static_cast<T>(y1 - y0))};
+  }
+
   [[nodiscard]] bool isValid() const {
     return size.x > 0 && size.y > 0;
   }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <queue>
+
 namespace e00 {
 namespace detailsp {
   struct Node;
@@ -13,45 +15,162 @@ namespace detailsp {
     constexpr NodeItem() : item{}, point{}, next(nullptr), node(nullptr) {}
   };
 
+  // Squared distance between two points, exact for the whole coordinate range
+  constexpr uint64_t DistanceSquared(const Vec2D<WorldCoordinateType> &a, const Vec2D<WorldCoordinateType> &b) {
+    const int64_t dx = static_cast<int64_t>(a.x) - b.x;
+    const int64_t dy = static_cast<int64_t>(a.y) - b.y;
+    return static_cast<uint64_t>(dx * dx + dy * dy);
+  }
+
+  // Squared distance from `point` to the closest point of `rect`, 0 if inside
+  constexpr uint64_t DistanceSquared(const RectT<WorldCoordinateType> &rect, const Vec2D<WorldCoordinateType> &point) {
+    const auto axis = [](int64_t v, int64_t lo, int64_t hi) -> int64_t {
+      if (v < lo) return lo - v;
+      if (v >= hi) return v - hi + 1;
+      return 0;
+    };
+
+    const int64_t dx = axis(point.x, rect.origin.x, static_cast<int64_t>(rect.origin.x) + rect.size.x);
+    const int64_t dy = axis(point.y, rect.origin.y, static_cast<int64_t>(rect.origin.y) + rect.size.y);
+    return static_cast<uint64_t>(dx * dx + dy * dy);
+  }
+
+  /**
+   * Fixed size object pool: objects live in blocks of BLOCK_SIZE, freed slots are recycled through a free-list and
+   * Reset() forgets everything at once while keeping the blocks for reuse.
+   */
+  template<typename T, std::size_t BLOCK_SIZE = 64>
+  class Pool {
+    static_assert(std::is_trivially_destructible_v<T>, "Reset() doesn't run destructors");
+
+    union Slot {
+      Slot *nextFree;
+      alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> _blocks;
+    Slot *_free = nullptr;
+    size_t _block = 0;// Block new slots come from
+    size_t _used = 0; // Slots of `_block` handed out so far
+
+  public:
+    Pool() = default;
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    template<typename... Args>
+    T *Create(Args &&...args) {
+      Slot *slot = _free;
+      if (slot) {
+        _free = slot->nextFree;
+      } else {
+        if (_block == _blocks.size() || _used == BLOCK_SIZE) {
+          if (_block < _blocks.size()) ++_block;
+          if (_block == _blocks.size()) _blocks.push_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+          _used = 0;
+        }
+        slot = &_blocks[_block][_used++];
+      }
+
+      return std::construct_at(reinterpret_cast<T *>(slot->storage), std::forward<Args>(args)...);
+    }
+
+    void Destroy(T *object) {
+      auto *slot = reinterpret_cast<Slot *>(object);
+      slot->nextFree = _free;
+      _free = slot;
+    }
+
+    void Reset() {
+      _free = nullptr;
+      _block = 0;
+      _used = 0;
+    }
+  };
+
   struct Node {
-    const RectT<WorldCoordinateType> boundaries;
-    const Node *parent;
+    RectT<WorldCoordinateType> boundaries;
+    Node *parent;
 
     NodeItem *itemStart;
+    size_t itemCount;// Items linked to this node, kept up to date so leaves don't walk their list
     std::array<Node *, 4> children;
 
+    using NodePool = Pool<Node>;
+    using ItemPool = Pool<NodeItem>;
+
     Node(Node *parent, const RectT<WorldCoordinateType> &boundaries)
       : boundaries(boundaries),
         parent(parent),
         itemStart(nullptr),
+        itemCount(0),
         children{ nullptr, nullptr, nullptr, nullptr } {}
 
-    ~Node() {
-      for (auto &i : children)
-        delete i;
+    [[nodiscard]] bool IsLeaf() const { return children[0] == nullptr; }
 
-      while (itemStart) {
-        auto *next = itemStart->next;
-        delete itemStart;
-        itemStart = next;
-      }
-    }
+    // Quadrants can't get smaller than a single coordinate
+    [[nodiscard]] bool CanSplit() const { return boundaries.size.x >= 2 && boundaries.size.y >= 2; }
 
-    template<typename... Args>
-    void CreateChildNodes(const Vec2D<WorldCoordinateType> &size, const Args &...args) {
-      children = { new Node(this, { args, size })... };
+    void CreateChildNodes(NodePool &nodes) {
+      // Odd sizes give the extra row / column to the right / bottom quadrants
+      const auto leftWidth = static_cast<WorldCoordinateType>(boundaries.size.x / 2);
+      const auto topHeight = static_cast<WorldCoordinateType>(boundaries.size.y / 2);
+      const auto rightWidth = static_cast<WorldCoordinateType>(boundaries.size.x - leftWidth);
+      const auto bottomHeight = static_cast<WorldCoordinateType>(boundaries.size.y - topHeight);
+      const auto midX = static_cast<WorldCoordinateType>(boundaries.origin.x + leftWidth);
+      const auto midY = static_cast<WorldCoordinateType>(boundaries.origin.y + topHeight);
+
+      children = {
+        nodes.Create(this, RectT<WorldCoordinateType>{ { midX, boundaries.origin.y }, { rightWidth, topHeight } }),
+        nodes.Create(this, RectT<WorldCoordinateType>{ boundaries.origin, { leftWidth, topHeight } }),
+        nodes.Create(this, RectT<WorldCoordinateType>{ { boundaries.origin.x, midY }, { leftWidth, bottomHeight } }),
+        nodes.Create(this, RectT<WorldCoordinateType>{ { midX, midY }, { rightWidth, bottomHeight } }),
+      };
 
       Rebalance();
     }
 
-    NodeItem *CreateItemHere(const Vec2D<WorldCoordinateType> &pos) {
-      auto *item = new NodeItem();
-      item->next = itemStart;
-      item->node = this;
+    // Takes the items of the children back in, then drops them; children must be leaves
+    void MergeChildNodes(NodePool &nodes) {
+      for (auto &child : children) {
+        while (child->itemStart) {
+          auto *item = child->itemStart;
+          child->itemStart = item->next;
+          LinkItem(item);
+        }
+
+        nodes.Destroy(child);
+        child = nullptr;
+      }
+    }
+
+    NodeItem *CreateItemHere(ItemPool &items, const Vec2D<WorldCoordinateType> &pos) {
+      auto *item = items.Create();
       item->point = pos;
+      LinkItem(item);
       return item;
     }
 
+    void LinkItem(NodeItem *item) {
+      item->node = this;
+      item->next = itemStart;
+      itemStart = item;
+      ++itemCount;
+    }
+
+    // Unlinks `item` from this node, returns false if it isn't here
+    bool UnlinkItem(const NodeItem *item) {
+      for (auto **link = &itemStart; *link; link = &(*link)->next) {
+        if (*link == item) {
+          *link = item->next;
+          --itemCount;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
     Node *FindFor(const Vec2D<WorldCoordinateType> &pos) {
       // Not here!
       if (!boundaries.Contains(pos)) return nullptr;
@@ -75,14 +194,7 @@ namespace detailsp {
         return total;
       }
 
-      if (!itemStart) return 0;
-
-      size_t num = 0;
-      for (auto *item = itemStart; item; item = item->next) {
-        num++;
-      }
-
-      return num;
+      return itemCount;
     }
 
     void Rebalance() {
@@ -91,9 +203,8 @@ namespace detailsp {
 
         if (auto n = FindFor(itemStart->point)) {
           if (n != this) {
-            itemStart->node = n;
-            itemStart->next = n->itemStart;
-            n->itemStart = itemStart;
+            n->LinkItem(itemStart);
+            --itemCount;
           }
         }
 
@@ -104,20 +215,48 @@ namespace detailsp {
 
 }// namespace detailsp
 
+/**
+ * Point quadtree: every item is stored at a position, leaves split in four once they hold MAX_ITEMS items
+ * and merge back once their parent holds less than half of that.
+ *
+ * Items are found again by value and position, so `T` must be equality comparable and callers have to
+ * remember where they put things (World does).
+ *
+ * @tparam T the stored value, usually a handle or an index
+ * @tparam MAX_ITEMS items a leaf holds before it splits
+ */
 template<typename T, std::size_t MAX_ITEMS>
 class QuadTree {
+  detailsp::Node::NodePool _nodePool;
+  detailsp::Node::ItemPool _itemPool;
   detailsp::Node _root;
   std::vector<T> _items;
+  std::vector<uint32_t> _freeItems;
+  size_t _count = 0;
+
+  [[nodiscard]] detailsp::NodeItem *FindItem(const T &item, const Vec2D<WorldCoordinateType> &pos) {
+    if (auto *n = _root.FindFor(pos)) {
+      for (auto *nodeItem = n->itemStart; nodeItem; nodeItem = nodeItem->next) {
+        if (nodeItem->point == pos && _items[nodeItem->item] == item) {
+          return nodeItem;
+        }
+      }
+    }
+
+    return nullptr;
+  }
 
-  void Split(detailsp::Node *n) const {
-    // Create children
-    auto quadrantSize = n->boundaries.size / static_cast<WorldCoordinateType>(2);
+  // Merges the parents of `n` that ended up with too few items for their children
+  void Collapse(detailsp::Node *n) {
+    for (auto *parent = n->parent; parent; parent = parent->parent) {
+      for (const auto *child : parent->children) {
+        if (!child->IsLeaf()) return;
+      }
 
-    n->CreateChildNodes(quadrantSize,
-      Vec2D<WorldCoordinateType>(n->boundaries.origin.x + quadrantSize.x, n->boundaries.origin.y),
-      n->boundaries.origin,
-      Vec2D<WorldCoordinateType>(n->boundaries.origin.x, n->boundaries.origin.y + quadrantSize.y),
-      Vec2D<WorldCoordinateType>(n->boundaries.origin + quadrantSize));
+      // Half the split threshold, so a leaf hovering around MAX_ITEMS doesn't split and merge over and over
+      if (parent->CountItems() * 2 >= MAX_ITEMS) return;
+      parent->MergeChildNodes(_nodePool);
+    }
   }
 
 public:
@@ -126,18 +265,79 @@ public:
 
   ~QuadTree() = default;
 
+  QuadTree(const QuadTree &) = delete;
+  QuadTree &operator=(const QuadTree &) = delete;
+
+  [[nodiscard]] const RectT<WorldCoordinateType> &Boundaries() const { return _root.boundaries; }
+  [[nodiscard]] size_t Size() const { return _count; }
+  [[nodiscard]] bool Empty() const { return _count == 0; }
+
+  /**
+   * Drops every item and starts over covering `boundaries`
+   */
+  void Reset(const RectT<WorldCoordinateType> &boundaries) {
+    // Nodes and items are plain data in the pools, dropping them all is just forgetting them
+    _nodePool.Reset();
+    _itemPool.Reset();
+    _root = detailsp::Node(nullptr, boundaries);
+    _items.clear();
+    _freeItems.clear();
+    _count = 0;
+  }
+
+  /**
+   * Adds `item` at `pos`
+   *
+   * @return false if `pos` is outside of the tree
+   */
   bool Insert(T item, const Vec2D<WorldCoordinateType> &pos);
+
+  /**
+   * Removes `item`, which was inserted (or last moved) at `pos`
+   *
+   * @return false if it isn't there
+   */
+  bool Remove(const T &item, const Vec2D<WorldCoordinateType> &pos);
+
+  /**
+   * Moves `item` from `from` to `to`
+   *
+   * @return false if the item isn't at `from` or `to` is outside of the tree; the item is left where it was
+   */
+  bool Move(const T &item, const Vec2D<WorldCoordinateType> &from, const Vec2D<WorldCoordinateType> &to);
+
+  /**
+   * Appends every item positioned inside `area` to `output`
+   *
+   * @return `output`
+   */
+  std::vector<T> &Query(const RectT<WorldCoordinateType> &area, std::vector<T> &output) const;
+
+  /**
+   * Appends the `count` items closest to `point` to `output`, closest first
+   *
+   * @return `output`
+   */
+  std::vector<T> &Nearest(const Vec2D<WorldCoordinateType> &point, size_t count, std::vector<T> &output) const;
 };
 
 template<typename T, std::size_t MAX_ITEMS>
 bool QuadTree<T, MAX_ITEMS>::Insert(T item, const Vec2D<e00::WorldCoordinateType> &pos) {
   if (auto n = _root.FindFor(pos)) {
-    auto *nodeItem = n->CreateItemHere(pos);
-    _items.push_back(item);
-    nodeItem->item = _items.size() - 1;
+    auto *nodeItem = n->CreateItemHere(_itemPool, pos);
+
+    if (_freeItems.empty()) {
+      _items.push_back(std::move(item));
+      nodeItem->item = static_cast<uint32_t>(_items.size() - 1);
+    } else {
+      nodeItem->item = _freeItems.back();
+      _freeItems.pop_back();
+      _items[nodeItem->item] = std::move(item);
+    }
+    ++_count;
 
-    if (n->CountItems() >= MAX_ITEMS) {
-      Split(n);
+    if (n->CountItems() >= MAX_ITEMS && n->CanSplit()) {
+      n->CreateChildNodes(_nodePool);
     }
 
     return true;
@@ -146,4 +346,111 @@ bool QuadTree<T, MAX_ITEMS>::Insert(T item, const Vec2D<e00::WorldCoordinateType
   return false;
 }
 
+template<typename T, std::size_t MAX_ITEMS>
+bool QuadTree<T, MAX_ITEMS>::Remove(const T &item, const Vec2D<WorldCoordinateType> &pos) {
+  auto *nodeItem = FindItem(item, pos);
+  if (!nodeItem) {
+    return false;
+  }
+
+  auto *n = nodeItem->node;
+  n->UnlinkItem(nodeItem);
+  _freeItems.push_back(nodeItem->item);
+  _itemPool.Destroy(nodeItem);
+  --_count;
+
+  Collapse(n);
+  return true;
+}
+
+template<typename T, std::size_t MAX_ITEMS>
+bool QuadTree<T, MAX_ITEMS>::Move(const T &item, const Vec2D<WorldCoordinateType> &from, const Vec2D<WorldCoordinateType> &to) {
+  auto *nodeItem = FindItem(item, from);
+  if (!nodeItem || !_root.boundaries.Contains(to)) {
+    return false;
+  }
+
+  // Still in the same leaf, nothing to re-link
+  if (nodeItem->node->boundaries.Contains(to)) {
+    nodeItem->point = to;
+    return true;
+  }
+
+  T value = _items[nodeItem->item];
+  return Remove(item, from) && Insert(std::move(value), to);
+}
+
+template<typename T, std::size_t MAX_ITEMS>
+std::vector<T> &QuadTree<T, MAX_ITEMS>::Query(const RectT<WorldCoordinateType> &area, std::vector<T> &output) const {
+  if (_count == 0) {
+    return output;
+  }
+
+  // Depth first, skipping the quadrants not touching `area`.
+  // Quadrants stop splitting at 1x1, so at most 17 levels with 3 siblings waiting on each
+  std::array<const detailsp::Node *, 64> pending{};
+  size_t numPending = 0;
+  pending[numPending++] = &_root;
+
+  while (numPending > 0) {
+    const auto *n = pending[--numPending];
+    if (!n->boundaries.Contains(area)) continue;
+
+    if (!n->IsLeaf()) {
+      for (const auto *child : n->children) {
+        pending[numPending++] = child;
+      }
+      continue;
+    }
+
+    for (const auto *nodeItem = n->itemStart; nodeItem; nodeItem = nodeItem->next) {
+      if (area.Contains(nodeItem->point)) {
+        output.push_back(_items[nodeItem->item]);
+      }
+    }
+  }
+
+  return output;
+}
+
+template<typename T, std::size_t MAX_ITEMS>
+std::vector<T> &QuadTree<T, MAX_ITEMS>::Nearest(const Vec2D<WorldCoordinateType> &point, size_t count, std::vector<T> &output) const {
+  // Best first: nodes are queued by the distance to their closest point, items by their own distance.
+  // An item coming out of the queue is closer than anything still in it.
+  struct Entry {
+    uint64_t distance;
+    const detailsp::Node *node;
+    const detailsp::NodeItem *item;
+
+    bool operator>(const Entry &rhs) const { return distance > rhs.distance; }
+  };
+
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+  queue.push({0, &_root, nullptr});
+
+  while (count > 0 && !queue.empty()) {
+    const auto entry = queue.top();
+    queue.pop();
+
+    if (entry.item) {
+      output.push_back(_items[entry.item->item]);
+      --count;
+      continue;
+    }
+
+    if (!entry.node->IsLeaf()) {
+      for (const auto *child : entry.node->children) {
+        queue.push({detailsp::DistanceSquared(child->boundaries, point), child, nullptr});
+      }
+      continue;
+    }
+
+    for (const auto *nodeItem = entry.node->itemStart; nodeItem; nodeItem = nodeItem->next) {
+      queue.push({detailsp::DistanceSquared(nodeItem->point, point), nullptr, nodeItem});
+    }
+  }
+
+  return output;
+}
+
 }// namespace e00
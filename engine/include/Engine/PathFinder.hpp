@@ -0,0 +1,189 @@
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+namespace e00 {
+class Map;
+
+/**
+ * \brief Finds paths between tiles of a Map
+ *
+ * Moves go 8 ways and diagonals don't cut the corners of solid tiles. A step costs more the higher the
+ * `cost` option of the tile it enters is. When no tile has a cost, every step costs the same and the
+ * search jumps along straight lines (jump point search) instead of looking at every tile.
+ *
+ * Requests are queued and worked on by Process(), which stops after a given amount of work so the paths
+ * of many actors get spread over several ticks. Paths are cached until the map changes.
+ */
+class PathFinder {
+public:
+  /**
+   * Handle to a request: a slot in the low 16 bits, the generation of that slot in the high 16
+   */
+  using RequestId = uint32_t;
+  static constexpr RequestId InvalidRequest = std::numeric_limits<RequestId>::max();
+
+  enum class Status : uint8_t {
+    Invalid,// Unknown or released request
+    Pending,// Waiting for Process()
+    Found,  // PathOf() has the path
+    NoPath, // The destination can't be reached
+  };
+
+  struct Query {
+    Position from;
+    Position to;
+  };
+
+private:
+  // Step costs, diagonals are about sqrt(2) times longer
+  static constexpr uint32_t StraightCost = 10;
+  static constexpr uint32_t DiagonalCost = 14;
+
+  // Cell costs; solid tiles can't be entered
+  static constexpr uint8_t Blocked = std::numeric_limits<uint8_t>::max();
+
+  static constexpr uint32_t NoCell = std::numeric_limits<uint32_t>::max();
+
+  // Cached paths before the cache is emptied
+  static constexpr size_t CacheCapacity = 256;
+
+  const Map *_map{};
+
+  // Snapshot of the map's passability, rebuilt when the map's revision changes
+  bool _gridValid{};
+  uint32_t _mapRevision{};
+  int32_t _width{};
+  int32_t _height{};
+  std::vector<uint8_t> _cells;
+  bool _uniformCost{};
+
+  // Search buffers, shared by every search; the stamps avoid clearing them between searches
+  struct OpenEntry {
+    uint32_t f;
+    uint32_t g;
+    uint32_t cell;
+  };
+  std::vector<OpenEntry> _open;
+  std::vector<uint32_t> _g;
+  std::vector<uint32_t> _parent;
+  std::vector<uint32_t> _seen;
+  std::vector<uint32_t> _closed;
+  uint32_t _stamp{};
+  uint32_t _goal{NoCell};
+  size_t _work{};
+
+  struct RequestState {
+    Query query;
+    Status status{Status::Invalid};
+    uint16_t generation{};
+    std::vector<Position> path;
+  };
+  std::vector<RequestState> _requests;
+  std::vector<uint16_t> _freeRequests;
+  std::deque<RequestId> _pending;
+  RequestId _active{InvalidRequest};
+
+  // Finished searches by (from cell, to cell); an empty path is a search that found nothing
+  std::unordered_map<uint64_t, std::vector<Position>> _cache;
+
+  enum class SearchResult : uint8_t {
+    Running,
+    Found,
+    NoPath,
+  };
+
+  static constexpr uint16_t SlotOf(RequestId id) { return static_cast<uint16_t>(id & 0xFFFF); }
+  static constexpr uint16_t GenerationOf(RequestId id) { return static_cast<uint16_t>(id >> 16); }
+
+  [[nodiscard]] RequestState *Find(RequestId id);
+  [[nodiscard]] const RequestState *Find(RequestId id) const;
+
+  [[nodiscard]] uint32_t CellOf(int32_t x, int32_t y) const { return static_cast<uint32_t>(y * _width + x); }
+  [[nodiscard]] int32_t XOf(uint32_t cell) const { return static_cast<int32_t>(cell % static_cast<uint32_t>(_width)); }
+  [[nodiscard]] int32_t YOf(uint32_t cell) const { return static_cast<int32_t>(cell / static_cast<uint32_t>(_width)); }
+  [[nodiscard]] bool Walkable(int32_t x, int32_t y) const {
+    return x >= 0 && y >= 0 && x < _width && y < _height && _cells[CellOf(x, y)] != Blocked;
+  }
+  [[nodiscard]] bool InMap(const Position &position) const { return position.x < _width && position.y < _height; }
+  [[nodiscard]] uint64_t CacheKey(const Query &query) const {
+    return (uint64_t{CellOf(query.from.x, query.from.y)} << 32) | CellOf(query.to.x, query.to.y);
+  }
+
+  void Refresh();
+  void Remember(const Query &query, const std::vector<Position> &path);
+  void Complete(RequestState &request, SearchResult result);
+  bool FromCache(RequestState &request);
+
+  void BeginSearch(const Query &query);
+  SearchResult RunSearch(size_t budget);
+  void Expand(uint32_t cell);
+  void Reach(uint32_t cell, uint32_t from, uint32_t g);
+  [[nodiscard]] uint32_t Heuristic(uint32_t cell) const;
+  [[nodiscard]] uint32_t Jump(int32_t x, int32_t y, int32_t dx, int32_t dy);
+  void BuildPath(std::vector<Position> &path) const;
+
+public:
+  PathFinder() = default;
+  explicit PathFinder(const Map *map) : _map(map) {}
+  NOT_COPYABLE(PathFinder);
+
+  /**
+   * Changes the map to search, every request still pending is answered on the new one
+   */
+  void SetMap(const Map *map);
+
+  /**
+   * Queues a path request. Answered right away when the path is cached or either end is unusable.
+   *
+   * @param from the starting tile
+   * @param to the destination tile
+   * @return the request, see StatusOf()
+   */
+  RequestId Request(const Position &from, const Position &to);
+
+  /**
+   * Queues one request per query, so a group of actors gets its paths from the same Process() calls
+   *
+   * @param queries the paths to find
+   * @param ids the request of every query is appended to it, in order
+   */
+  void Request(std::span<const Query> queries, std::vector<RequestId> &ids);
+
+  /**
+   * Works on pending requests, in the order they were made, until `budget` tiles were looked at.
+   * A search that doesn't finish carries on at the next call. The tile being expanded when the budget
+   * runs out is finished first, so a little more than `budget` can be looked at.
+   *
+   * @param budget how many tiles the searches may look at
+   * @return how many tiles were looked at
+   */
+  size_t Process(size_t budget);
+
+  [[nodiscard]] Status StatusOf(RequestId id) const;
+
+  /**
+   * @return every tile from the start to the destination, both included; empty unless the request is Found
+   */
+  [[nodiscard]] std::span<const Position> PathOf(RequestId id) const;
+
+  /**
+   * Forgets a request, cancelling it if it's still pending
+   */
+  void Release(RequestId id);
+
+  [[nodiscard]] size_t PendingRequests() const { return _pending.size() + (_active != InvalidRequest ? 1 : 0); }
+
+  /**
+   * Finds a path right away, whatever the budget; a search in progress starts over at the next Process()
+   *
+   * @param from the starting tile
+   * @param to the destination tile
+   * @param path receives every tile of the path, both ends included
+   * @return true if there is a path
+   */
+  bool FindPath(const Position &from, const Position &to, std::vector<Position> &path);
+};
+}// namespace e00
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Layout of a resource archive: every resource of a game packed into one file, so it is opened once
+ * instead of once per resource.
+ *
+ *   Header
+ *   IndexEntry[entry_count], sorted by id
+ *   the data of every entry
+ *
+ * Entries are keyed by the HashName() of the file name and of every alias of it in the `resourcemap`
+ * section of game.ini; aliases point at the same data. Everything is little endian.
+ */
+namespace e00::archive {
+constexpr std::string_view DefaultName = "resources.pak";
+
+constexpr std::uint32_t Magic = 0x4B503045;// "E0PK"
+constexpr std::uint32_t Version = 1;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t entry_count;
+  std::uint32_t reserved;
+};
+
+struct IndexEntry {
+  std::uint32_t id;    // << ResourceId
+  std::uint32_t offset;// << From the start of the archive
+  std::uint32_t size;
+};
+
+static_assert(sizeof(Header) == 16, "Header is read and written as is");
+static_assert(sizeof(IndexEntry) == 12, "IndexEntry is read and written as is");
+}// namespace e00::archive
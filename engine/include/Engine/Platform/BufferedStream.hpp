@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Stream.hpp"
+
+#include <memory>
+#include <string>
+
+namespace e00 {
+/**
+ * Reads another stream a block at a time, so small reads (a byte, a line) don't each reach the
+ * stream underneath. Peek() looks at up to a block without copying, reads of a block or more
+ * skip the buffer.
+ */
+class BufferedStream : public Stream {
+  std::unique_ptr<Stream> _stream;
+  std::vector<uint8_t> _buffer;
+  size_t _buffer_position{0};// Position in the stream of the first byte of the buffer
+  size_t _buffered{0};       // Bytes of the buffer holding data
+
+  [[nodiscard]] bool InBuffer(size_t size) const {
+    return _current_position >= _buffer_position && _current_position + size <= _buffer_position + _buffered;
+  }
+
+  /**
+   * Fills the buffer with the block starting at `position`, or what is left of the stream
+   */
+  std::error_code Fill(size_t position);
+
+protected:
+  std::error_code real_read(size_t size, void *data) override;
+
+  // The stream underneath only seeks when the buffer is filled
+  std::error_code real_seek(size_t) override { return {}; }
+
+  [[nodiscard]] std::span<const uint8_t> real_map() const override { return _stream->Map(); }
+
+  [[nodiscard]] std::span<const uint8_t> real_peek(size_t size) override;
+
+public:
+  using Stream::Read;
+
+  /**
+   * @param stream the stream to read, never nullptr
+   * @param blockSize how many bytes to read ahead at a time
+   */
+  explicit BufferedStream(std::unique_ptr<Stream> &&stream, size_t blockSize = detail::StreamBlockSize);
+
+  [[nodiscard]] size_t BlockSize() const { return _buffer.size(); }
+
+  /**
+   * Reads one byte, straight from the buffer unless it has to be filled
+   *
+   * @param out the byte read
+   * @return any errors
+   */
+  std::error_code ReadByte(uint8_t &out) {
+    if (InBuffer(1)) {
+      out = _buffer[_current_position - _buffer_position];
+      ++_current_position;
+      return {};
+    }
+    return Read(out);
+  }
+
+  /**
+   * Reads up to the next `delimiter`, or to the end of the stream. The delimiter is consumed but not stored.
+   *
+   * @param delimiter the character to stop at
+   * @param out receives what was read, replacing its contents
+   * @return io_error if the stream was already at its end, any read errors
+   */
+  std::error_code ReadUntil(char delimiter, std::string &out);
+};
+}// namespace e00
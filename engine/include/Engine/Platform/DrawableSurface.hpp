@@ -104,6 +104,23 @@ public:
    */
   [[nodiscard]] virtual bool SupportsOptimizedCopyFrom(const DrawableSurface &source) const { return false; }
 
+  /**
+   * Describes how this surface stores its pixels, as returned by GetNativeLine()
+   * 
+   * @return the native format; palette, shift and mask are filled in for the depths that use them
+   */
+  [[nodiscard]] virtual TargetInformation GetNativeFormat() const { return {GetBitDepth(), nullptr, {}, {}}; }
+
+  /**
+   * Direct read-only access to a line of pixels in the native format of this surface.
+   * Surfaces that don't live in system memory (VRAM, locked GPU buffers, ...) return an empty
+   * span and must be read through ReadLineInto().
+   * 
+   * @param y the line to access
+   * @return the line data or an empty span
+   */
+  [[nodiscard]] virtual std::span<const uint8_t> GetNativeLine(BitmapSizeType /*y*/) const { return {}; }
+
   /**
    * Acquires the active rendering brush engine for this surface.
    * The returned Painter manages hardware registers, banking, or modern context streams.
@@ -131,6 +148,23 @@ public:
       BitmapSizeType startX, BitmapSizeType endX,
       const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer) const = 0;
 
+  /**
+   * Reads several lines in one go, as ReadLineInto() would one at a time. Surfaces converting
+   * their pixels set the conversion up once for all the lines instead of once per line.
+   * 
+   * @param firstLine the first line to read
+   * @param lineCount how many lines to read
+   * @param startX the start X
+   * @param endX the end X
+   * @param targetInformation the destination format information
+   * @param targetBuffer where to write the data, one line every `targetStride` bytes
+   * @param targetStride the distance between the start of two lines in `targetBuffer`
+   */
+  virtual void ReadLinesInto(
+      BitmapSizeType firstLine, BitmapSizeType lineCount,
+      BitmapSizeType startX, BitmapSizeType endX,
+      const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer, size_t targetStride) const;
+
 
   // For debugging
   std::error_code SaveToBMP(WritableStream &writableStream) const;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Layout of a compiled map, made by the map compiler out of a world ini and its comma separated tile set.
+ * The text files stay what maps are written in, compiled maps are what the engine loads fastest.
+ *
+ *   Header
+ *   LayerHeader, then `size` bytes of tile ids, for each of the `layer_count` layers
+ *
+ * Raw layers are the Width() * Height() tile ids, row by row, `tile_id_size` bytes each. Run length
+ * layers are runs of a count byte (1 to 255) followed by the tile id repeated that many times.
+ * Everything is little endian.
+ *
+ * To load a compiled map, point the `resourcemap` alias of the map at the compiled file.
+ */
+namespace e00::mapfile {
+constexpr std::string_view Extension = ".e0m";
+
+constexpr std::uint32_t Magic = 0x504D3045;// "E0MP"
+constexpr std::uint32_t Version = 1;
+
+enum class Encoding : std::uint8_t {
+  Raw = 0,
+  RunLength = 1,
+};
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint16_t width;
+  std::uint16_t height;
+  std::uint32_t tileset;     // << ResourceId of the tileset description, 0 for none
+  std::uint8_t tile_id_size; // << 1 when every tile id fits in a byte, 2 otherwise
+  std::uint8_t layer_count;  // << Only the first layer is loaded for now
+  std::uint16_t reserved;
+};
+
+struct LayerHeader {
+  std::uint8_t encoding;// << Encoding
+  std::uint8_t reserved[3];
+  std::uint32_t size;// << Bytes of tile ids that follow
+};
+
+static_assert(sizeof(Header) == 20, "Header is read and written as is");
+static_assert(sizeof(LayerHeader) == 8, "LayerHeader is read and written as is");
+}// namespace e00::mapfile
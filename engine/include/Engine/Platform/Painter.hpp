@@ -4,11 +4,11 @@
 #include "Engine/Math/Vec2D.hpp"
 #include "Engine/Math/Rect.hpp"
 #include "Engine/Math/Color.hpp"
+#include "Engine/Platform/DrawableSurface.hpp"
 #include <span>
+#include <vector>
 
 namespace e00 {
-class DrawableSurface;
-
 /**
  * Painter provides highly optimized functions to do most of the drawing programs require. It can draw everything from
  * simple lines to bitmaps.
@@ -17,6 +17,13 @@ class DrawableSurface;
  * optimal performance
  */
 class Painter {
+public:
+  // One block of a batched DrawSurfaces() call
+  struct SurfaceBlit {
+    RectT<BitmapSizeType> srcRect;
+    Vec2D<BitmapSizeType> dstPos;
+  };
+
 protected:
   // Outline
   enum class PenStyle {
@@ -41,6 +48,10 @@ protected:
   uint8_t _penIndex = 0;
   Color _penColor;
 
+  // Nothing is drawn outside of this rectangle; the intersection of every pushed clip
+  RectT<BitmapSizeType> _clipRect = RectT<BitmapSizeType>::maxArea();
+  std::vector<RectT<BitmapSizeType>> _clipStack;
+
 public:
   virtual ~Painter() = default;// Acts as "EndPaint()", restoring hardware modes automatically
 
@@ -69,6 +80,36 @@ public:
     _brushStyle = BrushStyle::SolidBrushIndex;
   }
 
+  /**
+   * Restricts drawing to a rectangle of the target, in target coordinates, until the matching PopClip()
+   *
+   * Clips nest: the new clip is intersected with the current one, so it can only shrink.
+   */
+  void PushClip(const RectT<BitmapSizeType> &rect) {
+    _clipStack.push_back(_clipRect);
+    _clipRect = _clipRect.Intersect(rect);
+  }
+
+  /**
+   * Restores the clip that was active before the last PushClip(); does nothing if there is none
+   */
+  void PopClip() {
+    if (!_clipStack.empty()) {
+      _clipRect = _clipStack.back();
+      _clipStack.pop_back();
+    }
+  }
+
+  [[nodiscard]] const RectT<BitmapSizeType> &ClipRect() const { return _clipRect; }
+  [[nodiscard]] bool IsFullyClipped() const { return !_clipRect.isValid(); }
+
+  /**
+   * Pixel format of the surface being painted on, so sources drawn often can be converted to it once beforehand
+   *
+   * @return the target's format, DEPTH_INVALID if this painter can't tell
+   */
+  [[nodiscard]] virtual DrawableSurface::TargetInformation TargetFormat() const { return {DrawableSurface::BitDepth::DEPTH_INVALID, nullptr, {}, {}}; }
+
   // DrawPoint and DrawPoints should only be used for small numbers of points or debugging
   // Color of the points are determined by the current pen settings
   virtual void DrawPoint(const Vec2D<BitmapSizeType> &pos) = 0;
@@ -90,5 +131,14 @@ public:
   virtual void DrawSurface(const DrawableSurface &src,
                            RectT<BitmapSizeType> srcRect,
                            Vec2D<BitmapSizeType> dstPos);
+
+  /**
+   * Draws many blocks of the same source in one call, as if DrawSurface() was called for every one of them in order.
+   * Format conversion is worked out once for the whole batch, which makes this the call for tile maps.
+   *
+   * @param src the surface all blocks come from
+   * @param blits the blocks to draw
+   */
+  virtual void DrawSurfaces(const DrawableSurface &src, std::span<const SurfaceBlit> blits);
 };
 }// namespace e00
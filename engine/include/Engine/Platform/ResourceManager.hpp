@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <expected>
 #include <list>
 #include <memory>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 
 #include <Engine/Logging/SourceLocation.hpp>
 #include <Engine/Platform/ResourceLoaderOptions.hpp>
@@ -29,6 +32,22 @@ class ResourceLoader;
  * to optimize memory usage
  */
 class ResourceManager {
+public:
+  // Named resources are known by id and type
+  struct ResourceKey {
+    ResourceId id;
+    type_t type;
+
+    bool operator==(const ResourceKey &) const = default;
+  };
+
+private:
+  struct ResourceKeyHash {
+    size_t operator()(const ResourceKey &key) const noexcept {
+      return std::hash<uint64_t>{}(static_cast<uint64_t>(key.type) ^ (static_cast<uint64_t>(key.id) * 0x9E3779B97F4A7C15ULL));
+    }
+  };
+
   struct AliasEntry {
     ResourceId id;
     std::string filename;
@@ -37,12 +56,44 @@ class ResourceManager {
     bool operator<(const AliasEntry &other) const { return id < other.id; }
   };
 
+  using ControlBlocks = std::unordered_map<const detail::ControlBlock *, std::unique_ptr<detail::ControlBlock>>;
+  using ControlBlockIndex = std::unordered_map<ResourceKey, detail::ControlBlock *, ResourceKeyHash>;
+  using DependencyIndex = std::unordered_map<ResourceKey, std::vector<ResourceKey>, ResourceKeyHash>;
+
   // Where to open the streams from, defaults to the global stream factory
   StreamFactory &_stream_factory;
 
-  std::vector<AliasEntry> _aliases;
-  std::vector<std::unique_ptr<detail::ControlBlock>> _loaded_resources_cb;// << A lightweight control block tracking system
-  std::list<std::unique_ptr<ResourceLoader>> _loaders;                    // << all the known loaders
+  std::vector<AliasEntry> _aliases;                   // << Sorted by id
+  ControlBlocks _loaded_resources_cb;                 // << Every control block, owned here until erased
+  ControlBlockIndex _known_resources;                 // << Control blocks of named resources (id != 0)
+  DependencyIndex _dependencies;                      // << What loading a resource loaded along with it
+  std::list<std::unique_ptr<ResourceLoader>> _loaders;// << all the known loaders
+
+  std::atomic<size_t> _memory_budget{};                   // << 0: no limit
+  std::atomic<size_t> _memory_in_use{};                   // << Kept up to date as resources are loaded and unloaded
+  bool _drop_unreferenced{};                              // << The budget went back to 0, Tick() drops what it kept
+  std::vector<detail::ControlBlock *> _unload_candidates;// << Tick() buffer
+
+  // Background loads in the order they were asked for; the first `_async_in_flight` are started
+  class AsyncControlBlock;
+  struct AsyncLoad;
+  std::deque<std::shared_ptr<AsyncLoad>> _async_loads;
+  size_t _async_in_flight{};
+
+  // Ticks a started load waits for a worker before Tick() loads it itself
+  static constexpr uint32_t AsyncClaimTicks = 2;
+
+  // Guards the control block and dependency maps, background loads add the resources they depend on
+  mutable std::atomic_flag _cb_lock;
+  bool _tearing_down{};// << Set by the destructor, control blocks are no longer erased one by one
+
+  /**
+   * Takes ownership of `cb` and indexes it
+   *
+   * @param cb the control block to add
+   * @return `cb`
+   */
+  detail::ControlBlock *AddControlBlock(std::unique_ptr<detail::ControlBlock> &&cb);
 
   /**
    * Finds a control block for a given resource id and type
@@ -90,8 +141,14 @@ class ResourceManager {
       type_t resource_type,
       std::span<LoadOption *const> options);
 
+  // LoadResource() without the dependency bookkeeping
+  std::expected<std::unique_ptr<Resource>, std::error_code> LoadResourceFromStream(
+      ResourceId resource_id,
+      type_t resource_type,
+      std::span<LoadOption *const> options);
+
   /**
-   * Delete the control block `cb`.
+   * Delete the control block `cb`, once nothing references it and it can't be loaded again.
    * After this call `cb` is no longer valid.
    * 
    * @param cb The control block to erase
@@ -99,6 +156,37 @@ class ResourceManager {
    */
   bool EraseControlBlock(detail::ControlBlock *cb);
 
+  /**
+   * Queues a background load of `id`, the returned control block is loaded by a later Tick()
+   *
+   * @param id the resource id
+   * @param type the type of the resource
+   * @param options the options to load it with, kept for as long as the control block
+   * @return the control block that receives the resource
+   */
+  detail::ControlBlock *QueueAsyncLoad(ResourceId id, type_t type, std::vector<std::unique_ptr<LoadOption>> &&options);
+
+  // Hands queued loads to worker threads, up to detail::BackgroundLoadsInFlight at a time
+  void StartAsyncLoads();
+
+  // Loads `load`, once claimed; runs on the worker or, failing that, in Tick()
+  void RunAsyncLoad(AsyncLoad &load);
+
+  // Delivers finished loads to their control blocks; with `wait`, until there are none left
+  void CompleteAsyncLoads(bool wait);
+
+  // Notes that `key` was needed by the load in progress on this thread, if any
+  static void NoteDependency(const ResourceKey &key);
+
+  // Counts the resource `cb` just loaded in MemoryInUse()
+  void ResourceLoaded(detail::ControlBlock &cb) noexcept;
+
+  // Stops counting the resource of `cb`, about to be deleted
+  void ResourceUnloaded(detail::ControlBlock &cb) noexcept;
+
+  // Whether reloadable resources stay loaded once nothing references them, for Tick() to drop when it needs room
+  [[nodiscard]] bool KeepsUnreferencedResources() const { return _memory_budget.load(std::memory_order_relaxed) != 0; }
+
   ResourceManager();
 
   template<typename T, typename... Options>
@@ -114,7 +202,7 @@ class ResourceManager {
     }
 
     class StaticOptionControlBlock : public detail::ControlBlock {
-      const ResourceManager *const _owner;
+      ResourceManager *const _owner;
       const source_location _from;
       const std::array<LoadOption *, sizeof...(Options)> _opts;
 
@@ -127,19 +215,26 @@ class ResourceManager {
 
       ~StaticOptionControlBlock() override {
         for (auto *p: _opts) delete p;
-        _owner->EraseControlBlock(this);
+        delete _resource;
       }
 
     protected:
       void OnZeroShared() noexcept override {
+        if (_owner->KeepsUnreferencedResources()) {
+          return;
+        }
+
         GetDefaultLogger().Info(
             source_location::current(),
             "Resource {} of type {} from {}:{} destroyed", id(), type(), _from.file_name(), _from.line());
+        _owner->ResourceUnloaded(*this);
         delete _resource;
         _resource = nullptr;
       }
 
     public:
+      [[nodiscard]] bool IsReloadable() const override { return true; }
+
       std::error_code OnLoadLazyResource() override {
         if (auto resource = _owner->LoadResource(
                 id(),
@@ -147,6 +242,7 @@ class ResourceManager {
                 std::span<LoadOption *const>(_opts));
             resource) {
           _resource = resource.value().release();
+          _owner->ResourceLoaded(*this);
           return {};
         }
         return std::make_error_code(std::errc::no_such_file_or_directory);
@@ -154,18 +250,17 @@ class ResourceManager {
     };
 
     // We know a loader exists for this type and the stream exists, assume it's fine
-    auto const &ret = _loaded_resources_cb.emplace_back(
+    return ResourcePtrT<T>(AddControlBlock(
         std::make_unique<StaticOptionControlBlock>(
-            this, type_id<T>(), id, from,
-            std::forward<Options>(options)...));
-    return ResourcePtrT<T>(ret.get());
+            this, id, from,
+            std::forward<Options>(options)...)));
   }
 
 public:
   static ResourceManager &GlobalResourceManager();
   static ResourceLoader &InvalidLoader();
 
-  ~ResourceManager() = default;
+  ~ResourceManager();
 
   /**
    * Adds a loader to the system to manage loading operations.
@@ -224,6 +319,20 @@ public:
     return ResourcePtrT<T>(MakeMemoryContainer(0, type_id<T>(), std::move(ptr), from));
   }
 
+  /**
+   * Creates a resource in memory under the name `id`, later lookups of `id` find it.
+   * Like TakeOwnership(), it can't be lazily reloaded.
+   *
+   * @tparam T The resource type
+   * @param id the resource id
+   * @param args Values to pass to the constructor of T
+   * @return the new resource
+   */
+  template<typename T, typename... Args>
+  ResourcePtrT<T> Make(ResourceId id, Args &&...args) {
+    return ResourcePtrT<T>(MakeMemoryContainer(id, type_id<T>(), std::make_unique<T>(std::forward<Args>(args)...), source_location::current()));
+  }
+
   template<typename T>
   ResourcePtrT<T> LazyResource(ResourceId id, const source_location &from = source_location::current()) {
     return InternalLazyResource<T>(id, from);
@@ -276,6 +385,93 @@ public:
     return nullptr;
   }
 
+  /**
+   * Loads a resource on a background thread. The returned pointer is usable right away but isn't loaded
+   * until a later Tick() delivers the resource, on the calling thread. Until then EnsureLoad() returns
+   * std::errc::resource_unavailable_try_again; if the load fails, it returns why.
+   * Loads start in the order they were asked for, detail::BackgroundLoadsInFlight at a time. Where no
+   * thread can be started a load happens inside Tick() instead, a few ticks later; on platforms without
+   * threads (detail::BackgroundLoadThreads), one load per Tick().
+   *
+   * @tparam T The resource type
+   * @param id the resource id
+   * @param options Load options, copied
+   * @return the resource, loaded once IsLoaded() says so
+   */
+  template<typename T, typename... Options>
+  ResourcePtrT<T> LoadResourceAsync(ResourceId id, Options &&...options) {
+    static_assert((std::derived_from<std::decay_t<Options>, LoadOption> && ...),
+                  "All Options must derive from LoadOption");
+
+    // Known already, loaded or on its way
+    if (auto *cb = FindKnownControlBlockFor(id, type_id<T>())) {
+      return ResourcePtrT<T>(cb);
+    }
+
+    std::vector<std::unique_ptr<LoadOption>> opts;
+    opts.reserve(sizeof...(Options));
+    (opts.push_back(std::make_unique<std::decay_t<Options>>(std::forward<Options>(options))), ...);
+    return ResourcePtrT<T>(QueueAsyncLoad(id, type_id<T>(), std::move(opts)));
+  }
+
+  /**
+   * Loads a resource of any type in the background, see LoadResourceAsync()
+   *
+   * @param key the resource id and type
+   * @return the resource, loaded once IsLoaded() says so
+   */
+  ResourcePtrT<Resource> Prefetch(const ResourceKey &key) {
+    if (auto *cb = FindKnownControlBlockFor(key.id, key.type)) {
+      return ResourcePtrT<Resource>(cb);
+    }
+    return ResourcePtrT<Resource>(QueueAsyncLoad(key.id, key.type, {}));
+  }
+
+  /**
+   * @return loads queued by LoadResourceAsync() that weren't delivered yet
+   */
+  [[nodiscard]] size_t PendingAsyncLoads() const { return _async_loads.size(); }
+
+  /**
+   * Blocks until every background load is delivered, loading the ones no worker started on this thread
+   */
+  void WaitForAsyncLoads() { CompleteAsyncLoads(true); }
+
+  /**
+   * Declares the resources loading `key` needs, so they can be prefetched before it. Loading a resource
+   * records them too: every resource its loader loads or looks up, and what those need in turn.
+   *
+   * @param key the resource
+   * @param dependencies what it needs, replaces what was known
+   */
+  void SetDependencies(const ResourceKey &key, std::vector<ResourceKey> dependencies);
+
+  /**
+   * @return the resources loading `key` needs, as declared or as seen the last time it was loaded
+   */
+  [[nodiscard]] std::vector<ResourceKey> DependenciesOf(const ResourceKey &key) const;
+
+  /**
+   * Sets how many bytes of loaded resources Tick() tolerates before unloading some. With a budget, resources that
+   * can be loaded again (LazyResource(), LoadResourceAsync()) stay loaded after the last ResourcePtr to them goes
+   * away, so looking them up again is free. Tick() unloads those when over budget, least recently used first, and
+   * never one used during the last tick. A resource something still references is never unloaded.
+   * Changes made to a resource nothing references anymore may be lost: it comes back from its file.
+   *
+   * @param bytes the budget, 0 for no limit (the default): unreferenced resources are unloaded right away
+   */
+  void SetMemoryBudget(size_t bytes) {
+    if (_memory_budget.exchange(bytes, std::memory_order_relaxed) != 0 && bytes == 0) {
+      _drop_unreferenced = true;
+    }
+  }
+  [[nodiscard]] size_t MemoryBudget() const { return _memory_budget.load(std::memory_order_relaxed); }
+
+  /**
+   * @return bytes held by loaded resources, each counted as what it took when it was loaded
+   */
+  [[nodiscard]] size_t MemoryInUse() const { return _memory_in_use.load(std::memory_order_relaxed); }
+
   void Tick(std::chrono::milliseconds delta);
 };
 }// namespace e00
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
+#include <span>
 #include <vector>
 
 namespace e00 {
@@ -23,6 +25,25 @@ protected:
 
   virtual std::error_code real_seek(size_t position) = 0;
 
+  /**
+   * Streams whose whole data sits in memory (a mapped file, a slice of one) return it here
+   *
+   * @return every byte of the stream, or an empty span if it isn't in memory
+   */
+  [[nodiscard]] virtual std::span<const uint8_t> real_map() const { return {}; }
+
+  /**
+   * The next `size` bytes without copying, see Peek(). Streams in memory have them, buffered streams
+   * override this to look in their buffer.
+   */
+  [[nodiscard]] virtual std::span<const uint8_t> real_peek(size_t size) {
+    const auto data = real_map();
+    if (size > AvailableToRead() || data.size() != _stream_size) {
+      return {};
+    }
+    return data.subspan(_current_position, size);
+  }
+
 public:
   Stream(Stream &&other) noexcept = delete;
 
@@ -84,6 +105,22 @@ public:
     return std::make_error_code(std::errc::value_too_large);
   }
 
+  /**
+   * Every byte of the stream, straight from memory, without copying
+   *
+   * @return the data, or an empty span if the stream isn't in memory
+   */
+  [[nodiscard]] std::span<const uint8_t> Map() const { return real_map(); }
+
+  /**
+   * The next `size` bytes, straight from memory, without copying nor moving the position.
+   * Use SeekTo() to consume them. The bytes stay valid until the next read or seek.
+   *
+   * @param size how many bytes to look at
+   * @return the bytes, or an empty span if the stream doesn't have them in memory or has fewer left
+   */
+  [[nodiscard]] std::span<const uint8_t> Peek(size_t size) { return real_peek(size); }
+
   /**
    * Reads data from the stream.
    * 
@@ -142,6 +179,18 @@ public:
       return nullptr;
     }
 
+    // Look for the end of the line without reading past it, when the stream allows
+    if (const auto data = Peek(read_max); data.size() == read_max) {
+      const auto *line = reinterpret_cast<const char *>(data.data());
+      const auto *e = static_cast<const char *>(memchr(line, '\n', read_max));
+      const size_t length = e != nullptr ? static_cast<size_t>(e - line) : read_max;
+      std::memcpy(str, line, length);
+      str[length] = 0;
+
+      (void) SeekTo(Position() + length + (e != nullptr ? 1 : 0));
+      return str;
+    }
+
     // Read as much as possible
     if (Read(read_max, str)) {
       return nullptr;
@@ -15,6 +15,31 @@ public:
 
   virtual std::unique_ptr<Stream> OpenStream(const std::string &name) = 0;
 
+  /**
+   * Opens a resource by id, without going through a file name. Only resources in a mounted archive
+   * can be opened this way.
+   *
+   * @param id the resource id
+   * @return the resource's data, nullptr if no mounted archive has it
+   */
+  virtual std::unique_ptr<Stream> OpenResourceStream(ResourceId /*id*/) { return nullptr; }
+
+  /**
+   * Mounts a resource archive from the resource directory, see ArchiveFormat.hpp. Streams are then
+   * opened from the archive first, from their own file if it doesn't have them.
+   *
+   * @param name the archive's file name
+   * @return any errors, the previous archive stays mounted if there are
+   */
+  virtual std::error_code MountArchive(const std::string &/*name*/) { return std::make_error_code(std::errc::not_supported); }
+
+  /**
+   * Streams that aren't in memory are read through a BufferedStream, a block at a time
+   *
+   * @param blockSize bytes to read ahead at a time, 0 to read streams directly
+   */
+  virtual void SetStreamBlockSize(size_t /*blockSize*/) {}
+
   virtual std::unique_ptr<WritableStream> OpenStreamForWrite(const std::string &name) = 0;
 
   virtual void SetResourceDirectory(const std::string &path) = 0;
@@ -27,6 +27,12 @@ struct Resource {
 
   [[nodiscard]] virtual type_t Type() const = 0;
 
+  /**
+   * Roughly how many bytes this resource holds, what the resource manager's memory budget counts.
+   * 0 if it's too small to matter or unknown.
+   */
+  [[nodiscard]] virtual size_t MemoryUsage() const { return 0; }
+
   template<typename T>
   [[nodiscard]] bool Is() const { return Type() == type_id<T>(); }
 
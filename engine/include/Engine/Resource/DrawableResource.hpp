@@ -23,5 +23,15 @@ public:
   }
   [[nodiscard]] Vec2D<BitmapSizeType> Size() const override { return _size; }
   [[nodiscard]] BitDepth GetBitDepth() const override { return _bit_depth; }
+
+  [[nodiscard]] size_t MemoryUsage() const override {
+    const size_t pixels = static_cast<size_t>(_size.x) * _size.y;
+    switch (_bit_depth) {
+      case BitDepth::DEPTH_1: return (pixels + 7) / 8;
+      case BitDepth::DEPTH_16: return pixels * 2;
+      case BitDepth::DEPTH_32: return pixels * 4;
+      default: return pixels;
+    }
+  }
 };
 }// namespace e00
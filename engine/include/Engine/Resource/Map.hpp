@@ -10,12 +10,32 @@ class Painter;
  * Raw map data
  */
 class Map : public Resource {
-  struct TileOptions {};
+public:
+  /**
+   * Gameplay properties of a tile, read from the `[tile:N]` sections of the tileset
+   */
+  struct TileOptions {
+    uint8_t solid : 1 {};  // Blocks movement
+    uint8_t trigger : 1 {};// Stepping on it means something
+    uint8_t cost : 4 {};   // Extra cost of walking through it
 
+    bool operator==(const TileOptions &) const = default;
+  };
+
+private:
   Vec2D<WorldCoordinateType> _map_size;
   std::vector<TileIdType> _map_tile;
+
+  // Options of the tile at every position, kept next to the tile ids
   std::vector<TileOptions> _options;
 
+  // Options of every tile id, what _options is filled from
+  std::vector<TileOptions> _tile_options;
+
+  // One bit per position set when the tile is solid; each row starts on a new word
+  std::vector<uint64_t> _solid;
+  size_t _solid_words_per_row{};
+
   Vec2D<uint16_t> _tileset_size;
   ResourcePtrT<DrawableResource> _tileset{};
   uint16_t _margin{};
@@ -23,6 +43,38 @@ class Map : public Resource {
 
   uint16_t _tiles_per_row{};
 
+  // Source rect in the tileset of every tile id; slot 0 (no tile) is left empty so ids index it directly
+  std::vector<RectT<BitmapSizeType>> _tile_rects;
+
+  // Bumped by every change to what the map looks like, see Revision()
+  uint32_t _revision{};
+
+  /**
+   * The tileset converted to the format of the surface it was last painted on, so tiles are
+   * plain copies instead of per-pixel conversions. Not carried over by copies.
+   */
+  struct BakedTileset {
+    std::unique_ptr<DrawableSurface> surface;
+    const DrawableSurface *source{};
+    DrawableSurface::TargetInformation format{};
+    uint32_t sourcePaletteRevision{};
+    uint32_t targetPaletteRevision{};
+
+    BakedTileset() = default;
+    BakedTileset(const BakedTileset &) {}
+    BakedTileset(BakedTileset &&) noexcept = default;
+    BakedTileset &operator=(const BakedTileset &other) {
+      if (&other != this) { Reset(); }
+      return *this;
+    }
+    BakedTileset &operator=(BakedTileset &&) noexcept = default;
+
+    void Reset() {
+      surface.reset();
+      source = nullptr;
+    }
+  } _baked;
+
   [[nodiscard]] WorldCoordinateType LayerSize() const { return _map_size.Area(); }
 
   [[nodiscard]] WorldCoordinateType PositionToLinear(const Position &pos) const {
@@ -34,34 +86,37 @@ class Map : public Resource {
   }
 
   [[nodiscard]] bool ValidDataPosition(size_t position) const { return _map_tile.size() > position; }
+  [[nodiscard]] static size_t SolidWordsPerRow(WorldCoordinateType width) { return (static_cast<size_t>(width) + 63) / 64; }
+  void UpdateOptions(size_t position);
+  void UpdateAllOptions();
   void ComputeTilesetTileSize();
 
+  /**
+   * The tileset to draw from when painting with `painter`: the baked copy when the painter's
+   * format is known, the tileset itself otherwise. Re-bakes when the target format or either
+   * palette changed since the last call.
+   */
+  const DrawableSurface &TilesetFor(const Painter &painter);
+
 public:
   Map() : _map_size(0, 0), _tileset() {}
 
   Map(WorldCoordinateType width, WorldCoordinateType height)
       : _map_size(width, height),
         _map_tile(LayerSize()),
-        _options(LayerSize()) {}
+        _options(LayerSize()),
+        _solid(SolidWordsPerRow(width) * height),
+        _solid_words_per_row(SolidWordsPerRow(width)) {}
 
   Map(const Map &other) = default;
-
-  Map(Map &&other) noexcept
-      : _map_size(other._map_size),
-        _map_tile(std::move(other._map_tile)),
-        _options(std::move(other._options)),
-        _tileset(std::move(other._tileset)) {}
+  Map(Map &&other) noexcept = default;
 
   ~Map() override = default;
 
   Map &operator=(const Map &other) {
     if (&other != this) {
-      _map_size = other._map_size;
-      _map_tile.clear();
-      _map_tile = other._map_tile;
-      _options.clear();
-      _options = other._options;
-      _tileset = other._tileset;
+      Map copy(other);
+      *this = std::move(copy);
     }
 
     return *this;
@@ -69,18 +124,32 @@ public:
 
   Map &operator=(Map &&other) noexcept {
     if (&other != this) {
-      std::swap(_map_size, other._map_size);
-      _map_tile.clear();
-      _map_tile.swap(other._map_tile);
-      _options.clear();
-      _options.swap(other._options);
+      // Past any revision this map or `other` had, so caches of either see the change
+      const auto revision = std::max(_revision, other._revision) + 1;
+
+      _map_size = other._map_size;
+      _map_tile = std::move(other._map_tile);
+      _options = std::move(other._options);
+      _tile_options = std::move(other._tile_options);
+      _solid = std::move(other._solid);
+      _solid_words_per_row = other._solid_words_per_row;
+      _tileset_size = other._tileset_size;
       _tileset = std::move(other._tileset);
+      _margin = other._margin;
+      _spacing = other._spacing;
+      _tiles_per_row = other._tiles_per_row;
+      _tile_rects = std::move(other._tile_rects);
+      _revision = revision;
+      _baked.Reset();
     }
 
     return *this;
   }
 
   [[nodiscard]] type_t Type() const override { return type_id<Map>(); }
+  [[nodiscard]] size_t MemoryUsage() const override {
+    return _map_tile.size() * (sizeof(TileIdType) + sizeof(TileOptions)) + _solid.size() * sizeof(uint64_t);
+  }
   explicit operator bool() const noexcept { return _map_size.x > 0 && _map_size.y > 0; }
   void SetTileset(ResourcePtrT<DrawableResource> set);
   [[nodiscard]] const ResourcePtrT<DrawableResource> &Tileset() const { return _tileset; }
@@ -89,6 +158,12 @@ public:
   [[nodiscard]] Vec2D<WorldCoordinateType> Size() const { return _map_size; }
   [[nodiscard]] TileIdType HighestTitleId() const { return *std::ranges::max_element(_map_tile); }
 
+  /**
+   * Changes every time a tile, the tile options, the tileset or the tile size changes; lets painted copies
+   * of the map and the path finder's grid know they're out of date
+   */
+  [[nodiscard]] uint32_t Revision() const { return _revision; }
+
   /**
    * 
    * @return size, in pixels, of a tile
@@ -115,7 +190,10 @@ public:
     return std::numeric_limits<TileIdType>::max();
   }
   
-  void SetTilesetSpacing(uint16_t spacing) { _spacing = spacing; }
+  void SetTilesetSpacing(uint16_t spacing) {
+    _spacing = spacing;
+    ComputeTilesetTileSize();
+  }
 
   /**
    *
@@ -128,12 +206,85 @@ public:
     const auto i = PositionToLinear(position);
     if (ValidDataPosition(i)) {
       _map_tile[i] = tileId;
+      UpdateOptions(i);
+      ++_revision;
       return true;
     }
 
     return false;
   }
 
+  /**
+   * @return every tile id, row by row
+   */
+  [[nodiscard]] std::span<const TileIdType> Tiles() const { return _map_tile; }
+
+  /**
+   * Replaces every tile at once instead of calling Set() for each. `fill` is given the Width() * Height()
+   * tile ids to write, row by row, and returns any error; tile options are looked up once it's done.
+   *
+   * @param fill writes the tiles
+   * @return the error `fill` returned, the map keeps whatever it wrote
+   */
+  template<typename Fill>
+  std::error_code AssignTiles(Fill &&fill) {
+    const auto ec = fill(std::span<TileIdType>(_map_tile));
+    UpdateAllOptions();
+    ++_revision;
+    return ec;
+  }
+
+  /**
+   * Sets the options of every tile `tileId`, already placed or not
+   *
+   * @param tileId the tile id, as used in the map (0 is no tile)
+   * @param options its options
+   */
+  void SetTileOptions(TileIdType tileId, const TileOptions &options);
+
+  /**
+   * Replaces the options of every tile id at once
+   *
+   * @param byTileId options indexed by tile id, ids past its end get the defaults
+   */
+  void SetTileOptions(std::vector<TileOptions> byTileId);
+
+  /**
+   * @return options of tile `tileId`, defaults if it has none
+   */
+  [[nodiscard]] TileOptions TileOptionsOf(TileIdType tileId) const {
+    return tileId < _tile_options.size() ? _tile_options[tileId] : TileOptions{};
+  }
+
+  /**
+   * @return options of the tile at `position`, defaults if out of bound
+   */
+  [[nodiscard]] TileOptions OptionsAt(const Position &position) const {
+    if (const auto i = PositionToLinear(position);
+        ValidDataPosition(i)) {
+      return _options[i];
+    }
+    return {};
+  }
+
+  /**
+   * @return true if the tile at `position` is solid; outside the map is solid
+   */
+  [[nodiscard]] bool IsSolid(const Position &position) const {
+    if (position.x >= _map_size.x || position.y >= _map_size.y) {
+      return true;
+    }
+    return (_solid[position.y * _solid_words_per_row + position.x / 64] >> (position.x % 64)) & 1;
+  }
+
+  /**
+   * Checks a whole area at once, a word of tiles at a time, this is what movement checks should use
+   *
+   * @param area the area, in tiles
+   * @return true if any tile of `area` is solid or `area` goes outside the map
+   */
+  [[nodiscard]] bool IsSolid(const RectT<WorldCoordinateType> &area) const;
+
   /**
    * Looks up the tile to use for world position `position` and paints it at
    * `origin` a bitmap of `tileSize`
@@ -143,5 +294,16 @@ public:
    * @param origin the start x, y to paint to
    */
   void PaintTile(const Position &position, Painter &painter, const Vec2D<BitmapSizeType> &origin);
+
+  /**
+   * Paints the part of the map starting at pixel `worldOrigin` (in map pixels, not tiles) and `size` pixels large at
+   * `dstPos`. Tiles cut by the edges of the region are partially drawn, this is what pixel scrolling needs.
+   *
+   * @param worldOrigin top left pixel of the region, in map pixels
+   * @param size size of the region, in pixels
+   * @param painter the painter to paint to
+   * @param dstPos where the top left pixel of the region goes
+   */
+  void PaintRegion(const Vec2D<uint32_t> &worldOrigin, const Vec2D<BitmapSizeType> &size, Painter &painter, const Vec2D<BitmapSizeType> &dstPos);
 };
 }// namespace e00
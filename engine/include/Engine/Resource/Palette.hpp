@@ -4,7 +4,9 @@
 #include "Engine/Resource.hpp"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <limits>
+#include <memory>
 
 namespace e00 {
 
@@ -16,12 +18,91 @@ class FixedPalette final : public Resource {
 public:
   static constexpr size_t MAX_SIZE = 256;
 
+  // Below this many colors, a linear scan is cheaper than the inverse color map
+  static constexpr size_t INVERSE_MAP_MIN_COLORS = 16;
+
 private:
+  /**
+   * Inverse color map: a 32x32x32 cube (5 bits per channel) giving the palette index to use
+   * for any color falling in each cell.
+   *
+   * Cells are resolved lazily, the first lookup landing in a cell does the linear scan for
+   * the cell's center. Cells holding a palette color are seeded with it, so palette colors
+   * always map back to themselves. A cell holding two different palette colors is marked
+   * SHARED and its lookups fall back to the linear scan.
+   *
+   * Cells are atomics so concurrent lookups can resolve them; two threads resolving the
+   * same cell compute the same value.
+   */
+  struct InverseColorMap {
+    static constexpr size_t BITS = 5;
+    static constexpr size_t CELLS = size_t{1} << (BITS * 3);
+
+    // Cell values: 0 is unresolved, otherwise the palette index + 1, or SHARED
+    static constexpr uint16_t UNRESOLVED = 0;
+    static constexpr uint16_t SHARED = 0x8000;
+
+    std::array<std::atomic<uint16_t>, CELLS> cells{};
+
+    static constexpr size_t CellOf(const Color &c) noexcept {
+      constexpr auto drop = 8 - BITS;
+      return (static_cast<size_t>(c.red >> drop) << (BITS * 2)) | (static_cast<size_t>(c.green >> drop) << BITS) | static_cast<size_t>(c.blue >> drop);
+    }
+
+    static constexpr Color CenterOf(size_t cell) noexcept {
+      constexpr auto drop = 8 - BITS;
+      constexpr size_t cellMask = (size_t{1} << BITS) - 1;
+      constexpr uint8_t half = 1u << (drop - 1);
+      return {
+          static_cast<uint8_t>((((cell >> (BITS * 2)) & cellMask) << drop) | half),
+          static_cast<uint8_t>((((cell >> BITS) & cellMask) << drop) | half),
+          static_cast<uint8_t>(((cell & cellMask) << drop) | half)};
+    }
+  };
+
   std::array<Color, MAX_SIZE> colors;
   size_t numberOfColors;
   bool hasTransparency;
   uint8_t transparencyIndex;
 
+  // Built on the first lookup, dropped whenever the colors change. Lookups may race each
+  // other (the first map published wins), but not a write to the colors.
+  mutable std::atomic<InverseColorMap *> inverseMap{nullptr};
+
+  // See revision(); 0 until asked for
+  mutable std::atomic<uint32_t> colorsRevision{0};
+
+  void colorsChanged() noexcept {
+    delete inverseMap.exchange(nullptr, std::memory_order_acq_rel);
+    colorsRevision.store(0, std::memory_order_relaxed);
+  }
+
+  InverseColorMap &getInverseMap() const {
+    auto *map = inverseMap.load(std::memory_order_acquire);
+    if (map) {
+      return *map;
+    }
+
+    auto built = std::make_unique<InverseColorMap>();
+
+    // Walk backwards so the lowest index wins, like the linear scan does for duplicates
+    for (size_t i = numberOfColors; i-- > 0;) {
+      auto &cell = built->cells[InverseColorMap::CellOf(colors[i])];
+      const auto seeded = cell.load(std::memory_order_relaxed);
+      if (seeded == InverseColorMap::UNRESOLVED || (seeded != InverseColorMap::SHARED && colors[seeded - 1u] == colors[i])) {
+        cell.store(static_cast<uint16_t>(i + 1), std::memory_order_relaxed);
+      } else {
+        cell.store(InverseColorMap::SHARED, std::memory_order_relaxed);
+      }
+    }
+
+    if (inverseMap.compare_exchange_strong(map, built.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return *built.release();
+    }
+    // Another lookup published its map first
+    return *map;
+  }
+
 public:
   constexpr FixedPalette()
       : numberOfColors(0),
@@ -50,19 +131,15 @@ public:
       : colors(other.colors),
         numberOfColors(other.numberOfColors),
         hasTransparency(other.hasTransparency),
-        transparencyIndex(other.transparencyIndex) {
-  }
-
-  ~FixedPalette() override = default;
+        transparencyIndex(other.transparencyIndex),
+        inverseMap(other.inverseMap.exchange(nullptr)),
+        colorsRevision(other.colorsRevision.exchange(0)) {}
 
-  constexpr const Color &operator[](const size_t index) const noexcept {
-    if (index >= numberOfColors) {
-      abort();
-    }
-    return colors[index];
+  ~FixedPalette() override {
+    delete inverseMap.load();
   }
 
-  Color &operator[](const size_t index) noexcept {
+  constexpr const Color &operator[](const size_t index) const noexcept {
     if (index >= numberOfColors) {
       abort();
     }
@@ -74,6 +151,7 @@ public:
       abort();
     }
     colors[index] = color;
+    colorsChanged();
   }
 
   /**
@@ -105,7 +183,7 @@ public:
    * @param x The reference color to find the closest match for.
    * @return The index of the closest matching color (exact or minimum distance).
    */
-  [[nodiscard]] uint8_t findClosestColorIndex(const Color &x) const {
+  [[nodiscard]] uint8_t findExactClosestColorIndex(const Color &x) const {
     uint8_t closestIndex = 0;
     uint32_t minDistance = std::numeric_limits<uint32_t>::max();
 
@@ -135,6 +213,38 @@ public:
     return closestIndex;
   }
 
+  /**
+   * Finds the palette index to use for a color, in constant time.
+   *
+   * Goes through the inverse color map, so colors that aren't in the palette are matched
+   * to within the map's cell size (8 levels per channel) rather than exactly; use
+   * findExactClosestColorIndex() when that matters. Palette colors always map to their own
+   * index (the lowest one for duplicates). Small palettes skip the map.
+   *
+   * Safe to call from several threads at once, as long as nothing writes to the palette.
+   *
+   * @param x The reference color to find the closest match for.
+   * @return The index of the closest matching color.
+   */
+  [[nodiscard]] uint8_t findClosestColorIndex(const Color &x) const {
+    if (numberOfColors < INVERSE_MAP_MIN_COLORS) {
+      return findExactClosestColorIndex(x);
+    }
+
+    const auto cellIndex = InverseColorMap::CellOf(x);
+    auto &cell = getInverseMap().cells[cellIndex];
+    const auto value = cell.load(std::memory_order_relaxed);
+    if (value == InverseColorMap::SHARED) {
+      return findExactClosestColorIndex(x);
+    }
+    if (value == InverseColorMap::UNRESOLVED) {
+      const auto index = findExactClosestColorIndex(InverseColorMap::CenterOf(cellIndex));
+      cell.store(static_cast<uint16_t>(index + 1), std::memory_order_relaxed);
+      return index;
+    }
+    return static_cast<uint8_t>(value - 1);
+  }
+
   [[nodiscard]] auto resolveIndex(const ColorOrIndex &colorOrIndex) const {
     if (colorOrIndex.isColor()) {
       return findClosestColorIndex(colorOrIndex.getColor());
@@ -151,13 +261,37 @@ public:
 
   [[nodiscard]] ColorOrIndex get(uint8_t index) const { return {colors[index], index}; }
 
+  /**
+   * Identifies the current set of colors of this palette.
+   *
+   * The value changes every time the colors might have changed, and is never shared with
+   * another palette, so caches built from a palette can tell whether they are stale by
+   * comparing the palette's address and revision.
+   *
+   * @return A non-zero revision number.
+   */
+  [[nodiscard]] uint32_t revision() const noexcept {
+    auto current = colorsRevision.load(std::memory_order_relaxed);
+    if (current == 0) {
+      static std::atomic<uint32_t> nextRevision{0};
+      uint32_t fresh;
+      do {
+        fresh = ++nextRevision;
+      } while (fresh == 0);
+
+      // A concurrent caller may have picked one first, everyone returns the stored value
+      if (colorsRevision.compare_exchange_strong(current, fresh, std::memory_order_relaxed)) {
+        current = fresh;
+      }
+    }
+    return current;
+  }
+
   [[nodiscard]] auto size() const noexcept { return numberOfColors; }
   [[nodiscard]] auto empty() const noexcept { return numberOfColors == 0; }
 
   [[nodiscard]] auto begin() const noexcept { return colors.begin(); }
-  [[nodiscard]] auto begin() noexcept { return colors.begin(); }
   [[nodiscard]] auto end() const noexcept { return colors.begin() + size(); }
-  [[nodiscard]] auto end() noexcept { return colors.begin() + size(); }
   /**
    * Changes the number of colors in this palette
    *
@@ -168,6 +302,7 @@ public:
       abort();
     }
     numberOfColors = num_colors_in_palette;
+    colorsChanged();
   }
 
   /**
@@ -187,7 +322,7 @@ public:
     return !(*this == rhs);
   }
 
-  constexpr FixedPalette &operator=(const FixedPalette &rhs) {
+  FixedPalette &operator=(const FixedPalette &rhs) {
     if (this == &rhs) {
       return *this;
     }
@@ -199,6 +334,7 @@ public:
     for (size_t i = 0; i < numberOfColors; ++i) {
       colors[i] = rhs.colors[i];
     }
+    colorsChanged();
 
     return *this;
   }
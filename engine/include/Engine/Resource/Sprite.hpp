@@ -56,6 +56,7 @@ public:
   [[nodiscard]] auto CurrentTime() const { return _current_time; }
 
   [[nodiscard]] type_t Type() const override { return type_id<Sprite>(); }
+  [[nodiscard]] size_t MemoryUsage() const override;
   [[nodiscard]] size_t GetNumberOfColorsInPalette() const override { return _palette.size(); }
   [[nodiscard]] Color GetColorFromPalette(size_t index) const override {
     if (index < _palette.size()) {
@@ -67,11 +68,19 @@ public:
 
   [[nodiscard]] std::unique_ptr<Painter> BeginDraw() override;
 
+  [[nodiscard]] TargetInformation GetNativeFormat() const override;
+  [[nodiscard]] std::span<const uint8_t> GetNativeLine(BitmapSizeType y) const override;
+
   void ReadLineInto(
       BitmapSizeType line,
       BitmapSizeType startX, BitmapSizeType endX,
       const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer) const override;
 
+  void ReadLinesInto(
+      BitmapSizeType firstLine, BitmapSizeType lineCount,
+      BitmapSizeType startX, BitmapSizeType endX,
+      const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer, size_t targetStride) const override;
+
   /**
    * Adds a frame to the end of the frame list
    * 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <string>
@@ -11,14 +12,29 @@
 #include <Engine/Resource.hpp>
 
 namespace e00 {
+class ResourceManager;
+
 namespace detail {
 class ControlBlock {
+  friend class e00::ResourceManager;
+
   const ResourceId _id;
   const type_t _type;
   atomic_long _strong_ref_count;
+  std::atomic<uint32_t> _last_used{};// << UseClock when the resource was last accessed
+  std::atomic<size_t> _memory_usage{};// << What the resource took when it was loaded, as the manager counts it
+  std::atomic_flag _load_lock;       // << Held while loading, so only one thread does it
+
+  // Advanced every ResourceManager::Tick(), tells which resources went unused
+  static inline std::atomic<uint32_t> UseClock = 0;
+
+  // Drops the resource from memory, the next access loads it again
+  void Unload() noexcept {
+    delete _resource.exchange(nullptr, std::memory_order_acq_rel);
+  }
 
 protected:
-  Resource *_resource = nullptr;
+  std::atomic<Resource *> _resource = nullptr;
   virtual void OnZeroShared() noexcept = 0;
 
 public:
@@ -44,13 +60,30 @@ public:
   }
 
   [[nodiscard]] Resource *resource() {
-    if (!_resource) { (void) OnLoadLazyResource(); }
-    return _resource;
+    _last_used.store(UseClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if (auto *loaded = _resource.load(std::memory_order_acquire)) {
+      return loaded;
+    }
+
+    (void) EnsureLoaded();
+    return _resource.load(std::memory_order_acquire);
   }
 
-  [[nodiscard]] bool IsLoaded() const { return _resource != nullptr; }
+  /**
+   * Loads the resource if it isn't, with OnLoadLazyResource(); threads asking at the same time wait for the
+   * first one's load rather than start their own
+   */
+  std::error_code EnsureLoaded();
+
+  [[nodiscard]] bool IsLoaded() const { return _resource.load(std::memory_order_acquire) != nullptr; }
+  [[nodiscard]] uint32_t LastUsed() const { return _last_used.load(std::memory_order_relaxed); }
   virtual std::error_code OnLoadLazyResource() = 0;
 
+  /**
+   * @return true if the resource can be dropped from memory and loaded again by OnLoadLazyResource()
+   */
+  [[nodiscard]] virtual bool IsReloadable() const { return false; }
+
   explicit operator bool() const noexcept { return _id != 0 && _type != type_t{}; }
   [[nodiscard]] bool operator==(std::nullptr_t) const { return _id == 0 && _type == type_t{}; }
   [[nodiscard]] bool operator!=(std::nullptr_t) const { return _id != 0 || _type != type_t{}; }
@@ -153,7 +186,8 @@ struct ResourcePtrT {
   [[nodiscard]] pointer operator->() const { return get(); }
   [[nodiscard]] const_reference Ref() const { return *get(); }
 
-  std::error_code EnsureLoad() const { return !cb->IsLoaded() ? cb->OnLoadLazyResource() : std::error_code(); }
+  [[nodiscard]] bool IsLoaded() const { return cb->IsLoaded(); }
+  std::error_code EnsureLoad() const { return !cb->IsLoaded() ? cb->EnsureLoaded() : std::error_code(); }
 
 private:
   friend class ResourceManager;
@@ -6,42 +6,112 @@
 #include <Engine/Resource/Map.hpp>
 
 namespace e00 {
-struct Element {
-  Actor *actor{nullptr};
-  Vec2D<WorldCoordinateType> position{0, 0};
-
-  [[nodiscard]] RectT<WorldCoordinateType> bounds() const {
-    assert(actor != nullptr);
-    return {position, actor->Size()};
-  }
-
-  [[nodiscard]] WorldCoordinateType DistanceTo(const Vec2D<WorldCoordinateType> &point) const {
-    return position.DistanceTo(point);
-  }
-};
-
 /**
  * A `World` is a collection of actors at a position with a state
  * Currently can only contain one map, but expected to be able to support many
  */
 class World {
+public:
+  /**
+   * Handle to an actor in this world: a slot in the low 16 bits, the generation of that slot in the high 16.
+   * Once the actor is removed, its handle stops resolving even if the slot gets reused.
+   */
+  using NodeID = uint32_t;
+  static constexpr NodeID InvalidNodeID = std::numeric_limits<NodeID>::max();
+
+  // Bits of the per-actor flags
+  static constexpr uint8_t FlagMoved = 1 << 0;// Set by Update(), cleared by ClearFlags()
+
+  /**
+   * Every live actor, packed: entry `i` of each span describes the same actor.
+   * Meant for per-tick passes, which then read contiguous memory instead of following actor pointers.
+   * Invalidated by Insert() and Remove().
+   */
+  struct ActorColumns {
+    std::span<Actor *const> actor;
+    std::span<const WorldCoordinateType> x;
+    std::span<const WorldCoordinateType> y;
+    std::span<const WorldCoordinateType> width;
+    std::span<const WorldCoordinateType> height;
+    std::span<const Actor::BodyType> body;
+    std::span<const uint8_t> flags;
+    std::span<const NodeID> handle;
+  };
+
+  /**
+   * Two actors whose bounds overlap. `first` is always a Dynamic actor, `second` can have any body type
+   */
+  struct OverlapPair {
+    NodeID first;
+    NodeID second;
+
+    bool operator==(const OverlapPair &) const = default;
+  };
+
+private:
+  static constexpr size_t MaxActors = detail::MaxActorsInWorld;
+  static_assert(MaxActors <= 0xFFFF, "Slots have to fit in the low half of a NodeID");
+
+  // Actors per quadtree leaf before it splits
+  static constexpr size_t IndexLeafCapacity = 8;
+
   std::string _name;
   ResourcePtrT<e00::Map> _map;
-  std::array<Element, detail::MaxActorsInWorld> _elements;
 
-public:
-  using NodeID = decltype(_elements)::size_type;
-  static constexpr NodeID InvalidNodeID = std::numeric_limits<NodeID>::max();
+  // Live actors, packed at the front of every column; removing swaps the last actor in
+  std::array<Actor *, MaxActors> _actor{};
+  std::array<WorldCoordinateType, MaxActors> _x{};
+  std::array<WorldCoordinateType, MaxActors> _y{};
+  std::array<WorldCoordinateType, MaxActors> _width{};
+  std::array<WorldCoordinateType, MaxActors> _height{};
+  std::array<Actor::BodyType, MaxActors> _body{};
+  std::array<uint8_t, MaxActors> _flags{};
+  std::array<NodeID, MaxActors> _handle{};
+  size_t _numActors = 0;
+
+  // Handle slot -> packed index, and the slot's current generation
+  std::array<uint16_t, MaxActors> _slotIndex{};
+  std::array<uint16_t, MaxActors> _slotGeneration{};
+
+  // Unused slots, lowest last so it's handed out first
+  std::vector<uint16_t> _freeSlots;
+
+  // Where every actor is, for Query() and Nearest()
+  QuadTree<NodeID, IndexLeafCapacity> _index;
+
+  // Paths over _map
+  PathFinder _paths;
+
+  // FindOverlaps() buffers, kept to avoid allocating every tick
+  struct SweepEntry {
+    int32_t x0;
+    int32_t x1;
+    uint16_t index;
+  };
+  std::vector<SweepEntry> _sweep;
+  std::vector<SweepEntry> _sweepActive;
+
+  static constexpr size_t InvalidIndex = std::numeric_limits<size_t>::max();
+  static constexpr uint16_t SlotOf(NodeID id) { return static_cast<uint16_t>(id & 0xFFFF); }
+  static constexpr uint16_t GenerationOf(NodeID id) { return static_cast<uint16_t>(id >> 16); }
+
+  // Packed index of `id`, InvalidIndex if it doesn't resolve (anymore)
+  [[nodiscard]] size_t IndexOf(NodeID id) const {
+    const auto slot = SlotOf(id);
+    if (slot >= MaxActors || _slotGeneration[slot] != GenerationOf(id)) return InvalidIndex;
+    const auto index = _slotIndex[slot];
+    return index < _numActors && _handle[index] == id ? index : InvalidIndex;
+  }
 
+  void CopyActor(size_t from, size_t to);
+
+public:
   explicit World(std::string name);
 
   ~World();
 
-  // Currently only supports one map
-  std::error_code AddMap(ResourcePtrT<e00::Map> &&map) {
-    _map = std::move(map);
-    return {};
-  }
+  // Currently only supports one map; actors outside of it are moved onto its edge
+  std::error_code AddMap(ResourcePtrT<e00::Map> &&map);
 
   [[nodiscard]] auto Size() const { return _map->Size(); }
   [[nodiscard]] auto Width() const { return Size().x; }
@@ -49,20 +119,82 @@ public:
   [[nodiscard]] auto TileSize() const { return _map->TileSize(); }
 
   [[nodiscard]] const ResourcePtrT<e00::Map> &Map() const { return _map; }
+
+  /**
+   * Path finding over the map, worked on every tick by the engine
+   */
+  [[nodiscard]] PathFinder &Paths() { return _paths; }
   [[nodiscard]] size_t NumActors() const;
-  [[nodiscard]] const auto &Actors() const { return _elements; }
+  [[nodiscard]] ActorColumns Actors() const;
+
+  /**
+   * @return true if `element` is an actor of this world that wasn't removed
+   */
+  [[nodiscard]] bool Contains(NodeID element) const { return IndexOf(element) != InvalidIndex; }
+
+  /**
+   * @return the actor behind `element`, nullptr if it was removed
+   */
+  [[nodiscard]] Actor *GetActor(NodeID element) const;
+
+  /**
+   * @return where `element` is, {0, 0} if it was removed
+   */
+  [[nodiscard]] Vec2D<WorldCoordinateType> PositionOf(NodeID element) const;
+
+  /**
+   * @return the area covered by `element`, empty if it was removed
+   */
+  [[nodiscard]] RectT<WorldCoordinateType> BoundsOf(NodeID element) const;
+
+  /**
+   * Clears `flags` on every actor
+   */
+  void ClearFlags(uint8_t flags);
 
   void PaintTile(const Position &tilePosition, Painter &painter, const Vec2D<BitmapSizeType> &origin) const;
 
 
   /**
+   * Finds the actors positioned inside `bounds`
    *
-   * @param bounds
-   * @param output
+   * @param bounds the area to look in
+   * @param output the actors found are appended to it
    * @return `output`
    */
   std::vector<NodeID> &Query(const RectT<WorldCoordinateType> &bounds, std::vector<NodeID> &output) const;
 
+  /**
+   * Finds the `count` actors closest to `point`
+   *
+   * @param point where to look from
+   * @param count how many actors to find at most
+   * @param output the actors found are appended to it, closest first
+   * @return `output`
+   */
+  std::vector<NodeID> &Nearest(const Vec2D<WorldCoordinateType> &point, size_t count, std::vector<NodeID> &output) const;
+
+  /**
+   * Finds the actors whose bounds (position and size) overlap `area`; one pass over the packed columns
+   *
+   * @param area the area to look in
+   * @param output the actors found are appended to it
+   * @return `output`
+   */
+  std::vector<NodeID> &Overlapping(const RectT<WorldCoordinateType> &area, std::vector<NodeID> &output) const;
+
+  /**
+   * Broad phase collision: finds every pair of actors whose bounds overlap and where at least one is Dynamic.
+   * Static actors never pair with each other, triggers (None) only pair with Dynamic actors.
+   *
+   * Sorts the actors along x and sweeps, so the cost follows the number of actors and overlaps instead of
+   * testing every pair.
+   *
+   * @param output the pairs found are appended to it
+   * @return `output`
+   */
+  std::vector<OverlapPair> &FindOverlaps(std::vector<OverlapPair> &output);
+
   /**
    * Inserts actor `actor` at position `position`
    *
@@ -73,7 +205,8 @@ public:
   NodeID Insert(Actor *actor, const Vec2D<WorldCoordinateType> &position);
 
   /**
-   * Change the position of element
+   * Change the position of element; its size and body type are read again from the actor
+   * Positions outside of the map are ignored.
    *
    * @param element
    * @param position
@@ -0,0 +1,100 @@
+#include "Archive.hpp"
+#include "SpinLock.hpp"
+
+namespace e00::impl {
+
+/**
+ * One entry of the archive; positions are relative to the entry
+ */
+class Archive::Slice : public Stream {
+  std::shared_ptr<Archive> _archive;
+  const size_t _offset;
+
+public:
+  Slice(std::shared_ptr<Archive> archive, const archive::IndexEntry &entry)
+      : Stream(entry.size),
+        _archive(std::move(archive)),
+        _offset(entry.offset) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    // A mapped archive is read without seeking, nor locking
+    if (const auto mapped = real_map(); !mapped.empty()) {
+      std::memcpy(data, mapped.data() + _current_position, size);
+      return {};
+    }
+    return _archive->ReadAt(_offset + _current_position, size, data);
+  }
+
+  // Every read seeks the archive anyway
+  std::error_code real_seek(size_t) override { return {}; }
+
+  [[nodiscard]] std::span<const uint8_t> real_map() const override {
+    const auto archive = _archive->_stream->Map();
+    return archive.empty() ? std::span<const uint8_t>{} : archive.subspan(_offset, _stream_size);
+  }
+};
+
+std::expected<std::shared_ptr<Archive>, std::error_code> Archive::Open(std::unique_ptr<Stream> &&stream) {
+  if (!stream) {
+    return std::unexpected(std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+
+  archive::Header header{};
+  if (const auto ec = stream->Read(header)) {
+    return std::unexpected(ec);
+  }
+
+  if (header.magic != archive::Magic || header.version != archive::Version) {
+    GetDefaultLogger().Error(source_location::current(), "Not a resource archive, or of an unknown version");
+    return std::unexpected(std::make_error_code(std::errc::illegal_byte_sequence));
+  }
+
+  if (header.entry_count > stream->AvailableToRead() / sizeof(archive::IndexEntry)) {
+    GetDefaultLogger().Error(source_location::current(), "Resource archive index is truncated");
+    return std::unexpected(std::make_error_code(std::errc::illegal_byte_sequence));
+  }
+
+  auto result = std::shared_ptr<Archive>(new Archive(std::move(stream)));
+  result->_index.resize(header.entry_count);
+  if (header.entry_count > 0) {
+    if (const auto ec = result->_stream->Read(result->_index)) {
+      return std::unexpected(ec);
+    }
+  }
+
+  // Entries must stay inside the archive, and be sorted for Find()
+  const auto archiveSize = result->_stream->Size();
+  for (size_t i = 0; i < result->_index.size(); ++i) {
+    const auto &entry = result->_index[i];
+    if (entry.offset > archiveSize || entry.size > archiveSize - entry.offset
+        || (i > 0 && result->_index[i - 1].id >= entry.id)) {
+      GetDefaultLogger().Error(source_location::current(), "Resource archive entry {} is invalid", entry.id);
+      return std::unexpected(std::make_error_code(std::errc::illegal_byte_sequence));
+    }
+  }
+
+  return result;
+}
+
+const archive::IndexEntry *Archive::Find(ResourceId id) const {
+  const auto it = std::ranges::lower_bound(_index, id, {}, &archive::IndexEntry::id);
+  return it != _index.end() && it->id == id ? &*it : nullptr;
+}
+
+std::unique_ptr<Stream> Archive::OpenEntry(ResourceId id) {
+  if (const auto *entry = Find(id)) {
+    return std::make_unique<Slice>(shared_from_this(), *entry);
+  }
+  return nullptr;
+}
+
+std::error_code Archive::ReadAt(size_t position, size_t size, void *data) {
+  const SpinLockGuard lock(_stream_lock);
+  if (const auto ec = _stream->SeekTo(position)) {
+    return ec;
+  }
+  return _stream->Read(size, data);
+}
+
+}// namespace e00::impl
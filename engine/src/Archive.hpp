@@ -0,0 +1,54 @@
+#pragma once
+
+#include "PrivateInclude.hpp"
+
+#include <Engine/Platform/ArchiveFormat.hpp>
+
+#include <atomic>
+#include <expected>
+
+namespace e00::impl {
+
+/**
+ * A resource archive, see ArchiveFormat.hpp. The file is opened once; every entry opened from it is a
+ * slice of that one stream, read without opening anything else.
+ */
+class Archive : public std::enable_shared_from_this<Archive> {
+  std::unique_ptr<Stream> _stream;
+  std::vector<archive::IndexEntry> _index;// << Sorted by id
+  std::atomic_flag _stream_lock;          // << Slices may be read from background loads
+
+  class Slice;
+
+  explicit Archive(std::unique_ptr<Stream> &&stream) : _stream(std::move(stream)) {}
+
+  // Reads `size` bytes at `position` of the archive
+  std::error_code ReadAt(size_t position, size_t size, void *data);
+
+public:
+  /**
+   * Reads the index of an archive
+   *
+   * @param stream the archive, kept open until the archive and every stream opened from it are gone
+   * @return the archive, or why it isn't one
+   */
+  static std::expected<std::shared_ptr<Archive>, std::error_code> Open(std::unique_ptr<Stream> &&stream);
+
+  [[nodiscard]] size_t EntryCount() const { return _index.size(); }
+  [[nodiscard]] bool Contains(ResourceId id) const { return Find(id) != nullptr; }
+
+  /**
+   * @return the entry named `id`, nullptr if there is none
+   */
+  [[nodiscard]] const archive::IndexEntry *Find(ResourceId id) const;
+
+  /**
+   * Opens the entry named `id`
+   *
+   * @param id the HashName() of a file name or alias
+   * @return the entry's data, nullptr if there is no such entry
+   */
+  std::unique_ptr<Stream> OpenEntry(ResourceId id);
+};
+
+}// namespace e00::impl
@@ -15,8 +15,8 @@ std::vector<ModernThread> _thread_handles;
 
 namespace platform {
 
-int CreateThread(e00::Task &&task, size_t /*stack_sz*/) {
-  // Modern OS can just capture and move the e00::Task right into std::jthread!
+ThreadId CreateThread(Task &&task, size_t /*stack_sz*/) {
+  // Modern OS can just capture and move the Task right into std::jthread!
   std::jthread native_worker([captured_task = std::move(task)]() mutable {
     captured_task();
   });
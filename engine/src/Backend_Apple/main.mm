@@ -374,9 +374,16 @@ void ProcessDraw(e00::Engine &engine) {
       return;
     }
 
+    auto *root = engine.RootWidget();
+    const auto dirty = root->TakeDirtyRects();
+    if (dirty.empty()) {
+      // The layer keeps showing the last frame
+      return;
+    }
+
     {
       auto painter = GetMainSurface(engine).BeginDraw();
-      engine.RootWidget()->Paint(*painter);
+      root->PaintDirtyRects(*painter, dirty);
     }
 
     if (!surface->UploadToTexture(g_device)) {
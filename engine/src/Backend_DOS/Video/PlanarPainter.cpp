@@ -3,8 +3,13 @@
 #include "PlanarSurfaceHw.hpp"
 #include <cstring>
 
-void DOS::PlanarPainter::write_pixel_planar(int x, int y, uint8_t index) {
-  if (x < 0 || x >= _width || y < 0 || y >= _height) return;
+DOS::PlanarPainter::ClipBox DOS::PlanarPainter::CurrentClip() const {
+  const auto clip = _clipRect.Intersect({0, 0, _width, _height});
+  return {clip.origin.x, clip.origin.y, clip.origin.x + clip.size.x, clip.origin.y + clip.size.y};
+}
+
+void DOS::PlanarPainter::write_pixel_planar(const ClipBox &clip, int x, int y, uint8_t index) {
+  if (!clip.Contains(x, y)) return;
 
   const int byte_offset = x >> _shift;
   const int bit_index = x % (1 << _shift);
@@ -37,7 +42,7 @@ void DOS::PlanarPainter::write_pixel_planar(int x, int y, uint8_t index) {
 
 void DOS::PlanarPainter::DrawPoint(const e00::Vec2D<e00::BitmapSizeType> &pos) {
   if (_penStyle == PenStyle::NoPen) return;
-  write_pixel_planar(pos.x, pos.y, _penIndex);
+  write_pixel_planar(CurrentClip(), pos.x, pos.y, _penIndex);
 }
 
 void DOS::PlanarPainter::DrawLine(const e00::Vec2D<e00::BitmapSizeType> &start, const e00::Vec2D<e00::BitmapSizeType> &end) {
@@ -48,12 +53,16 @@ void DOS::PlanarPainter::DrawLine(const e00::Vec2D<e00::BitmapSizeType> &start,
   const int x1 = end.x;
   const int y1 = end.y;
 
+  // Lines entirely outside of the clip are dropped as a whole
+  const auto clip = CurrentClip();
+  if (std::max(x0, x1) < clip.x0 || std::min(x0, x1) >= clip.x1 || std::max(y0, y1) < clip.y0 || std::min(y0, y1) >= clip.y1) return;
+
   const int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
   const int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
   int err = dx + dy, e2;
 
   for (;;) {
-    write_pixel_planar(x0, y0, _penIndex);
+    write_pixel_planar(clip, x0, y0, _penIndex);
     if (x0 == x1 && y0 == y1) break;
     e2 = 2 * err;
     if (e2 >= dy) {
@@ -68,10 +77,11 @@ void DOS::PlanarPainter::DrawLine(const e00::Vec2D<e00::BitmapSizeType> &start,
 }
 
 void DOS::PlanarPainter::DrawRect(const e00::RectT<e00::BitmapSizeType> &rect) {
-  const int start_x = std::max<int>(0, rect.origin.x);
-  const int end_x = std::min<int>(_width, rect.origin.x + rect.size.x);
-  const int start_y = std::max<int>(0, rect.origin.y);
-  const int end_y = std::min<int>(_height, rect.origin.y + rect.size.y);
+  const auto clip = CurrentClip();
+  const int start_x = std::max<int>(clip.x0, rect.origin.x);
+  const int end_x = std::min<int>(clip.x1, rect.origin.x + rect.size.x);
+  const int start_y = std::max<int>(clip.y0, rect.origin.y);
+  const int end_y = std::min<int>(clip.y1, rect.origin.y + rect.size.y);
 
   if (start_x >= end_x || start_y >= end_y) return;
 
@@ -166,17 +176,26 @@ void DOS::PlanarPainter::DrawEllipse(const e00::RectT<e00::BitmapSizeType> &rect
   long p = e00::lrint(ry2 - rx2 * ry + 0.25 * rx2);
   long dx = 2 * ry2 * x, dy = 2 * rx2 * y;
 
+  const auto clip = CurrentClip();
+  if (xc + rx < clip.x0 || xc - rx >= clip.x1 || yc + ry < clip.y0 || yc - ry >= clip.y1) return;
+
   auto plot_symmetrical = [&](long px, long py) {
     if (_brushStyle != BrushStyle::NoBrush) {
-      // Fill horizontal scanning spans between interior boundaries
-      for (long ix = xc - px; ix <= xc + px; ++ix) write_pixel_planar(ix, yc + py, _brushIndex);
-      for (long ix = xc - px; ix <= xc + px; ++ix) write_pixel_planar(ix, yc - py, _brushIndex);
+      // Fill horizontal scanning spans between interior boundaries, clipped once per span
+      const long from_x = std::max<long>(xc - px, clip.x0);
+      const long to_x = std::min<long>(xc + px + 1, clip.x1);
+      if (yc + py >= clip.y0 && yc + py < clip.y1) {
+        for (long ix = from_x; ix < to_x; ++ix) write_pixel_planar(clip, ix, yc + py, _brushIndex);
+      }
+      if (yc - py >= clip.y0 && yc - py < clip.y1) {
+        for (long ix = from_x; ix < to_x; ++ix) write_pixel_planar(clip, ix, yc - py, _brushIndex);
+      }
     }
     if (_penStyle != PenStyle::NoPen) {
-      write_pixel_planar(xc + px, yc + py, _penIndex);
-      write_pixel_planar(xc - px, yc + py, _penIndex);
-      write_pixel_planar(xc + px, yc - py, _penIndex);
-      write_pixel_planar(xc - px, yc - py, _penIndex);
+      write_pixel_planar(clip, xc + px, yc + py, _penIndex);
+      write_pixel_planar(clip, xc - px, yc + py, _penIndex);
+      write_pixel_planar(clip, xc + px, yc - py, _penIndex);
+      write_pixel_planar(clip, xc - px, yc - py, _penIndex);
     }
   };
 
@@ -212,10 +231,11 @@ void DOS::PlanarPainter::DrawEllipse(const e00::RectT<e00::BitmapSizeType> &rect
 }
 
 void DOS::PlanarPainter::DrawSurface(const e00::DrawableSurface &src, e00::RectT<e00::BitmapSizeType> srcRect, e00::Vec2D<e00::BitmapSizeType> dstPos) {
-  const int start_y = std::max<int>(0, dstPos.y);
-  const int end_y = std::min<int>(_height, dstPos.y + srcRect.size.y);
-  const int start_x = std::max<int>(0, dstPos.x);
-  const int end_x = std::min<int>(_width, dstPos.x + srcRect.size.x);
+  const auto clip = CurrentClip();
+  const int start_y = std::max<int>(clip.y0, dstPos.y);
+  const int end_y = std::min<int>(clip.y1, dstPos.y + srcRect.size.y);
+  const int start_x = std::max<int>(clip.x0, dstPos.x);
+  const int end_x = std::min<int>(clip.x1, dstPos.x + srcRect.size.x);
 
   if (start_x >= end_x || start_y >= end_y) return;
 
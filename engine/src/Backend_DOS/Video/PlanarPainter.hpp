@@ -20,8 +20,16 @@ class PlanarPainter : public e00::Painter {
   bool _is_hardware;
   int _shift;// 3 for Mode 12h/EGA (div 8)
 
+  // Clip rectangle intersected with the screen, [x0, x1) x [y0, y1); computed once per primitive
+  struct ClipBox {
+    int x0, y0, x1, y1;
+
+    [[nodiscard]] bool Contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+  };
+  [[nodiscard]] ClipBox CurrentClip() const;
+
   // Hardware write helper using Write Mode 2
-  void write_pixel_planar(int x, int y, uint8_t index);
+  void write_pixel_planar(const ClipBox &clip, int x, int y, uint8_t index);
 
 public:
   PlanarPainter(e00::DrawableSurface &target,
@@ -58,6 +66,10 @@ public:
     }
   }
 
+  [[nodiscard]] e00::DrawableSurface::TargetInformation TargetFormat() const override {
+    return {e00::DrawableSurface::BitDepth::DEPTH_8, &_palette};
+  }
+
   void DrawPoint(const e00::Vec2D<e00::BitmapSizeType> &pos) override;
   void DrawLine(const e00::Vec2D<e00::BitmapSizeType> &start, const e00::Vec2D<e00::BitmapSizeType> &end) override;
   void DrawRect(const e00::RectT<e00::BitmapSizeType> &rect) override;
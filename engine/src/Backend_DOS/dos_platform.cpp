@@ -181,12 +181,23 @@ void ProcessEvents(e00::Engine &engine) {
 
 void ProcessDraw(e00::Engine &engine) {
   if (mainSurface && mainSurfaceBuffer) {
-    if (const auto painter = mainSurfaceBuffer->BeginDraw()) {
-      engine.RootWidget()->Paint(*painter);
-    }
-
-    if (const auto painter = mainSurface->BeginDraw()) {
-      painter->DrawSurface(*mainSurfaceBuffer, {{0, 0}, mainSurfaceBuffer->Size()}, {0, 0});
+    auto *root = engine.RootWidget();
+    const auto dirty = root->TakeDirtyRects();
+
+    if (!dirty.empty()) {
+      if (const auto painter = mainSurfaceBuffer->BeginDraw()) {
+        root->PaintDirtyRects(*painter, dirty);
+      }
+
+      // Only copy the repainted areas to video memory
+      if (const auto painter = mainSurface->BeginDraw()) {
+        const e00::RectT<e00::BitmapSizeType> bufferRect{{0, 0}, mainSurfaceBuffer->Size()};
+        for (const auto &rect: dirty) {
+          if (const auto r = rect.Intersect(bufferRect); r.isValid()) {
+            painter->DrawSurface(*mainSurfaceBuffer, r, r.origin);
+          }
+        }
+      }
     }
   }
 
@@ -0,0 +1,54 @@
+#include "MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define E00_HAS_MMAP
+#endif
+
+namespace platform {
+
+#ifdef E00_HAS_MMAP
+std::unique_ptr<MappedFile> MappedFile::CreateFromFilename(const std::string_view &fileName) {
+  const std::string path(fileName);
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  // Empty files can't be mapped, the caller falls back to reading them
+  struct stat info{};
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  const auto size = static_cast<size_t>(info.st_size);
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping stays valid once the descriptor is closed
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // Loaders mostly go through files front to back
+  (void) posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+  return std::make_unique<MappedFile>(static_cast<const uint8_t *>(data), size);
+}
+
+MappedFile::~MappedFile() {
+  munmap(const_cast<uint8_t *>(_data), _stream_size);
+}
+#else
+std::unique_ptr<MappedFile> MappedFile::CreateFromFilename(const std::string_view &) {
+  return nullptr;
+}
+
+MappedFile::~MappedFile() = default;
+#endif
+
+}// namespace platform
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Engine.hpp>
+
+namespace platform {
+/**
+ * A read only file mapped in memory. Reads copy out of the mapping, Peek() and Map() don't copy at all.
+ * Only POSIX systems can map files, CreateFromFilename() returns nullptr elsewhere.
+ */
+class MappedFile : public e00::Stream {
+  const uint8_t *const _data;
+
+public:
+  using Stream::Read;
+
+  /**
+   * Maps a file
+   *
+   * @param fileName the file to map
+   * @return the mapped file, nullptr if it can't be mapped (missing, empty, or no mapping on this system)
+   */
+  static std::unique_ptr<MappedFile> CreateFromFilename(const std::string_view &fileName);
+
+  MappedFile(const uint8_t *data, size_t size)
+      : Stream(size),
+        _data(data) {}
+
+  ~MappedFile() override;
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::memcpy(data, _data + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+
+  [[nodiscard]] std::span<const uint8_t> real_map() const override { return {_data, _stream_size}; }
+};
+}// namespace platform
@@ -0,0 +1,22 @@
+#include "Platform.hpp"
+
+#include <system_error>
+#include <thread>
+
+namespace platform {
+
+ThreadId CreateThread(Task &&task, size_t /*stack_sz*/) {
+  // Threads run to completion on their own, nobody joins them
+  try {
+    std::thread native_worker([captured_task = std::move(task)]() mutable {
+      captured_task();
+    });
+    native_worker.detach();
+  } catch (const std::system_error &) {
+    return InvalidThreadId;
+  }
+
+  return 1;
+}
+
+}// namespace platform
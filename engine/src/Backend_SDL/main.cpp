@@ -1,6 +1,7 @@
 
 #include "Bitmap.hpp"
 #include "Logger.h"
+#include "MappedFile.hpp"
 #include "Platform.hpp"
 #include "SDL_KeyboardSystem.h"
 #include "StdFile.hpp"
@@ -96,6 +97,10 @@ void Exit() {
 }
 
 std::unique_ptr<e00::Stream> OpenStream(const std::string_view &name) {
+  // Mapped files let the loaders read without copying
+  if (auto mapped = MappedFile::CreateFromFilename(name)) {
+    return mapped;
+  }
   return StdFile::CreateFromFilename(name);
 }
 
@@ -123,6 +128,10 @@ void ProcessEvents(e00::Engine &engine) {
             engine.QueueActionForNextTick(e00::Engine::BuiltInAction_Quit());
             break;
 
+          case SDL_EVENT_WINDOW_EXPOSED:
+            engine.RootWidget()->Invalidate();
+            break;
+
           case SDL_EVENT_WINDOW_FOCUS_GAINED:
             hasFocus = true;
             SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
@@ -152,6 +161,10 @@ void ProcessEvents(e00::Engine &engine) {
           engine.QueueActionForNextTick(e00::Engine::BuiltInAction_Quit());
           break;
 
+        case SDL_EVENT_WINDOW_EXPOSED:
+          engine.RootWidget()->Invalidate();
+          break;
+
         case SDL_EVENT_WINDOW_FOCUS_GAINED:
           hasFocus = true;
           SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
@@ -183,9 +196,34 @@ void ProcessEvents(e00::Engine &engine) {
 
 void ProcessDraw(e00::Engine &engine) {
   if (sdlWindow) {
-    auto painter = GetMainSurface(engine).BeginDraw();
-    engine.RootWidget()->Paint(*painter);
-    SDL_UpdateWindowSurface(sdlWindow);
+    auto *root = engine.RootWidget();
+    const auto dirty = root->TakeDirtyRects();
+    if (dirty.empty()) {
+      return;
+    }
+
+    auto &surface = GetMainSurface(engine);
+    {
+      auto painter = surface.BeginDraw();
+      root->PaintDirtyRects(*painter, dirty);
+    }
+
+    // Only push what was repainted
+    const e00::RectT<e00::BitmapSizeType> surfaceRect{{0, 0}, surface.Size()};
+    std::vector<SDL_Rect> rects;
+    rects.reserve(dirty.size());
+    for (const auto &rect: dirty) {
+      if (const auto r = rect.Intersect(surfaceRect); r.isValid()) {
+        rects.push_back({r.origin.x, r.origin.y, r.size.x, r.size.y});
+      }
+    }
+
+    // Everything repainted was off the surface
+    if (rects.empty()) {
+      return;
+    }
+
+    SDL_UpdateWindowSurfaceRects(sdlWindow, rects.data(), static_cast<int>(rects.size()));
   }
 }
 
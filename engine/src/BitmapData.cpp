@@ -1,6 +1,8 @@
 
 #include "BitmapData.hpp"
+#include "BlitKernels.hpp"
 
+#include <array>
 #include <bit>
 #include <cstdint>
 
@@ -95,12 +97,29 @@ void BitmapData::WriteColor1(BitmapSizeType x, BitmapSizeType y, bool color) {
   }
 }
 
+struct BitmapData::LineConversion {
+  blit::RowKernel kernel = nullptr;
+  blit::RowParams params{};
+  std::array<uint32_t, FixedPalette::MAX_SIZE> paletteRaw{};
+  size_t srcBytesPerPixel = 0;
+  size_t dstBytesPerPixel = 0;
+};
+
 void BitmapData::ReadLineInto(
     BitmapSizeType line,
     BitmapSizeType startX, BitmapSizeType endX,
     const DrawableSurface::TargetInformation &targetInformation,
     DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
     std::span<uint8_t> targetBuffer) const {
+  ReadLinesInto(line, 1, startX, endX, targetInformation, srcDepth, sourcePalette, targetBuffer, targetBuffer.size());
+}
+
+void BitmapData::ReadLinesInto(
+    BitmapSizeType firstLine, BitmapSizeType lineCount,
+    BitmapSizeType startX, BitmapSizeType endX,
+    const DrawableSurface::TargetInformation &targetInformation,
+    DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+    std::span<uint8_t> targetBuffer, size_t targetStride) const {
   const auto dstDepth = targetInformation.bit_depth;
   const BitmapSizeType width = endX - startX;
 
@@ -115,29 +134,34 @@ void BitmapData::ReadLineInto(
     return;
   }
 
+  const auto targetLine = [&](BitmapSizeType i) { return targetBuffer.subspan(i * targetStride); };
+
   const auto both8Bit = helpers::is8Bit(srcDepth) && helpers::is8Bit(dstDepth);
   const auto eitherSideDontNeedPalette = srcDepth == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE || dstDepth == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE;
 
   // Optimized path for 8-bit to 8-bit matching
   // If either is NO_PALETTE, we don't care about palette matching, it's just a raw copy
   if (both8Bit && (eitherSideDontNeedPalette || (targetPalette && sourcePalette.isSamePalette(*targetPalette)))) {
-    const auto srcLine = GetLineSpan(line);
-    memcpy(
-        targetBuffer.data(),
-        srcLine.data() + startX,
-        helpers::BitmapDepth8::ValidBytesPerLine(width));
-
+    for (BitmapSizeType i = 0; i < lineCount; ++i) {
+      const auto srcLine = GetLineSpan(firstLine + i);
+      memcpy(
+          targetLine(i).data(),
+          srcLine.data() + startX,
+          helpers::BitmapDepth8::ValidBytesPerLine(width));
+    }
     return;
   }
 
   // Optimized path for 32-bit to 32-bit matching (assuming standard layout)
   if (srcDepth == DrawableSurface::BitDepth::DEPTH_32 && dstDepth == DrawableSurface::BitDepth::DEPTH_32 &&
       targetInformation.shift == GetShift() && targetInformation.mask == GetMask()) {
-    const auto srcLine = GetLineSpan(line);
-    memcpy(
-        targetBuffer.data(),
-        srcLine.data() + startX * 4,
-        helpers::BitmapDepth32::ValidBytesPerLine(width));
+    for (BitmapSizeType i = 0; i < lineCount; ++i) {
+      const auto srcLine = GetLineSpan(firstLine + i);
+      memcpy(
+          targetLine(i).data(),
+          srcLine.data() + startX * 4,
+          helpers::BitmapDepth32::ValidBytesPerLine(width));
+    }
     return;
   }
 
@@ -157,7 +181,39 @@ void BitmapData::ReadLineInto(
     std::abort();
   }
 
-  // Generic implementation
+  if (lineCount == 0) {
+    return;
+  }
+
+  // Whole-row kernels for 8/16/32-bit pairs (vectorised where the CPU allows it), set up once for every line
+  LineConversion conversion;
+  const bool useKernel = PrepareLineConversion(targetInformation, srcDepth, sourcePalette, conversion)
+                         && valid_data_per_line >= (startX + width) * conversion.srcBytesPerPixel
+                         && targetBuffer.size() >= (lineCount - 1u) * targetStride + width * conversion.dstBytesPerPixel;
+
+  for (BitmapSizeType i = 0; i < lineCount; ++i) {
+    const auto srcLine = GetLineSpan(firstLine + i);
+    if (srcLine.empty()) {
+      continue;
+    }
+
+    if (useKernel) {
+      conversion.kernel(srcLine.data() + startX * conversion.srcBytesPerPixel, targetLine(i).data(), width, conversion.params);
+    } else {
+      ReadLineGeneric(srcLine, startX, width, targetInformation, srcDepth, sourcePalette, targetLine(i));
+    }
+  }
+}
+
+void BitmapData::ReadLineGeneric(
+    std::span<const uint8_t> srcLine,
+    BitmapSizeType startX, BitmapSizeType width,
+    const DrawableSurface::TargetInformation &targetInformation,
+    DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+    std::span<uint8_t> targetBuffer) const {
+  const auto dstDepth = targetInformation.bit_depth;
+  const auto *targetPalette = targetInformation.palette;
+
   for (BitmapSizeType x = 0; x < width; ++x) {
     const auto srcX = startX + x;
     using Depth = DrawableSurface::BitDepth;
@@ -165,10 +221,10 @@ void BitmapData::ReadLineInto(
     // Extract color from source
     Color c;
     switch (srcDepth) {
-      case Depth::DEPTH_1: c = ReadColor1(srcX, line) ? sourcePalette[1] : sourcePalette[0]; break;
-      case Depth::DEPTH_8: c = sourcePalette[ReadColor8(srcX, line)]; break;
-      case Depth::DEPTH_16: c = ReadColor16(srcX, line); break;
-      case Depth::DEPTH_32: c = ReadColor32(srcX, line); break;
+      case Depth::DEPTH_1: c = helpers::BitmapDepth1::ReadColor(srcLine, srcX) ? sourcePalette[1] : sourcePalette[0]; break;
+      case Depth::DEPTH_8: c = sourcePalette[helpers::BitmapDepth8::ReadColor(srcLine, srcX)]; break;
+      case Depth::DEPTH_16: c = helpers::BitmapDepth16::ReadColor(srcLine, srcX, shift, mask); break;
+      case Depth::DEPTH_32: c = helpers::BitmapDepth32::ReadColor(srcLine, srcX, shift, mask); break;
       case Depth::DEPTH_8_NO_PALETTE: std::abort();
       case Depth::DEPTH_INVALID: std::abort();
     }
@@ -186,5 +242,34 @@ void BitmapData::ReadLineInto(
   }
 }
 
+bool BitmapData::PrepareLineConversion(
+    const DrawableSurface::TargetInformation &targetInformation,
+    DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+    LineConversion &conversion) const {
+  const DrawableSurface::TargetInformation srcFormat{srcDepth, &sourcePalette, shift, mask};
+  conversion.kernel = blit::SelectRowKernel(srcFormat, targetInformation);
+  if (conversion.kernel == nullptr) {
+    return false;
+  }
+
+  conversion.srcBytesPerPixel = DepthEnumToBits(srcDepth) / 8u;
+  conversion.dstBytesPerPixel = DepthEnumToBits(targetInformation.bit_depth) / 8u;
+
+  conversion.params = {shift, mask, targetInformation.shift, targetInformation.mask};
+  conversion.params.dstPalette = targetInformation.palette;
+
+  // Indexed source: pack the palette into the target format once instead of once per pixel
+  if (srcDepth == DrawableSurface::BitDepth::DEPTH_8) {
+    for (size_t i = 0; i < sourcePalette.size(); ++i) {
+      const auto &c = sourcePalette[i];
+      conversion.paletteRaw[i] = targetInformation.bit_depth == DrawableSurface::BitDepth::DEPTH_16
+                                     ? helpers::BitmapDepth16::PackColor(c, targetInformation.shift, targetInformation.mask)
+                                     : helpers::BitmapDepth32::PackColor(c, targetInformation.shift, targetInformation.mask);
+    }
+    conversion.params.paletteRaw = conversion.paletteRaw.data();
+  }
+
+  return true;
+}
 
 }// namespace e00::impl
@@ -16,6 +16,27 @@ class BitmapData {
   DrawableSurface::RGBInfo shift;
   DrawableSurface::RGBInfo mask;
 
+  // A row kernel and what it needs, set up once for all the lines of a conversion
+  struct LineConversion;
+
+  /**
+   * Picks the row kernel for this pair of formats, packing an indexed source's palette for it
+   *
+   * @return false if there is no kernel for this pair of formats
+   */
+  [[nodiscard]] bool PrepareLineConversion(
+      const DrawableSurface::TargetInformation &targetInformation,
+      DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+      LineConversion &conversion) const;
+
+  // Pixel by pixel, for the pairs of formats without a row kernel
+  void ReadLineGeneric(
+      std::span<const uint8_t> srcLine,
+      BitmapSizeType startX, BitmapSizeType width,
+      const DrawableSurface::TargetInformation &targetInformation,
+      DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+      std::span<uint8_t> targetBuffer) const;
+
 public:
   enum class MemoryAlignment {
     NoAlignment,
@@ -74,6 +95,19 @@ public:
       DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
       std::span<uint8_t> targetBuffer) const;
 
+  /**
+   * Same as ReadLineInto() for `lineCount` lines from `firstLine`, the conversion being set up once for all of them
+   *
+   * @param targetBuffer receives the lines, one every `targetStride` bytes
+   * @param targetStride distance between the start of two lines in `targetBuffer`
+   */
+  void ReadLinesInto(
+      BitmapSizeType firstLine, BitmapSizeType lineCount,
+      BitmapSizeType startX, BitmapSizeType endX,
+      const DrawableSurface::TargetInformation &targetInformation,
+      DrawableSurface::BitDepth srcDepth, const FixedPalette &sourcePalette,
+      std::span<uint8_t> targetBuffer, size_t targetStride) const;
+
   auto GetLineSpan(const uint16_t y) {
     return std::span(
         data.data() + y * bytes_per_line,
@@ -33,7 +33,7 @@ public:
   void SetPalette(const e00::FixedPalette &colors) override { _palette = colors; }
   [[nodiscard]] std::error_code SetPaletteColor(std::size_t index, const e00::Color &color) override {
     if (index < _palette.size()) {
-      _palette[index] = color;
+      _palette.set(index, color);
       return {};
     }
 
@@ -52,8 +52,18 @@ public:
     _data.ReadLineInto(line, startX, endX, targetInformation, GetBitDepth(), _palette, targetBuffer);
   }
 
+  void ReadLinesInto(e00::BitmapSizeType firstLine, e00::BitmapSizeType lineCount,
+                     e00::BitmapSizeType startX, e00::BitmapSizeType endX,
+                     const TargetInformation &targetInformation,
+                     std::span<uint8_t> targetBuffer, size_t targetStride) const override {
+    _data.ReadLinesInto(firstLine, lineCount, startX, endX, targetInformation, GetBitDepth(), _palette, targetBuffer, targetStride);
+  }
+
   std::span<uint8_t> GetLineData(e00::BitmapSizeType y) override { return _data.GetLineSpan(y); }
 
+  [[nodiscard]] TargetInformation GetNativeFormat() const override { return {GetBitDepth(), &_palette, _data.GetShift(), _data.GetMask()}; }
+  [[nodiscard]] std::span<const uint8_t> GetNativeLine(e00::BitmapSizeType y) const override { return y < Size().y ? _data.GetLineSpan(y) : std::span<const uint8_t>(); }
+
   void WriteLine_N(e00::BitmapSizeType y, const std::span<uint8_t> &input, size_t size) override {
     auto dstLine = _data.GetLineSpan(y);
     if (size > dstLine.size()) {
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "PixelConvert.hpp"
+#include "PrivateInclude.hpp"
+
+#include <Engine/DefaultBitmapHelpers.hpp>
+
+namespace e00::impl::blit {
+using BitDepth = DrawableSurface::BitDepth;
+
+/**
+ * Everything a row kernel needs to know about the source and destination formats.
+ * Filled once per blit, then shared by every row.
+ */
+struct RowParams {
+  DrawableSurface::RGBInfo srcShift;
+  DrawableSurface::RGBInfo srcMask;
+  DrawableSurface::RGBInfo dstShift;
+  DrawableSurface::RGBInfo dstMask;
+
+  // 8-bit source only: the source palette already packed into the destination's raw format
+  const uint32_t *paletteRaw = nullptr;
+
+  // 8-bit destination only: the palette to match colours against
+  const FixedPalette *dstPalette = nullptr;
+};
+
+/**
+ * Converts `width` pixels from `src` (already offset to the first source pixel)
+ * into `dst` (already offset to the first destination pixel).
+ */
+using RowKernel = void (*)(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &params);
+
+template<typename Depth>
+void CopyRow(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &) {
+  std::memcpy(dst, src, width * sizeof(typename Depth::Type));
+}
+
+template<typename SrcDepth, typename DstDepth>
+void ConvertRow(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &params) {
+  using SrcType = typename SrcDepth::Type;
+  using DstType = typename DstDepth::Type;
+
+  for (size_t x = 0; x < width; ++x) {
+    SrcType raw;
+    std::memcpy(&raw, src + x * sizeof(SrcType), sizeof(SrcType));
+
+    const Color c{
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.red, params.srcMask.red),
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.green, params.srcMask.green),
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.blue, params.srcMask.blue)};
+
+    const DstType out = DstDepth::PackColor(c, params.dstShift, params.dstMask);
+    std::memcpy(dst + x * sizeof(DstType), &out, sizeof(DstType));
+  }
+}
+
+// RGB565 -> XRGB8888, both in their default layouts
+inline void Convert565To8888(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &) {
+  pixel::Rgb565ToXrgb8888(src, dst, width);
+}
+
+// XRGB8888 -> RGB565, both in their default layouts
+inline void Convert8888To565(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &) {
+  pixel::Xrgb8888ToRgb565(src, dst, width);
+}
+
+// XRGB8888 <-> XBGR8888
+inline void SwapRedBlue8888(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &) {
+  pixel::SwapRedBlue8888(src, dst, width);
+}
+
+// Indexed source: one table lookup per pixel, the palette was packed beforehand
+template<typename DstDepth>
+void ExpandPaletteRow(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &params) {
+  using DstType = typename DstDepth::Type;
+
+  if constexpr (sizeof(DstType) == sizeof(uint32_t)) {
+    pixel::ExpandIndexed32(src, dst, width, params.paletteRaw);
+  } else {
+    for (size_t x = 0; x < width; ++x) {
+      const auto out = static_cast<DstType>(params.paletteRaw[src[x]]);
+      std::memcpy(dst + x * sizeof(DstType), &out, sizeof(DstType));
+    }
+  }
+}
+
+// Indexed to indexed with different palettes: paletteRaw holds the destination index of every source index
+inline void RemapIndexedRow(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &params) {
+  for (size_t x = 0; x < width; ++x) {
+    dst[x] = static_cast<uint8_t>(params.paletteRaw[src[x]]);
+  }
+}
+
+// Direct colour source to an indexed destination
+template<typename SrcDepth>
+void MatchPaletteRow(const uint8_t *src, uint8_t *dst, size_t width, const RowParams &params) {
+  using SrcType = typename SrcDepth::Type;
+
+  for (size_t x = 0; x < width; ++x) {
+    SrcType raw;
+    std::memcpy(&raw, src + x * sizeof(SrcType), sizeof(SrcType));
+
+    const Color c{
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.red, params.srcMask.red),
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.green, params.srcMask.green),
+        helpers::ExtractAndScaleChannel(raw, params.srcShift.blue, params.srcMask.blue)};
+
+    dst[x] = params.dstPalette->findClosestColorIndex(c);
+  }
+}
+
+/**
+ * How the source and destination channel layouts relate, this decides between a plain copy,
+ * a hard-coded converter and the generic shift/mask converter.
+ */
+enum class LayoutMatch : uint8_t {
+  Identical,     // Same depth, same shifts and masks
+  DefaultLayouts,// Both sides use the helpers' default layout for their depth
+  Custom,        // Anything else
+};
+
+constexpr size_t DepthSlot(BitDepth depth) {
+  switch (depth) {
+    case BitDepth::DEPTH_8: return 0;
+    case BitDepth::DEPTH_16: return 1;
+    case BitDepth::DEPTH_32: return 2;
+    default: return 3;
+  }
+}
+
+using D8 = helpers::BitmapHelper_t<BitDepth::DEPTH_8>;
+using D16 = helpers::BitmapHelper_t<BitDepth::DEPTH_16>;
+using D32 = helpers::BitmapHelper_t<BitDepth::DEPTH_32>;
+
+using KernelsByLayout = std::array<RowKernel, 3>;
+
+// [source depth][destination depth][layout match]; 8 -> 8 depends on the palettes, the painter picks CopyRow or RemapIndexedRow
+constexpr std::array<std::array<KernelsByLayout, 3>, 3> RowKernels{{
+    // From 8-bit
+    {{
+        {nullptr, nullptr, nullptr},
+        {&ExpandPaletteRow<D16>, &ExpandPaletteRow<D16>, &ExpandPaletteRow<D16>},
+        {&ExpandPaletteRow<D32>, &ExpandPaletteRow<D32>, &ExpandPaletteRow<D32>},
+    }},
+    // From 16-bit
+    {{
+        {&MatchPaletteRow<D16>, &MatchPaletteRow<D16>, &MatchPaletteRow<D16>},
+        {&CopyRow<D16>, &ConvertRow<D16, D16>, &ConvertRow<D16, D16>},
+        {&ConvertRow<D16, D32>, &Convert565To8888, &ConvertRow<D16, D32>},
+    }},
+    // From 32-bit
+    {{
+        {&MatchPaletteRow<D32>, &MatchPaletteRow<D32>, &MatchPaletteRow<D32>},
+        {&ConvertRow<D32, D16>, &Convert8888To565, &ConvertRow<D32, D16>},
+        {&CopyRow<D32>, &ConvertRow<D32, D32>, &ConvertRow<D32, D32>},
+    }},
+}};
+
+inline bool IsDefaultLayout(const DrawableSurface::TargetInformation &format) {
+  switch (format.bit_depth) {
+    case BitDepth::DEPTH_16: return format.shift == D16::DefaultShift && format.mask == D16::DefaultMask;
+    case BitDepth::DEPTH_32: return format.shift == D32::DefaultShift && format.mask == D32::DefaultMask;
+    default: return true;
+  }
+}
+
+// XBGR8888, the default 32-bit layout with red and blue swapped
+inline bool IsSwappedLayout32(const DrawableSurface::TargetInformation &format) {
+  return format.bit_depth == BitDepth::DEPTH_32
+         && format.shift == DrawableSurface::RGBInfo{D32::DefaultShift.blue, D32::DefaultShift.green, D32::DefaultShift.red}
+         && format.mask == D32::DefaultMask;
+}
+
+/**
+ * Picks the row kernel converting from `src` to `dst`, or nullptr if there is none for this pair
+ */
+inline RowKernel SelectRowKernel(const DrawableSurface::TargetInformation &src, const DrawableSurface::TargetInformation &dst) {
+  const auto srcSlot = DepthSlot(src.bit_depth);
+  const auto dstSlot = DepthSlot(dst.bit_depth);
+  if (srcSlot >= RowKernels.size() || dstSlot >= RowKernels.size()) {
+    return nullptr;
+  }
+
+  // XRGB <-> XBGR only needs a swizzle
+  if (src.bit_depth == BitDepth::DEPTH_32 && dst.bit_depth == BitDepth::DEPTH_32
+      && ((IsDefaultLayout(src) && IsSwappedLayout32(dst)) || (IsSwappedLayout32(src) && IsDefaultLayout(dst)))) {
+    return &SwapRedBlue8888;
+  }
+
+  LayoutMatch match = LayoutMatch::Custom;
+  if (src.bit_depth == dst.bit_depth && src.shift == dst.shift && src.mask == dst.mask) {
+    match = LayoutMatch::Identical;
+  } else if (IsDefaultLayout(src) && IsDefaultLayout(dst)) {
+    match = LayoutMatch::DefaultLayouts;
+  }
+
+  return RowKernels[srcSlot][dstSlot][static_cast<size_t>(match)];
+}
+
+}// namespace e00::impl::blit
@@ -0,0 +1,115 @@
+#include "PrivateInclude.hpp"
+
+namespace e00 {
+BufferedStream::BufferedStream(std::unique_ptr<Stream> &&stream, size_t blockSize)
+    : Stream(stream->Size()),
+      _stream(std::move(stream)),
+      _buffer(std::max<size_t>(std::min(blockSize, _stream_size), 1)) {
+  _current_position = _stream->Position();
+}
+
+std::error_code BufferedStream::Fill(size_t position) {
+  _buffered = 0;
+
+  if (_stream->Position() != position) {
+    if (const auto ec = _stream->SeekTo(position)) {
+      return ec;
+    }
+  }
+
+  const auto size = std::min(_buffer.size(), _stream_size - position);
+  if (size == 0) {
+    return std::make_error_code(std::errc::io_error);
+  }
+
+  if (const auto ec = _stream->Read(size, _buffer.data())) {
+    return ec;
+  }
+
+  _buffer_position = position;
+  _buffered = size;
+  return {};
+}
+
+std::error_code BufferedStream::real_read(size_t size, void *data) {
+  auto *out = static_cast<uint8_t *>(data);
+  size_t position = _current_position;
+
+  // What the buffer already has
+  if (position >= _buffer_position && position < _buffer_position + _buffered) {
+    const auto offset = position - _buffer_position;
+    const auto count = std::min(size, _buffered - offset);
+    std::memcpy(out, _buffer.data() + offset, count);
+    out += count;
+    position += count;
+    size -= count;
+  }
+
+  if (size == 0) {
+    return {};
+  }
+
+  // Large reads go straight to the stream, copying them through the buffer gains nothing
+  if (size >= _buffer.size()) {
+    if (_stream->Position() != position) {
+      if (const auto ec = _stream->SeekTo(position)) {
+        return ec;
+      }
+    }
+    return _stream->Read(size, out);
+  }
+
+  if (const auto ec = Fill(position)) {
+    return ec;
+  }
+
+  std::memcpy(out, _buffer.data(), size);
+  return {};
+}
+
+std::span<const uint8_t> BufferedStream::real_peek(size_t size) {
+  // A stream in memory doesn't need the buffer
+  if (const auto mapped = Stream::real_peek(size); mapped.size() == size) {
+    return mapped;
+  }
+
+  if (size > _buffer.size() || size > AvailableToRead()) {
+    return {};
+  }
+
+  if (!InBuffer(size) && Fill(_current_position)) {
+    return {};
+  }
+
+  return std::span<const uint8_t>(_buffer).subspan(_current_position - _buffer_position, size);
+}
+
+std::error_code BufferedStream::ReadUntil(char delimiter, std::string &out) {
+  out.clear();
+  if (AtEnd()) {
+    return std::make_error_code(std::errc::io_error);
+  }
+
+  while (!AtEnd()) {
+    if (!InBuffer(1)) {
+      if (const auto ec = Fill(_current_position)) {
+        return ec;
+      }
+    }
+
+    const auto *start = reinterpret_cast<const char *>(_buffer.data()) + (_current_position - _buffer_position);
+    const auto length = _buffer_position + _buffered - _current_position;
+    if (const auto *found = static_cast<const char *>(std::memchr(start, delimiter, length))) {
+      const auto lineLength = static_cast<size_t>(found - start);
+      out.append(start, lineLength);
+      _current_position += lineLength + 1;
+      return {};
+    }
+
+    out.append(start, length);
+    _current_position += length;
+  }
+
+  return {};
+}
+}// namespace e00
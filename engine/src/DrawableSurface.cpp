@@ -3,6 +3,15 @@
 namespace e00 {
 DrawableSurface::~DrawableSurface() = default;
 
+void DrawableSurface::ReadLinesInto(
+    BitmapSizeType firstLine, BitmapSizeType lineCount,
+    BitmapSizeType startX, BitmapSizeType endX,
+    const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer, size_t targetStride) const {
+  for (BitmapSizeType i = 0; i < lineCount; ++i) {
+    ReadLineInto(firstLine + i, startX, endX, targetInformation, targetBuffer.subspan(i * targetStride));
+  }
+}
+
 std::error_code DrawableSurface::SaveToBMP(WritableStream &writableStream) const {
   constexpr std::array magic = {'B', 'M'};
   const auto bitDepth = GetBitDepth();
@@ -100,7 +109,7 @@ std::error_code DrawableSurface::SaveToBMP(WritableStream &writableStream) const
   if (bitDepth == BitDepth::DEPTH_8) {
     tempPalette.resize(GetNumberOfColorsInPalette());
     for (size_t i = 0; i < tempPalette.size(); ++i) {
-      tempPalette[i] = GetColorFromPalette(i);
+      tempPalette.set(i, GetColorFromPalette(i));
     }
     targetInfo.palette = &tempPalette;
   }
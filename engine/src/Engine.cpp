@@ -77,28 +77,111 @@ bool Engine::IsPaused() const noexcept {
 }
 
 std::error_code Engine::LoadWorld(const std::string &world_name) {
-  if (_current_world) {
-    // TODO: _script_engine->call<...>("world_unload")
-    OnWorldUnload(_current_world);
-    _current_world.reset();
-  }
-
   GetDefaultLogger().Verbose(source_location::current(), "Loading world: {}", world_name);
 
+  // Whatever was prefetched is either done or needed now
   auto &resource_manager = ResourceManager::GlobalResourceManager();
+  if (_prefetch_world_name == world_name) {
+    resource_manager.WaitForAsyncLoads();
+  }
+
   auto map = resource_manager.LoadResourceDirectly<Map>(HashName(world_name), DiscardPalette{});
+  ClearPrefetch();
   if (!map) {
     GetDefaultLogger().Error(source_location::current(), "Failed to load map {}", world_name);
     return std::make_error_code(std::errc::invalid_argument);
   }
 
+  SwitchWorld(world_name, std::move(map));
+  return {};
+}
+
+std::error_code Engine::PrefetchWorld(const std::string &world_name) {
+  if (_prefetch_world_name == world_name) {
+    return {};
+  }
+
+  ClearPrefetch();
+  GetDefaultLogger().Verbose(source_location::current(), "Prefetching world: {}", world_name);
+
+  auto &resource_manager = ResourceManager::GlobalResourceManager();
+  for (const auto &dependency: resource_manager.DependenciesOf({HashName(world_name), type_id<Map>()})) {
+    if (auto prefetched = resource_manager.Prefetch(dependency)) {
+      _prefetch_dependencies.push_back(std::move(prefetched));
+    }
+  }
+
+  _prefetch_world_name = world_name;
+  UpdatePrefetch();
+  return {};
+}
+
+std::error_code Engine::LoadWorldAsync(const std::string &world_name) {
+  GetDefaultLogger().Verbose(source_location::current(), "Loading world in the background: {}", world_name);
+
+  if (const auto ec = PrefetchWorld(world_name)) {
+    return ec;
+  }
+
+  _switch_when_prefetched = true;
+  return {};
+}
+
+void Engine::SwitchWorld(const std::string &world_name, ResourcePtrT<Map> &&map) {
+  if (_current_world) {
+    // TODO: _script_engine->call<...>("world_unload")
+    OnWorldUnload(_current_world);
+    _current_world.reset();
+  }
+
   _current_world = std::make_unique<World>(world_name);
   std::ignore = _current_world->AddMap(std::move(map));
 
   GetDefaultLogger().Verbose(source_location::current(), "World loaded: {}", world_name);
   OnWorldLoaded(_current_world);
+}
 
-  return {};
+void Engine::UpdatePrefetch() {
+  if (_prefetch_world_name.empty()) {
+    return;
+  }
+
+  // The map's loader finds its dependencies loaded only if it starts after them
+  if (!_prefetch_map) {
+    if (std::ranges::any_of(_prefetch_dependencies, [](const ResourcePtrT<Resource> &dependency) {
+          return dependency.EnsureLoad() == std::errc::resource_unavailable_try_again;
+        })) {
+      return;
+    }
+
+    _prefetch_map = ResourceManager::GlobalResourceManager().LoadResourceAsync<Map>(HashName(_prefetch_world_name), DiscardPalette{});
+  }
+
+  const auto ec = _prefetch_map.EnsureLoad();
+  if (ec == std::errc::resource_unavailable_try_again) {
+    return;
+  }
+
+  if (ec) {
+    GetDefaultLogger().Error(source_location::current(), "Failed to load map {}: {}", _prefetch_world_name, ec.message());
+    ClearPrefetch();
+    return;
+  }
+
+  // Loaded; kept until the game asks for the world
+  if (_switch_when_prefetched) {
+    const auto world_name = std::move(_prefetch_world_name);
+    auto map = std::move(_prefetch_map);
+    ClearPrefetch();
+    SwitchWorld(world_name, std::move(map));
+  }
+}
+
+void Engine::ClearPrefetch() {
+  _prefetch_world_name.clear();
+  _prefetch_dependencies.clear();
+  _prefetch_map = nullptr;
+  _switch_when_prefetched = false;
 }
 
 void Engine::Tick(const std::chrono::milliseconds &delta) noexcept {
@@ -114,8 +197,15 @@ void Engine::Tick(const std::chrono::milliseconds &delta) noexcept {
       }
       _current_game_time += delta;
 
+      UpdatePrefetch();
       if (_current_world) {
-        //
+        // Broad phase collision; what overlapping means is up to the game
+        _overlaps.clear();
+        if (!_current_world->FindOverlaps(_overlaps).empty()) {
+          OnActorsOverlap(*_current_world, _overlaps);
+        }
+
+        _current_world->Paths().Process(detail::PathSearchBudgetPerTick);
       }
 
       ExecuteActionsAtTime(Now());
@@ -25,6 +25,7 @@ void LabelWidget::SetText(std::string text) {
 
   _text = std::move(text);
   UpdateMinimumSize();
+  Invalidate();
 }
 
 void LabelWidget::SetFont(Font &font) {
@@ -34,6 +35,25 @@ void LabelWidget::SetFont(Font &font) {
 
   _font = &font;
   UpdateMinimumSize();
+  Invalidate();
+}
+
+void LabelWidget::SetForegroundColor(const Color &color) {
+  if (_foreground_color == color) {
+    return;
+  }
+
+  _foreground_color = color;
+  Invalidate();
+}
+
+void LabelWidget::SetBackgroundColor(const Color &color) {
+  if (_background_color == color) {
+    return;
+  }
+
+  _background_color = color;
+  Invalidate();
 }
 
 Font &LabelWidget::GetFont() const noexcept {
@@ -15,6 +15,8 @@ Widget::Widget()
       _rect(RectT<SIZE_TYPE>::maxArea()),
       _min(Vec2D<SIZE_TYPE>::min()),
       _max(Vec2D<SIZE_TYPE>::max()) {
+  // Nothing was ever painted
+  Invalidate();
 }
 
 Widget::Widget(std::string name)
@@ -23,6 +25,7 @@ Widget::Widget(std::string name)
       _rect(RectT<SIZE_TYPE>::maxArea()),
       _min(Vec2D<SIZE_TYPE>::min()),
       _max(Vec2D<SIZE_TYPE>::max()) {
+  Invalidate();
 }
 
 Widget::~Widget() {
@@ -60,9 +63,11 @@ Widget *Widget::AddChild(OwnedWidgetPtrT child) {
   }
 
   child->_parent = this;
+  child->_dirty_rects.clear();
   auto ref = child.get();
   _children.emplace_back(std::move(child));
   ResizeEvent();
+  ref->Invalidate();
 
   return ref;
 }
@@ -76,6 +81,9 @@ Widget::OwnedWidgetPtrT Widget::RemoveChild(Widget *child) {
     return nullptr;
   }
 
+  // Uncover whatever was under the child
+  (*it)->Invalidate();
+
   auto removed = std::move(*it);
   _children.erase(it);
   removed->_parent = nullptr;
@@ -85,6 +93,10 @@ Widget::OwnedWidgetPtrT Widget::RemoveChild(Widget *child) {
 }
 
 void Widget::ClearChildren() {
+  if (!_children.empty()) {
+    Invalidate();
+  }
+
   for (auto &child: _children) {
     child->_parent = nullptr;
   }
@@ -137,8 +149,10 @@ void Widget::Move(const Vec2D<SIZE_TYPE> &position) {
     return;
   }
 
+  Invalidate();
   _rect.origin = position;
   ResizeEvent();
+  Invalidate();
 }
 
 void Widget::Resize(const Vec2D<SIZE_TYPE> &size) {
@@ -156,10 +170,12 @@ void Widget::Resize(const Vec2D<SIZE_TYPE> &size) {
 
   // Check if the size has actually changed
   if (new_size != _rect.size) {
+    Invalidate();
     _rect.size = new_size;
 
     // Inform all children about this event
     ResizeEvent();
+    Invalidate();
   }
 }
 
@@ -264,6 +280,91 @@ Widget::ActionProcessResult Widget::ProcessAction(const ActionInstance &action)
   return ret;
 }
 
+Widget *Widget::Root() {
+  auto *root = this;
+  while (root->_parent) {
+    root = root->_parent;
+  }
+  return root;
+}
+
+void Widget::Invalidate() {
+  Invalidate(AbsoluteComputedRect());
+}
+
+void Widget::Invalidate(const RectT<SIZE_TYPE> &absoluteRect) {
+  Root()->AddDirtyRect(absoluteRect);
+}
+
+void Widget::AddDirtyRect(RectT<SIZE_TYPE> rect) {
+  if (!rect.isValid()) {
+    return;
+  }
+
+  const auto touches = [](const RectT<SIZE_TYPE> &a, const RectT<SIZE_TYPE> &b) {
+    return a.origin.x <= b.origin.x + b.size.x && b.origin.x <= a.origin.x + a.size.x
+           && a.origin.y <= b.origin.y + b.size.y && b.origin.y <= a.origin.y + a.size.y;
+  };
+
+  // Swallow every rect this one touches; the merged rect may now touch others, so start over
+  for (auto it = _dirty_rects.begin(); it != _dirty_rects.end();) {
+    if (touches(*it, rect)) {
+      rect = rect.Unite(*it);
+      _dirty_rects.erase(it);
+      it = _dirty_rects.begin();
+    } else {
+      ++it;
+    }
+  }
+
+  _dirty_rects.push_back(rect);
+
+  // Too many small areas, repaint their bounding rect instead
+  if (_dirty_rects.size() > MAX_DIRTY_RECTS) {
+    auto bounds = _dirty_rects.front();
+    for (const auto &r: _dirty_rects) {
+      bounds = bounds.Unite(r);
+    }
+    _dirty_rects.assign(1, bounds);
+  }
+}
+
+void Widget::SetAlwaysRepaint(bool alwaysRepaint) {
+  _always_repaint = alwaysRepaint;
+  Invalidate();
+}
+
+void Widget::CollectAlwaysRepaint(std::vector<RectT<SIZE_TYPE>> &rects) const {
+  if (_always_repaint) {
+    rects.push_back(AbsoluteComputedRect());
+    return;
+  }
+
+  for (const auto &child: _children) {
+    child->CollectAlwaysRepaint(rects);
+  }
+}
+
+std::vector<RectT<Widget::SIZE_TYPE>> Widget::TakeDirtyRects() {
+  std::vector<RectT<SIZE_TYPE>> alwaysRepaint;
+  CollectAlwaysRepaint(alwaysRepaint);
+  for (const auto &rect: alwaysRepaint) {
+    AddDirtyRect(rect);
+  }
+
+  return std::exchange(_dirty_rects, {});
+}
+
+void Widget::PaintDirtyRects(Painter &painterObj, std::span<const RectT<SIZE_TYPE>> rects) {
+  for (const auto &rect: rects) {
+    painterObj.PushClip(rect);
+    if (!painterObj.IsFullyClipped()) {
+      Paint(painterObj);
+    }
+    painterObj.PopClip();
+  }
+}
+
 void Widget::Paint(Painter &painterObj) {
   const auto paintRect = AbsoluteComputedRect();
 
@@ -274,8 +375,13 @@ void Widget::Paint(Painter &painterObj) {
   } else if (_background_type == BackgroundType::Image) {
   }
 
+  // Children can't draw outside of their own area, and have nothing to draw if it's entirely clipped
   for (auto &child: _children) {
-    child->Paint(painterObj);
+    painterObj.PushClip(child->AbsoluteComputedRect());
+    if (!painterObj.IsFullyClipped()) {
+      child->Paint(painterObj);
+    }
+    painterObj.PopClip();
   }
 }
 
@@ -1,5 +1,7 @@
 #include <Engine.hpp>
 
+#include <cstring>
+
 namespace {
 template<typename T>
 constexpr T computeStartForCenter(const T &center, const T &wanted, const T &max) {
@@ -14,41 +16,152 @@ constexpr T computeStartForCenter(const T &center, const T &wanted, const T &max
 
   return center - half;
 }
+
+bool sameFormat(const e00::DrawableSurface::TargetInformation &lhs, const e00::DrawableSurface::TargetInformation &rhs) {
+  return lhs.bit_depth == rhs.bit_depth && lhs.palette == rhs.palette && lhs.shift == rhs.shift && lhs.mask == rhs.mask;
+}
+
+// Moves the content of `bitmap` by (-dx, -dy): the pixel at (dx, dy) ends up at (0, 0)
+void scrollPixels(e00::Bitmap &bitmap, long dx, long dy) {
+  const auto size = bitmap.Size();
+  const size_t bytesPerPixel = e00::DepthEnumToBits(bitmap.GetBitDepth()) / 8;
+  const size_t rowBytes = static_cast<size_t>(size.x - std::abs(dx)) * bytesPerPixel;
+  const size_t srcOffset = dx > 0 ? static_cast<size_t>(dx) * bytesPerPixel : 0;
+  const size_t dstOffset = dx < 0 ? static_cast<size_t>(-dx) * bytesPerPixel : 0;
+
+  const auto moveRow = [&](long y) {
+    const auto src = bitmap.GetLineData(static_cast<e00::BitmapSizeType>(y + dy));
+    const auto dst = bitmap.GetLineData(static_cast<e00::BitmapSizeType>(y));
+    std::memmove(dst.data() + dstOffset, src.data() + srcOffset, rowBytes);
+  };
+
+  // Walk away from the rows being read so none is overwritten before it's moved
+  if (dy >= 0) {
+    for (long y = 0; y < size.y - dy; ++y) moveRow(y);
+  } else {
+    for (long y = size.y - 1; y >= -dy; --y) moveRow(y);
+  }
+}
 }// namespace
 
 namespace e00 {
 WorldWidget::WorldWidget(const std::unique_ptr<World> &worldToDraw) : _worldToDraw(worldToDraw) {
+  // Actors and the map change without telling the widget
+  SetAlwaysRepaint(true);
 }
 
-void WorldWidget::DrawWorld(Painter &painter, const World &world) {
-  const auto tile_size = world.TileSize();
+void WorldWidget::UpdateScrollBuffer(const DrawableSurface::TargetInformation &format, Map &map, const Vec2D<uint32_t> &worldOrigin, const Vec2D<BitmapSizeType> &size) {
+  const auto paletteRevision = format.palette ? format.palette->revision() : 0;
+  bool repaintAll = !_scroll.pixels
+                    || _scroll.pixels->Size() != size
+                    || _scroll.map != &map
+                    || _scroll.mapRevision != map.Revision()
+                    || !sameFormat(_scroll.format, format)
+                    || _scroll.paletteRevision != paletteRevision;
 
-  // Compute the ## of tiles needed
-  const auto worldSizeInTiles = Size() / tile_size;
+  if (repaintAll) {
+    // The buffer is reused unless it can't hold the view anymore
+    if (!_scroll.pixels || _scroll.pixels->Size() != size || _scroll.pixels->GetBitDepth() != format.bit_depth) {
+      const bool indexed = format.bit_depth == DrawableSurface::BitDepth::DEPTH_8;
+      _scroll.pixels = Bitmap::Create(size, format.bit_depth, indexed ? static_cast<int>(format.palette->size()) : 0);
+      if (!_scroll.pixels) {
+        return;
+      }
+    }
 
-  // Adjust the "viewport"; do not go over the map
-  const Vec2D adjSize(worldSizeInTiles.Clamp(world.Size()));
+    if (format.bit_depth == DrawableSurface::BitDepth::DEPTH_8) {
+      _scroll.pixels->SetPalette(*format.palette);
+    }
 
-  // Compute window
-  const Vec2D start = {
-      computeStartForCenter(_cameraCenter.x, adjSize.x, world.Width()),
-      computeStartForCenter(_cameraCenter.y, adjSize.y, world.Height())};
+    _scroll.map = &map;
+    _scroll.mapRevision = map.Revision();
+    _scroll.format = format;
+    _scroll.paletteRevision = paletteRevision;
+  }
 
-  for (WorldCoordinateType y = 0; y < adjSize.y; y++) {
-    for (WorldCoordinateType x = 0; x < adjSize.x; x++) {
-      const Vec2D tilePos = {x, y};
-      const auto drawPosition = AbsolutePosition() + tilePos * tile_size;
+  const long dx = static_cast<long>(worldOrigin.x) - static_cast<long>(_scroll.worldOrigin.x);
+  const long dy = static_cast<long>(worldOrigin.y) - static_cast<long>(_scroll.worldOrigin.y);
+  _scroll.worldOrigin = worldOrigin;
 
-      world.PaintTile(start + tilePos, painter, drawPosition);
-    }
+  if (!repaintAll && dx == 0 && dy == 0) {
+    return;
+  }
+
+  const auto painter = _scroll.pixels->BeginDraw();
+  painter->SetNoPen();
+  painter->SetBrushColor({0, 0, 0});
+
+  // Paints buffer area `rect` from the map; empty tiles leave black behind
+  const auto repaint = [&](const RectT<BitmapSizeType> &rect) {
+    painter->DrawRect(rect);
+    map.PaintRegion({worldOrigin.x + rect.origin.x, worldOrigin.y + rect.origin.y}, rect.size, *painter, rect.origin);
+  };
+
+  if (repaintAll || std::abs(dx) >= size.x || std::abs(dy) >= size.y) {
+    repaint({{0, 0}, size});
+    return;
   }
-}
 
-void WorldWidget::ResizeEvent() {
-  Widget::ResizeEvent();
-  // TODO: Cache worldSizeInTiles
+  // Keep what's still visible, then fill in the strips the camera uncovered
+  scrollPixels(*_scroll.pixels, dx, dy);
+
+  if (dx > 0) {
+    repaint({static_cast<BitmapSizeType>(size.x - dx), 0, static_cast<BitmapSizeType>(dx), size.y});
+  } else if (dx < 0) {
+    repaint({0, 0, static_cast<BitmapSizeType>(-dx), size.y});
+  }
+
+  if (dy > 0) {
+    repaint({0, static_cast<BitmapSizeType>(size.y - dy), size.x, static_cast<BitmapSizeType>(dy)});
+  } else if (dy < 0) {
+    repaint({0, 0, size.x, static_cast<BitmapSizeType>(-dy)});
+  }
 }
 
+void WorldWidget::DrawWorld(Painter &painter, const World &world) {
+  auto *map = world.Map().get();
+  if (!map) {
+    return;
+  }
+
+  const Vec2D<uint32_t> tileSize{map->TileSize().x, map->TileSize().y};
+  if (tileSize.x == 0 || tileSize.y == 0) {
+    return;
+  }
+
+  const Vec2D<uint32_t> worldPixels{world.Width() * tileSize.x, world.Height() * tileSize.y};
+
+  if (_cameraFollowsTile) {
+    _cameraCenterPixels = {_cameraCenter.x * tileSize.x + tileSize.x / 2, _cameraCenter.y * tileSize.y + tileSize.y / 2};
+  } else {
+    _cameraCenter = {static_cast<uint16_t>(_cameraCenterPixels.x / tileSize.x), static_cast<uint16_t>(_cameraCenterPixels.y / tileSize.y)};
+  }
+
+  // Adjust the "viewport"; do not go over the map
+  const Vec2D<BitmapSizeType> viewSize{
+      static_cast<BitmapSizeType>(std::min<uint32_t>(Size().x, worldPixels.x)),
+      static_cast<BitmapSizeType>(std::min<uint32_t>(Size().y, worldPixels.y))};
+
+  // Compute window, in pixels
+  const Vec2D<uint32_t> origin = {
+      computeStartForCenter<uint32_t>(_cameraCenterPixels.x, viewSize.x, worldPixels.x),
+      computeStartForCenter<uint32_t>(_cameraCenterPixels.y, viewSize.y, worldPixels.y)};
+
+  // Formats we can't keep a copy in get painted directly
+  const auto format = painter.TargetFormat();
+  const bool canBuffer = (format.bit_depth == DrawableSurface::BitDepth::DEPTH_8 && format.palette)
+                         || format.bit_depth == DrawableSurface::BitDepth::DEPTH_16
+                         || format.bit_depth == DrawableSurface::BitDepth::DEPTH_32;
+  if (!canBuffer) {
+    map->PaintRegion(origin, viewSize, painter, AbsolutePosition());
+    return;
+  }
+
+  UpdateScrollBuffer(format, *map, origin, viewSize);
+  if (_scroll.pixels) {
+    painter.DrawSurface(*_scroll.pixels, {{0, 0}, viewSize}, AbsolutePosition());
+  }
+}
 
 void WorldWidget::Paint(Painter &painterObj) {
   if (_worldToDraw) {
@@ -0,0 +1,317 @@
+#include "PngFilters.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define E00_PNG_FILTERS_SSE2
+#include <emmintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define E00_PNG_FILTERS_AVX2
+#include <immintrin.h>
+#define E00_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace e00::impl::png {
+namespace {
+
+/******************************************************************************
+ *
+ * Scalar, used everywhere and for what the vector versions don't handle
+ *
+ *****************************************************************************/
+
+uint8_t PaethPredictor(uint8_t left, uint8_t above, uint8_t upperLeft) {
+  const int p = static_cast<int>(left) + static_cast<int>(above) - static_cast<int>(upperLeft);
+  const int pa = std::abs(p - static_cast<int>(left));
+  const int pb = std::abs(p - static_cast<int>(above));
+  const int pc = std::abs(p - static_cast<int>(upperLeft));
+
+  if (pa <= pb && pa <= pc) {
+    return left;
+  }
+
+  if (pb <= pc) {
+    return above;
+  }
+
+  return upperLeft;
+}
+
+void UnfilterSub_Scalar(uint8_t *row, size_t rowBytes, size_t bytesPerPixel) {
+  for (size_t x = bytesPerPixel; x < rowBytes; ++x) {
+    row[x] = static_cast<uint8_t>(row[x] + row[x - bytesPerPixel]);
+  }
+}
+
+void UnfilterUp_Scalar(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  for (size_t x = 0; x < rowBytes; ++x) {
+    row[x] = static_cast<uint8_t>(row[x] + previousRow[x]);
+  }
+}
+
+void UnfilterAverage_Scalar(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  for (size_t x = 0; x < rowBytes; ++x) {
+    const auto left = x >= bytesPerPixel ? row[x - bytesPerPixel] : uint8_t{0};
+    row[x] = static_cast<uint8_t>(row[x] + ((static_cast<uint16_t>(left) + previousRow[x]) / 2));
+  }
+}
+
+void UnfilterPaeth_Scalar(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  for (size_t x = 0; x < rowBytes; ++x) {
+    const auto left = x >= bytesPerPixel ? row[x - bytesPerPixel] : uint8_t{0};
+    const auto upperLeft = x >= bytesPerPixel ? previousRow[x - bytesPerPixel] : uint8_t{0};
+    row[x] = static_cast<uint8_t>(row[x] + PaethPredictor(left, previousRow[x], upperLeft));
+  }
+}
+
+#ifdef E00_PNG_FILTERS_SSE2
+/******************************************************************************
+ *
+ * SSE2, always available on x86-64
+ *
+ * Sub, Average and Paeth depend on the pixel on the left, so they can't go wider than a pixel:
+ * every byte of a pixel is done at once instead. Rows are whole pixels, except for sub-byte
+ * depths which never get here.
+ *
+ *****************************************************************************/
+
+template<size_t Bpp>
+__m128i LoadPixel(const uint8_t *p) {
+  uint64_t v = 0;
+  std::memcpy(&v, p, Bpp);
+  return _mm_cvtsi64_si128(static_cast<long long>(v));
+}
+
+template<size_t Bpp>
+void StorePixel(uint8_t *p, __m128i v) {
+  const auto bits = static_cast<uint64_t>(_mm_cvtsi128_si64(v));
+  std::memcpy(p, &bits, Bpp);
+}
+
+template<size_t Bpp>
+void SubPixels_SSE2(uint8_t *row, size_t rowBytes) {
+  __m128i left = _mm_setzero_si128();
+  for (size_t x = 0; x + Bpp <= rowBytes; x += Bpp) {
+    left = _mm_add_epi8(LoadPixel<Bpp>(row + x), left);
+    StorePixel<Bpp>(row + x, left);
+  }
+}
+
+void UnfilterUp_SSE2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  size_t x = 0;
+  for (; x + 16 <= rowBytes; x += 16) {
+    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+    const __m128i above = _mm_loadu_si128(reinterpret_cast<const __m128i *>(previousRow + x));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), _mm_add_epi8(current, above));
+  }
+  UnfilterUp_Scalar(row + x, previousRow + x, rowBytes - x);
+}
+
+template<size_t Bpp>
+void AveragePixels_SSE2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i left = _mm_setzero_si128();
+  for (size_t x = 0; x + Bpp <= rowBytes; x += Bpp) {
+    const __m128i above = LoadPixel<Bpp>(previousRow + x);
+
+    // avg_epu8 rounds up, the filter rounds down
+    const __m128i average = _mm_sub_epi8(_mm_avg_epu8(left, above), _mm_and_si128(_mm_xor_si128(left, above), one));
+    left = _mm_add_epi8(LoadPixel<Bpp>(row + x), average);
+    StorePixel<Bpp>(row + x, left);
+  }
+}
+
+__m128i Abs16(__m128i v) {
+  return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+__m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+template<size_t Bpp>
+void PaethPixels_SSE2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  // Worked on as 16-bit lanes so the differences don't overflow
+  const __m128i zero = _mm_setzero_si128();
+  __m128i left = zero;
+  __m128i upperLeft = zero;
+  for (size_t x = 0; x + Bpp <= rowBytes; x += Bpp) {
+    const __m128i above = _mm_unpacklo_epi8(LoadPixel<Bpp>(previousRow + x), zero);
+
+    // p = left + above - upperLeft, so p - left = above - upperLeft and p - above = left - upperLeft
+    const __m128i aboveDelta = _mm_sub_epi16(above, upperLeft);
+    const __m128i leftDelta = _mm_sub_epi16(left, upperLeft);
+    const __m128i pa = Abs16(aboveDelta);
+    const __m128i pb = Abs16(leftDelta);
+    const __m128i pc = Abs16(_mm_add_epi16(aboveDelta, leftDelta));
+    const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+    // Ties go to left, then above
+    const __m128i predictor = Select(_mm_cmpeq_epi16(smallest, pa), left, Select(_mm_cmpeq_epi16(smallest, pb), above, upperLeft));
+
+    const __m128i current = _mm_add_epi8(LoadPixel<Bpp>(row + x), _mm_packus_epi16(predictor, zero));
+    StorePixel<Bpp>(row + x, current);
+
+    left = _mm_unpacklo_epi8(current, zero);
+    upperLeft = above;
+  }
+}
+
+template<template<size_t> typename Kernel, typename... Args>
+bool DispatchByPixelSize(size_t bytesPerPixel, Args... args) {
+  switch (bytesPerPixel) {
+    case 2: Kernel<2>::Run(args...); return true;
+    case 3: Kernel<3>::Run(args...); return true;
+    case 4: Kernel<4>::Run(args...); return true;
+    case 6: Kernel<6>::Run(args...); return true;
+    case 8: Kernel<8>::Run(args...); return true;
+    default: return false;
+  }
+}
+
+template<size_t Bpp>
+struct SubKernel {
+  static void Run(uint8_t *row, size_t rowBytes) { SubPixels_SSE2<Bpp>(row, rowBytes); }
+};
+
+template<size_t Bpp>
+struct AverageKernel {
+  static void Run(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) { AveragePixels_SSE2<Bpp>(row, previousRow, rowBytes); }
+};
+
+template<size_t Bpp>
+struct PaethKernel {
+  static void Run(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) { PaethPixels_SSE2<Bpp>(row, previousRow, rowBytes); }
+};
+
+void UnfilterSub_SSE2(uint8_t *row, size_t rowBytes, size_t bytesPerPixel) {
+  if (!DispatchByPixelSize<SubKernel>(bytesPerPixel, row, rowBytes)) {
+    UnfilterSub_Scalar(row, rowBytes, bytesPerPixel);
+  }
+}
+
+void UnfilterAverage_SSE2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  if (!DispatchByPixelSize<AverageKernel>(bytesPerPixel, row, previousRow, rowBytes)) {
+    UnfilterAverage_Scalar(row, previousRow, rowBytes, bytesPerPixel);
+  }
+}
+
+void UnfilterPaeth_SSE2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  if (!DispatchByPixelSize<PaethKernel>(bytesPerPixel, row, previousRow, rowBytes)) {
+    UnfilterPaeth_Scalar(row, previousRow, rowBytes, bytesPerPixel);
+  }
+}
+#endif
+
+#ifdef E00_PNG_FILTERS_AVX2
+/******************************************************************************
+ *
+ * AVX2, only used when the CPU reports it
+ *
+ * Up goes 32 bytes at a time. Paeth still works a pixel at a time, but gets the SSSE3 absolute
+ * value and the SSE4.1 blend that come with AVX2. Sub and Average have nothing to gain and keep
+ * using SSE2.
+ *
+ *****************************************************************************/
+
+E00_TARGET_AVX2 void UnfilterUp_AVX2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  size_t x = 0;
+  for (; x + 32 <= rowBytes; x += 32) {
+    const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + x));
+    const __m256i above = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(previousRow + x));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + x), _mm256_add_epi8(current, above));
+  }
+  UnfilterUp_SSE2(row + x, previousRow + x, rowBytes - x);
+}
+
+template<size_t Bpp>
+E00_TARGET_AVX2 void PaethPixels_AVX2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i left = zero;
+  __m128i upperLeft = zero;
+  for (size_t x = 0; x + Bpp <= rowBytes; x += Bpp) {
+    const __m128i above = _mm_unpacklo_epi8(LoadPixel<Bpp>(previousRow + x), zero);
+
+    const __m128i aboveDelta = _mm_sub_epi16(above, upperLeft);
+    const __m128i leftDelta = _mm_sub_epi16(left, upperLeft);
+    const __m128i pa = _mm_abs_epi16(aboveDelta);
+    const __m128i pb = _mm_abs_epi16(leftDelta);
+    const __m128i pc = _mm_abs_epi16(_mm_add_epi16(aboveDelta, leftDelta));
+    const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+    // Ties go to left, then above
+    const __m128i predictor = _mm_blendv_epi8(_mm_blendv_epi8(upperLeft, above, _mm_cmpeq_epi16(smallest, pb)), left, _mm_cmpeq_epi16(smallest, pa));
+
+    const __m128i current = _mm_add_epi8(LoadPixel<Bpp>(row + x), _mm_packus_epi16(predictor, zero));
+    StorePixel<Bpp>(row + x, current);
+
+    left = _mm_unpacklo_epi8(current, zero);
+    upperLeft = above;
+  }
+}
+
+template<size_t Bpp>
+struct PaethKernel_AVX2 {
+  static void Run(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) { PaethPixels_AVX2<Bpp>(row, previousRow, rowBytes); }
+};
+
+void UnfilterPaeth_AVX2(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  if (!DispatchByPixelSize<PaethKernel_AVX2>(bytesPerPixel, row, previousRow, rowBytes)) {
+    UnfilterPaeth_Scalar(row, previousRow, rowBytes, bytesPerPixel);
+  }
+}
+#endif
+
+/******************************************************************************
+ *
+ * Dispatch
+ *
+ *****************************************************************************/
+
+struct Kernels {
+  void (*sub)(uint8_t *, size_t, size_t);
+  void (*up)(uint8_t *, const uint8_t *, size_t);
+  void (*average)(uint8_t *, const uint8_t *, size_t, size_t);
+  void (*paeth)(uint8_t *, const uint8_t *, size_t, size_t);
+};
+
+Kernels SelectKernels() {
+#ifdef E00_PNG_FILTERS_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return {&UnfilterSub_SSE2, &UnfilterUp_AVX2, &UnfilterAverage_SSE2, &UnfilterPaeth_AVX2};
+  }
+#endif
+
+#ifdef E00_PNG_FILTERS_SSE2
+  return {&UnfilterSub_SSE2, &UnfilterUp_SSE2, &UnfilterAverage_SSE2, &UnfilterPaeth_SSE2};
+#else
+  return {&UnfilterSub_Scalar, &UnfilterUp_Scalar, &UnfilterAverage_Scalar, &UnfilterPaeth_Scalar};
+#endif
+}
+
+const Kernels &ActiveKernels() {
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+}// namespace
+
+void UnfilterSub(uint8_t *row, size_t rowBytes, size_t bytesPerPixel) {
+  ActiveKernels().sub(row, rowBytes, bytesPerPixel);
+}
+
+void UnfilterUp(uint8_t *row, const uint8_t *previousRow, size_t rowBytes) {
+  ActiveKernels().up(row, previousRow, rowBytes);
+}
+
+void UnfilterAverage(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  ActiveKernels().average(row, previousRow, rowBytes, bytesPerPixel);
+}
+
+void UnfilterPaeth(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel) {
+  ActiveKernels().paeth(row, previousRow, rowBytes, bytesPerPixel);
+}
+
+}// namespace e00::impl::png
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace e00::impl::png {
+/**
+ * Undo the PNG row filters, in place.
+ *
+ * `row` is the filtered row without its filter byte, `previousRow` the row above it already unfiltered
+ * (zeroes for the first row of an image or of an interlace pass), `bytesPerPixel` the distance to the
+ * same byte of the pixel on the left, rounded up to 1.
+ *
+ * On x86-64 the versions are picked once, from what the CPU supports: Up is done 32 bytes at a time
+ * with AVX2 or 16 with SSE2, the others a pixel at a time when pixels are 2 to 8 bytes (Paeth with
+ * AVX2 when available, SSE2 otherwise). Every other case, and every other target (including the i386
+ * DOS build), uses the portable scalar versions.
+ */
+void UnfilterSub(uint8_t *row, size_t rowBytes, size_t bytesPerPixel);
+void UnfilterUp(uint8_t *row, const uint8_t *previousRow, size_t rowBytes);
+void UnfilterAverage(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel);
+void UnfilterPaeth(uint8_t *row, const uint8_t *previousRow, size_t rowBytes, size_t bytesPerPixel);
+
+}// namespace e00::impl::png
@@ -1,6 +1,7 @@
 
 #include "PngLoader.hpp"
 #include "BitmapData.hpp"
+#include "PngFilters.hpp"
 
 #ifdef DJGPP
 typedef int off_t;
@@ -18,25 +19,189 @@ constexpr uint32_t GetTypeInt32(std::array<uint8_t, 4> c) {
   return c[0] | (c[1] << 8) | (c[2] << 16) | (c[3] << 24);
 }
 
-e00::DrawableSurface::BitDepth GetBitDepth(uint8_t bitDepth) {
-  switch (bitDepth) {
-    case 1: return e00::Bitmap::BitDepth::DEPTH_1;
-    case 8: return e00::Bitmap::BitDepth::DEPTH_8;
-    case 16: return e00::Bitmap::BitDepth::DEPTH_16;
-    case 32: return e00::Bitmap::BitDepth::DEPTH_32;
+// Rows are converted into the bitmap's format: 8 bits per pixel or 32-bit XRGB
+using RowConverter = void (*)(const uint8_t *row, uint8_t *out, size_t width, uint8_t bitDepth);
+
+void CopyRow(const uint8_t *row, uint8_t *out, size_t width, uint8_t) {
+  std::memcpy(out, row, width);
+}
+
+// 1, 2 and 4 bit samples, packed from the most significant bit
+void UnpackRow(const uint8_t *row, uint8_t *out, size_t width, uint8_t bitDepth) {
+  const auto mask = static_cast<uint8_t>((1u << bitDepth) - 1);
+  for (size_t x = 0, bit = 0; x < width; ++x, bit += bitDepth) {
+    out[x] = static_cast<uint8_t>(row[bit / 8] >> (8 - bitDepth - bit % 8)) & mask;
+  }
+}
+
+// 16-bit samples are big endian, the high byte is kept
+void HighBytesRow(const uint8_t *row, uint8_t *out, size_t width, uint8_t) {
+  for (size_t x = 0; x < width; ++x) {
+    out[x] = row[x * 2];
+  }
+}
+
+constexpr size_t Opaque = std::numeric_limits<size_t>::max();
+
+/**
+ * Samples of a pixel `Stride` bytes apart into XRGB, the alpha (when there is one) going in the unused byte
+ *
+ * @tparam R, G, B, A offset of the (high byte of the) channels in the pixel, A is `Opaque` when there is no alpha
+ */
+template<size_t Stride, size_t R, size_t G, size_t B, size_t A>
+void XrgbRow(const uint8_t *row, uint8_t *out, size_t width, uint8_t) {
+  for (size_t x = 0; x < width; ++x, row += Stride, out += 4) {
+    const uint32_t alpha = A == Opaque ? 0xFF : row[A];
+    const uint32_t pixel = (alpha << 24) | (uint32_t{row[R]} << 16) | (uint32_t{row[G]} << 8) | row[B];
+    std::memcpy(out, &pixel, sizeof(pixel));
+  }
+}
+
+/**
+ * How the samples of the image are laid out, and what they become
+ */
+struct PNGFormat {
+  uint8_t colorType = 0;
+  uint8_t bitDepth = 0;
+  size_t bitsPerPixel = 0;
+
+  e00::Bitmap::BitDepth target = e00::Bitmap::BitDepth::DEPTH_INVALID;
+  size_t targetBytesPerPixel = 0;
+  RowConverter convert = nullptr;
+
+  [[nodiscard]] bool IsIndexed() const { return colorType == 3; }
+  [[nodiscard]] bool IsGrey() const { return colorType == 0; }
+
+  // Distance between a byte and the same byte of the pixel on its left, for the filters
+  [[nodiscard]] size_t FilterBytesPerPixel() const { return std::max<size_t>(1, bitsPerPixel / 8); }
+  [[nodiscard]] size_t RowBytes(size_t width) const { return (width * bitsPerPixel + 7) / 8; }
+};
+
+/**
+ * Indexed and greyscale images become 8-bit bitmaps, the others 32-bit ones
+ *
+ * @return the format, with an invalid target if the colour type and bit depth can't go together
+ */
+PNGFormat GetFormat(uint8_t colorType, uint8_t bitDepth) {
+  PNGFormat format{.colorType = colorType, .bitDepth = bitDepth};
+  const bool wide = bitDepth == 16;
+
+  const auto indexed = [&](size_t channels, RowConverter convert) {
+    format.bitsPerPixel = channels * bitDepth;
+    format.target = e00::Bitmap::BitDepth::DEPTH_8;
+    format.targetBytesPerPixel = 1;
+    format.convert = convert;
+  };
+  const auto xrgb = [&](size_t channels, RowConverter convert, RowConverter wideConvert) {
+    format.bitsPerPixel = channels * bitDepth;
+    format.target = e00::Bitmap::BitDepth::DEPTH_32;
+    format.targetBytesPerPixel = 4;
+    format.convert = wide ? wideConvert : convert;
+  };
+
+  switch (colorType) {
+    case 0:
+      // Greyscale
+      if (bitDepth == 1 || bitDepth == 2 || bitDepth == 4) indexed(1, UnpackRow);
+      else if (bitDepth == 8) indexed(1, CopyRow);
+      else if (wide) indexed(1, HighBytesRow);
+      break;
+
+    case 2:
+      // Truecolour
+      if (bitDepth == 8 || wide) xrgb(3, XrgbRow<3, 0, 1, 2, Opaque>, XrgbRow<6, 0, 2, 4, Opaque>);
+      break;
+
+    case 3:
+      // Indexed
+      if (bitDepth == 1 || bitDepth == 2 || bitDepth == 4) indexed(1, UnpackRow);
+      else if (bitDepth == 8) indexed(1, CopyRow);
+      break;
+
+    case 4:
+      // Greyscale with alpha
+      if (bitDepth == 8 || wide) xrgb(2, XrgbRow<2, 0, 0, 0, 1>, XrgbRow<4, 0, 0, 0, 2>);
+      break;
+
+    case 6:
+      // Truecolour with alpha
+      if (bitDepth == 8 || wide) xrgb(4, XrgbRow<4, 0, 1, 2, 3>, XrgbRow<8, 0, 2, 4, 6>);
+      break;
+
     default: break;
   }
 
-  return e00::DrawableSurface::BitDepth::DEPTH_INVALID;
+  return format;
+}
+
+// Greyscale images index a ramp of as many greys as the samples allow, 16-bit ones their high byte
+e00::FixedPalette GreyPalette(uint8_t bitDepth) {
+  const size_t levels = size_t{1} << std::min<uint8_t>(bitDepth, 8);
+  e00::FixedPalette greys(levels);
+  for (size_t i = 0; i < levels; ++i) {
+    const auto grey = static_cast<uint8_t>(i * 255 / (levels - 1));
+    greys.set(i, e00::Color(grey, grey, grey));
+  }
+  return greys;
 }
 
+/**
+ * A pass of the image: the pixels from (startX, startY), every stepX columns and every stepY lines
+ */
+struct PNGPass {
+  uint8_t startX;
+  uint8_t startY;
+  uint8_t stepX;
+  uint8_t stepY;
+};
+
+constexpr std::array<PNGPass, 1> SinglePass{{{0, 0, 1, 1}}};
+constexpr std::array<PNGPass, 7> Adam7Passes{{
+    {0, 0, 8, 8},
+    {4, 0, 8, 8},
+    {0, 4, 4, 8},
+    {2, 0, 4, 4},
+    {0, 2, 2, 4},
+    {1, 0, 2, 2},
+    {0, 1, 1, 2},
+}};
+
+/**
+ * Decoding state: inflated data goes into the current row, which is unfiltered and written to the
+ * bitmap as soon as it is complete. Only that row and the previous one are kept.
+ *
+ * Interlaced images are made of 7 smaller images (passes), one after the other, whose pixels are
+ * scattered over the bitmap.
+ */
 struct PNGContext {
   z_stream strm;
   bool initialized = false;
-
-  std::vector<uint8_t> decompressedData;
-
-  PNGContext() : strm{} {
+  bool ended = false;// The zlib stream is complete
+
+  e00::Bitmap &bitmap;
+  PNGFormat format;
+  std::span<const PNGPass> passes;
+
+  // Both rows start with their filter byte; previousRow is already unfiltered, zeroes before the first row of a pass
+  std::vector<uint8_t> currentRow;
+  std::vector<uint8_t> previousRow;
+  std::vector<uint8_t> convertedRow;// Interlaced only: the pixels of the row, before they are scattered
+  size_t rowFill = 0;
+
+  size_t pass = 0;
+  size_t passWidth = 0;
+  size_t passHeight = 0;
+  size_t passRowBytes = 0;
+  size_t passRow = 0;
+
+  PNGContext(e00::Bitmap &target, const PNGFormat &png_format, bool interlaced)
+      : strm{},
+        bitmap(target),
+        format(png_format),
+        passes(interlaced ? std::span<const PNGPass>(Adam7Passes) : std::span<const PNGPass>(SinglePass)),
+        currentRow(png_format.RowBytes(target.Size().x) + 1),
+        previousRow(currentRow.size()),
+        convertedRow(interlaced ? target.Size().x * png_format.targetBytesPerPixel : 0) {
     strm.zalloc = nullptr;
     strm.zfree = nullptr;
     strm.opaque = nullptr;
@@ -47,6 +212,8 @@ struct PNGContext {
     } else {
       e00::GetDefaultLogger().Error(e00::source_location::current(), "inflateInit failed with error {}", res);
     }
+
+    StartPass();
   }
 
   ~PNGContext() {
@@ -54,6 +221,32 @@ struct PNGContext {
       inflateEnd(&strm);
     }
   }
+
+  PNGContext(const PNGContext &) = delete;
+  PNGContext &operator=(const PNGContext &) = delete;
+
+  // Moves to the next pass with pixels, small images leave some passes empty
+  void StartPass() {
+    const auto size = bitmap.Size();
+    for (; pass < passes.size(); ++pass) {
+      const auto &p = passes[pass];
+      passWidth = size.x > p.startX ? static_cast<size_t>((size.x - p.startX + p.stepX - 1) / p.stepX) : 0;
+      passHeight = size.y > p.startY ? static_cast<size_t>((size.y - p.startY + p.stepY - 1) / p.stepY) : 0;
+      if (passWidth > 0 && passHeight > 0) {
+        break;
+      }
+    }
+
+    passRowBytes = format.RowBytes(passWidth);
+    passRow = 0;
+    rowFill = 0;
+    std::fill(previousRow.begin(), previousRow.end(), uint8_t{0});
+  }
+
+  // Size of a row of the current pass, filter byte included
+  [[nodiscard]] size_t RowSize() const { return passRowBytes + 1; }
+
+  [[nodiscard]] bool Complete() const { return pass >= passes.size(); }
 };
 
 struct PNGChunk {
@@ -67,8 +260,9 @@ struct PNGChunk {
     return {reinterpret_cast<const char *>(type.data()), 4};
   }
 
+  // Chunks may be empty, IEND always is
   explicit operator bool() const {
-    return crc != 0 && size > 0;
+    return crc != 0;
   }
 
   std::error_code skip(e00::Stream &stream) const {
@@ -120,9 +314,16 @@ uint32_t ReadPNGUint32(e00::Stream &stream) {
   return 0;
 }
 
-PNGChunk ReadChunk(e00::Stream &stream) {
+uint32_t UpdateCRC(uint32_t crc, std::span<const uint8_t> data) {
   static std::array<uint32_t, 256> pngCrcTable = GenerateCRCTable();
 
+  for (const auto byte: data) {
+    crc = (crc >> 8) ^ pngCrcTable[(crc ^ byte) & 0xFF];
+  }
+  return crc;
+}
+
+PNGChunk ReadChunk(e00::Stream &stream) {
   PNGChunk chunk{};
 
   chunk.size = ReadPNGUint32(stream);
@@ -137,26 +338,30 @@ PNGChunk ReadChunk(e00::Stream &stream) {
   uint32_t crc = 0xFFFFFFFF;// Initialize with all bits set
 
   // Add the type to the CRC check
-  crc = (crc >> 8) ^ pngCrcTable[(crc ^ chunk.type[0]) & 0xFF];
-  crc = (crc >> 8) ^ pngCrcTable[(crc ^ chunk.type[1]) & 0xFF];
-  crc = (crc >> 8) ^ pngCrcTable[(crc ^ chunk.type[2]) & 0xFF];
-  crc = (crc >> 8) ^ pngCrcTable[(crc ^ chunk.type[3]) & 0xFF];
-
-  // Read data bits
-  static constexpr size_t CRC_BUF_SIZE = 4096;
-  std::array<uint8_t, CRC_BUF_SIZE> crcBuffer{};
-  size_t remaining = chunk.size;
-  while (remaining > 0) {
-    const size_t toRead = std::min(remaining, CRC_BUF_SIZE);
-    if (const auto ec = stream.Read(toRead, crcBuffer.data())) {
-      e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to read PNG chunk data for CRC: {}", ec.message());
+  crc = UpdateCRC(crc, chunk.type);
+
+  if (const auto data = stream.Peek(chunk.size); data.size() == chunk.size) {
+    // In memory: checked in place
+    crc = UpdateCRC(crc, data);
+    if (const auto ec = stream.SeekTo(chunk.streamDataPositon + chunk.size)) {
+      e00::GetDefaultLogger().Error(e00::source_location::current(), "PNG chunk data is truncated: {}", ec.message());
       return {};
     }
+  } else {
+    // Read data bits
+    static constexpr size_t CRC_BUF_SIZE = 4096;
+    std::array<uint8_t, CRC_BUF_SIZE> crcBuffer{};
+    size_t remaining = chunk.size;
+    while (remaining > 0) {
+      const size_t toRead = std::min(remaining, CRC_BUF_SIZE);
+      if (const auto ec = stream.Read(toRead, crcBuffer.data())) {
+        e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to read PNG chunk data for CRC: {}", ec.message());
+        return {};
+      }
 
-    for (size_t i = 0; i < toRead; ++i) {
-      crc = (crc >> 8) ^ pngCrcTable[(crc ^ crcBuffer[i]) & 0xFF];
+      crc = UpdateCRC(crc, std::span(crcBuffer.data(), toRead));
+      remaining -= toRead;
     }
-    remaining -= toRead;
   }
 
   // Read the CRC
@@ -189,45 +394,116 @@ std::error_code ProcessPLTEData(e00::Stream &stream, e00::Bitmap &bitmap, const
 
   e00::FixedPalette colors(size / 3u);
 
-  for (auto &color: colors) {
-    if (const auto ec = stream.Read(color.red)) return ec;
-    if (const auto ec = stream.Read(color.green)) return ec;
-    if (const auto ec = stream.Read(color.blue)) return ec;
+  for (size_t i = 0; i < colors.size(); ++i) {
+    std::array<uint8_t, 3> rgb{};
+    if (const auto ec = stream.Read(rgb)) return ec;
+    colors.set(i, e00::Color(rgb[0], rgb[1], rgb[2]));
   }
 
   bitmap.SetPalette(colors);
   return {};
 }
 
-std::error_code ProcessIDATData(e00::Stream &stream, PNGContext &context, const uint32_t size) {
-  if (!context.initialized) {
-    return std::make_error_code(std::errc::not_enough_memory);
-  }
+/**
+ * Undoes the filter of a row in place
+ *
+ * @param filterType the filter byte of the row
+ * @param row the row, without its filter byte
+ * @param previousRow the row above, already unfiltered (zeroes for the first row)
+ * @param bytesPerPixel distance to the corresponding byte of the pixel on the left
+ */
+std::error_code UnfilterRow(uint8_t filterType, std::span<uint8_t> row, std::span<const uint8_t> previousRow, size_t bytesPerPixel) {
+  switch (filterType) {
+    case 0:
+      // None
+      break;
+
+    case 1:
+      e00::impl::png::UnfilterSub(row.data(), row.size(), bytesPerPixel);
+      break;
+
+    case 2:
+      e00::impl::png::UnfilterUp(row.data(), previousRow.data(), row.size());
+      break;
+
+    case 3:
+      e00::impl::png::UnfilterAverage(row.data(), previousRow.data(), row.size(), bytesPerPixel);
+      break;
+
+    case 4:
+      e00::impl::png::UnfilterPaeth(row.data(), previousRow.data(), row.size(), bytesPerPixel);
+      break;
+
+    default:
+      e00::GetDefaultLogger().Error(
+          e00::source_location::current(),
+          "Unsupported PNG filter type {}",
+          static_cast<int>(filterType));
 
-  std::vector<uint8_t> compressedData;
-  try {
-    compressedData.resize(size);
-  } catch (const std::bad_alloc &) {
-    e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to allocate {} bytes for IDAT chunk", size);
-    return std::make_error_code(std::errc::not_enough_memory);
+      return std::make_error_code(std::errc::invalid_argument);
   }
 
-  if (const auto ec = stream.Read(compressedData)) {
-    e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to read IDAT chunk: {} (requested {} bytes, available {} bytes)", ec.message(), size, stream.AvailableToRead());
+  return {};
+}
+
+// The current row is complete: unfilter it, write its pixels to the bitmap and make it the previous row
+std::error_code FinishRow(PNGContext &context) {
+  const std::span row(context.currentRow.data() + 1, context.passRowBytes);
+  const std::span previousRow(context.previousRow.data() + 1, context.passRowBytes);
+  if (const auto ec = UnfilterRow(context.currentRow[0], row, previousRow, context.format.FilterBytesPerPixel())) {
     return ec;
   }
 
+  const auto &pass = context.passes[context.pass];
+  const auto y = static_cast<e00::BitmapSizeType>(pass.startY + context.passRow * pass.stepY);
+  const auto line = context.bitmap.GetLineData(y);
+  if (pass.stepX == 1) {
+    context.format.convert(row.data(), line.data(), context.passWidth, context.format.bitDepth);
+  } else {
+    const auto pixelSize = context.format.targetBytesPerPixel;
+    context.format.convert(row.data(), context.convertedRow.data(), context.passWidth, context.format.bitDepth);
+    for (size_t i = 0; i < context.passWidth; ++i) {
+      std::memcpy(line.data() + (pass.startX + i * pass.stepX) * pixelSize, context.convertedRow.data() + i * pixelSize, pixelSize);
+    }
+  }
+
+  context.currentRow.swap(context.previousRow);
+  context.rowFill = 0;
+  if (++context.passRow == context.passHeight) {
+    ++context.pass;
+    context.StartPass();
+  }
+  return {};
+}
+
+/**
+ * Inflates a piece of the image data straight into the current row, finishing rows as they fill up
+ */
+std::error_code Inflate(PNGContext &context, std::span<const uint8_t> compressedData) {
+  // zlib doesn't write to its input
   context.strm.avail_in = static_cast<uInt>(compressedData.size());
-  context.strm.next_in = compressedData.data();
+  context.strm.next_in = const_cast<Bytef *>(compressedData.data());
 
-  std::array<uint8_t, 4096> outputBuffer{};
+  // Anything after the last row is dropped
+  std::array<uint8_t, 64> overflow{};
 
-  do {
-    context.strm.avail_out = static_cast<uInt>(outputBuffer.size());
-    context.strm.next_out = outputBuffer.data();
+  while (context.strm.avail_in > 0 && !context.ended) {
+    const bool rowsLeft = !context.Complete();
+    if (rowsLeft) {
+      context.strm.next_out = context.currentRow.data() + context.rowFill;
+      context.strm.avail_out = static_cast<uInt>(context.RowSize() - context.rowFill);
+    } else {
+      context.strm.next_out = overflow.data();
+      context.strm.avail_out = static_cast<uInt>(overflow.size());
+    }
 
-    if (const auto result = inflate(&context.strm, Z_NO_FLUSH);
-        result < 0 && result != Z_BUF_ERROR) {
+    const auto result = inflate(&context.strm, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      context.ended = true;
+    } else if (result == Z_BUF_ERROR) {
+      // No progress possible
+      break;
+    } else if (result != Z_OK) {
       e00::GetDefaultLogger().Error(e00::source_location::current(), "Inflate error: {} (code {})", context.strm.msg ? context.strm.msg : "unknown", result);
 
       context.strm.next_out = nullptr;
@@ -236,15 +512,17 @@ std::error_code ProcessIDATData(e00::Stream &stream, PNGContext &context, const
       return std::make_error_code(std::errc::invalid_argument);
     }
 
-    const auto produced = outputBuffer.size() - context.strm.avail_out;
-    context.decompressedData.insert(
-        context.decompressedData.end(),
-        outputBuffer.begin(),
-        outputBuffer.begin() + static_cast<std::ptrdiff_t>(produced));
-
-  } while (context.strm.avail_out == 0);
+    if (rowsLeft) {
+      context.rowFill = context.RowSize() - context.strm.avail_out;
+      if (context.rowFill == context.RowSize()) {
+        if (const auto ec = FinishRow(context)) {
+          return ec;
+        }
+      }
+    }
+  }
 
-  if (context.strm.avail_in != 0) {
+  if (context.strm.avail_in != 0 && !context.ended) {
     e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to inflate all IDAT data ({} bytes remaining)", context.strm.avail_in);
     return std::make_error_code(std::errc::invalid_argument);
   }
@@ -254,113 +532,36 @@ std::error_code ProcessIDATData(e00::Stream &stream, PNGContext &context, const
 
   return {};
 }
-// ... existing code ...
-uint8_t PaethPredictor(uint8_t left, uint8_t above, uint8_t upperLeft) {
-  const int p = static_cast<int>(left) + static_cast<int>(above) - static_cast<int>(upperLeft);
-  const int pa = std::abs(p - static_cast<int>(left));
-  const int pb = std::abs(p - static_cast<int>(above));
-  const int pc = std::abs(p - static_cast<int>(upperLeft));
 
-  if (pa <= pb && pa <= pc) {
-    return left;
+std::error_code ProcessIDATData(e00::Stream &stream, PNGContext &context, const uint32_t size) {
+  if (!context.initialized) {
+    return std::make_error_code(std::errc::not_enough_memory);
   }
 
-  if (pb <= pc) {
-    return above;
+  // In memory: inflated in place
+  if (const auto data = stream.Peek(size); data.size() == size) {
+    return Inflate(context, data);
   }
 
-  return upperLeft;
-}
-
-std::error_code ApplyPNGFiltersToBitmap(const PNGContext &context, e00::Bitmap &bitmap) {
-  const auto size = bitmap.Size();
-  const auto rowBytes = static_cast<size_t>(size.x);
-  const auto expectedSize = static_cast<size_t>(size.y) * (rowBytes + 1);
-
-  if (context.decompressedData.size() < expectedSize) {
-    e00::GetDefaultLogger().Error(
-        e00::source_location::current(),
-        "PNG decompressed data too small: got {}, expected at least {}",
-        context.decompressedData.size(),
-        expectedSize);
-
-    return std::make_error_code(std::errc::invalid_argument);
-  }
-
-  std::vector<uint8_t> previousRow(rowBytes, 0);
-  std::vector<uint8_t> currentRow(rowBytes, 0);
-
-  size_t srcOffset = 0;
-
-  for (e00::BitmapSizeType y = 0; y < size.y; ++y) {
-    constexpr size_t bytesPerPixel = 1;
-    const auto filterType = context.decompressedData[srcOffset++];
-
-    std::copy_n(
-        context.decompressedData.data() + srcOffset,
-        rowBytes,
-        currentRow.data());
-
-    srcOffset += rowBytes;
-
-    switch (filterType) {
-      case 0:
-        // None
-        break;
-
-      case 1:
-        // Sub
-        for (size_t x = 0; x < rowBytes; ++x) {
-          const auto left = x >= bytesPerPixel ? currentRow[x - bytesPerPixel] : uint8_t{0};
-          currentRow[x] = static_cast<uint8_t>(currentRow[x] + left);
-        }
-        break;
-
-      case 2:
-        // Up
-        for (size_t x = 0; x < rowBytes; ++x) {
-          currentRow[x] = static_cast<uint8_t>(currentRow[x] + previousRow[x]);
-        }
-        break;
-
-      case 3:
-        // Average
-        for (size_t x = 0; x < rowBytes; ++x) {
-          const auto left = x >= bytesPerPixel ? currentRow[x - bytesPerPixel] : uint8_t{0};
-          const auto above = previousRow[x];
-          currentRow[x] = static_cast<uint8_t>(currentRow[x] + ((static_cast<uint16_t>(left) + above) / 2));
-        }
-        break;
-
-      case 4:
-        // Paeth
-        for (size_t x = 0; x < rowBytes; ++x) {
-          const auto left = x >= bytesPerPixel ? currentRow[x - bytesPerPixel] : uint8_t{0};
-          const auto above = previousRow[x];
-          const auto upperLeft = x >= bytesPerPixel ? previousRow[x - bytesPerPixel] : uint8_t{0};
-          currentRow[x] = static_cast<uint8_t>(currentRow[x] + PaethPredictor(left, above, upperLeft));
-        }
-        break;
-
-      default:
-        e00::GetDefaultLogger().Error(
-            e00::source_location::current(),
-            "Unsupported PNG filter type {}",
-            static_cast<int>(filterType));
-
-        return std::make_error_code(std::errc::invalid_argument);
+  // Otherwise a piece at a time, rather than a copy of the whole chunk
+  std::array<uint8_t, 4096> inputBuffer{};
+  size_t remaining = size;
+  while (remaining > 0) {
+    const size_t toRead = std::min(remaining, inputBuffer.size());
+    if (const auto ec = stream.Read(toRead, inputBuffer.data())) {
+      e00::GetDefaultLogger().Error(e00::source_location::current(), "Failed to read IDAT chunk: {} (requested {} bytes, available {} bytes)", ec.message(), toRead, stream.AvailableToRead());
+      return ec;
     }
 
-    bitmap.WriteLine_N(y, currentRow, rowBytes);
-
-    previousRow.swap(currentRow);
-    std::ranges::fill(currentRow, uint8_t{0});
+    if (const auto ec = Inflate(context, std::span(inputBuffer.data(), toRead))) {
+      return ec;
+    }
+    remaining -= toRead;
   }
 
   return {};
 }
 
-
 }// namespace
 
 namespace e00::impl {
@@ -454,25 +655,41 @@ ResourceLoader::Result PNGLoader::ReadLoad(const LoadContext &context) {
 
   if (const auto ec = IHDR.skip(context.stream)) return ec;
 
-  // TODO: Support other formats
-  if (colorType != 3 || bitDepth != 8) {
-    GetDefaultLogger().Error(source_location::current(), "Unsupported PNG format (for now)");
+  if (compressionType != 0 || filterMethod != 0 || interlaceMethod > 1) {
+    GetDefaultLogger().Error(source_location::current(), "Unknown PNG compression {}, filter method {} or interlacing {}",
+                             static_cast<int>(compressionType), static_cast<int>(filterMethod), static_cast<int>(interlaceMethod));
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+
+  const auto format = GetFormat(colorType, bitDepth);
+  if (format.target == Bitmap::BitDepth::DEPTH_INVALID) {
+    GetDefaultLogger().Error(source_location::current(), "Invalid PNG bit depth {} for colour type {}", static_cast<int>(bitDepth), static_cast<int>(colorType));
     return std::make_error_code(std::errc::invalid_argument);
   }
 
-  // png state
-  PNGContext png_context;
+  // make the bitmap that will hold the data, indexed images get their palette from PLTE
+  const Vec2D<BitmapSizeType> size(width, height);
+  auto bitmapData = format.IsGrey()
+                        ? Bitmap::Create(size, format.target, GreyPalette(bitDepth))
+                        : Bitmap::Create(size, format.target);
 
-  // make the bitmap that will hold the data
-  auto bitmapData = Bitmap::Create(
-      Vec2D<BitmapSizeType>(width, height),
-      GetBitDepth(bitDepth));
+  // png state, rows are decoded straight into the bitmap
+  PNGContext png_context(*bitmapData, format, interlaceMethod == 1);
 
   // Read the chunks
   while (!context.stream.AtEnd()) {
     if (const auto chunk = ReadChunk(context.stream)) {
+      if (chunk.TypeAsInt32() == GetTypeInt32('I', 'E', 'N', 'D')) {
+        break;
+      }
+
       switch (chunk.TypeAsInt32()) {
         case GetTypeInt32('P', 'L', 'T', 'E'):
+          // Only a suggestion for truecolour images, the bitmap has no palette
+          if (!format.IsIndexed()) {
+            GetDefaultLogger().Info(source_location::current(), "Skipping suggested PNG palette");
+            break;
+          }
           if (const auto ec = ProcessPLTEData(context.stream, *bitmapData, chunk.size)) {
             GetDefaultLogger().Error(source_location::current(), "Failed to process PLTE chunk: {}", ec.message());
             return ec;
@@ -495,18 +712,14 @@ ResourceLoader::Result PNGLoader::ReadLoad(const LoadContext &context) {
         return ec;
       }
     } else {
-      // This might be valid for IEND
-      if (chunk.TypeAsInt32() == GetTypeInt32('I', 'E', 'N', 'D')) {
-        break;
-      }
       GetDefaultLogger().Error(source_location::current(), "Failed to read PNG chunk");
       return std::make_error_code(std::errc::invalid_argument);
     }
   }
 
-  if (const auto ec = ApplyPNGFiltersToBitmap(png_context, *bitmapData)) {
-    GetDefaultLogger().Error(source_location::current(), "Failed to apply PNG filters: {}", ec.message());
-    return ec;
+  if (!png_context.Complete()) {
+    GetDefaultLogger().Error(source_location::current(), "PNG image data ended at row {} of pass {}", png_context.passRow, png_context.pass);
+    return std::make_error_code(std::errc::invalid_argument);
   }
 
   // Need to discard the palette if it was loaded
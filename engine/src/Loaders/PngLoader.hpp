@@ -6,6 +6,9 @@ namespace e00::impl {
 
 /**
  * Class PNGLoader
+ *
+ * Loads every colour type and bit depth, interlaced or not. Indexed and greyscale images become 8-bit
+ * bitmaps (16-bit greys are cut to 8), the others 32-bit ones with their alpha in the top byte.
  */
 class PNGLoader : public ResourceLoader {
 public:
@@ -6,24 +6,69 @@ constexpr std::array<std::uint8_t, 6> GIF87a = {0x47, 0x49, 0x46, 0x38, 0x37, 0x
 constexpr std::array<std::uint8_t, 6> GIF89a = {0x47, 0x49, 0x46, 0x38, 0x39, 0x61};
 constexpr auto LOGICAL_SCREEN_DESCRIPTOR_SIZE = 7;
 
-// Helper class to read bits from the compressed data
+// Helper class to read bits from the compressed data, straight out of the sub-blocks of the stream
 class BitStreamReader {
-  const std::vector<uint8_t> &data_;
+  e00::Stream &stream_;
+  std::array<uint8_t, 255> buffer_{};// Sub-block being read, for streams that aren't in memory
+  std::span<const uint8_t> block_;
+  size_t peeked_;// Bytes of block_ still ahead of the stream position, skipped once the block is read
   size_t byte_pos_;
   int bit_pos_;
+  bool ended_;// The empty sub-block ending the data was read
+  bool failed_;
+
+  // Moves to the next sub-block once this one is read, false at the end of the data
+  bool NextBlock() {
+    while (!ended_ && byte_pos_ >= block_.size()) {
+      // Peeked bytes are only valid until the stream moves, so move past them once they are read
+      if (peeked_ > 0) {
+        if (stream_.SeekTo(stream_.Position() + peeked_)) {
+          failed_ = ended_ = true;
+          break;
+        }
+        peeked_ = 0;
+      }
+
+      uint8_t blockSize = 0;
+      if (stream_.Read(blockSize)) {
+        failed_ = ended_ = true;
+        break;
+      }
+
+      if (blockSize == 0) {
+        ended_ = true;
+        break;
+      }
+
+      if (const auto data = stream_.Peek(blockSize); data.size() == blockSize) {
+        // In memory: no copy
+        block_ = data;
+        peeked_ = blockSize;
+      } else {
+        if (stream_.Read(blockSize, buffer_.data())) {
+          failed_ = ended_ = true;
+          break;
+        }
+        block_ = std::span<const uint8_t>(buffer_.data(), blockSize);
+      }
+      byte_pos_ = 0;
+    }
+
+    return byte_pos_ < block_.size();
+  }
 
 public:
-  explicit BitStreamReader(const std::vector<uint8_t> &data)
-      : data_(data), byte_pos_(0), bit_pos_(0) {}
+  explicit BitStreamReader(e00::Stream &stream)
+      : stream_(stream), peeked_(0), byte_pos_(0), bit_pos_(0), ended_(false), failed_(false) {}
 
   // Read the next 'num_bits' bits as an integer
   uint16_t ReadBits(const int num_bits) {
     uint16_t value = 0;
     for (int i = 0; i < num_bits; ++i) {
-      if (byte_pos_ >= data_.size()) {
+      if (!NextBlock()) {
         throw std::runtime_error("Unexpected end of data");
       }
-      const uint8_t current_byte = data_[byte_pos_];
+      const uint8_t current_byte = block_[byte_pos_];
       const uint8_t bit = (current_byte >> bit_pos_) & 1;
       value |= (bit << i);
       ++bit_pos_;
@@ -35,8 +80,19 @@ public:
     return value;
   }
 
-  [[nodiscard]] bool EndOfStream() const {
-    return byte_pos_ >= data_.size();
+  [[nodiscard]] bool EndOfStream() {
+    return !NextBlock();
+  }
+
+  // Skips what is left of the data, the stream ends up after it
+  void SkipToEnd() {
+    while (NextBlock()) {
+      byte_pos_ = block_.size();
+    }
+  }
+
+  [[nodiscard]] bool Failed() const {
+    return failed_;
   }
 };
 
@@ -95,13 +151,13 @@ struct GifContext {
 };
 
 // Helper function: Decode LZW compressed data
-std::vector<uint8_t> LZWDecompress(const std::vector<uint8_t> &compressedData, const uint8_t minCodeSize) {
+std::vector<uint8_t> LZWDecompress(BitStreamReader &bitReader, const uint8_t minCodeSize, const size_t expectedSize) {
   std::vector<uint8_t> output;
   if (minCodeSize < 2 || minCodeSize > 8) {
     throw std::invalid_argument("Invalid minimum code size");
   }
 
-  BitStreamReader bitReader(compressedData);
+  output.reserve(expectedSize);
 
   // Initialize the dictionary
   const int clearCode = 1 << minCodeSize;
@@ -235,7 +291,7 @@ std::error_code ReadPalette(e00::Stream &stream, const uint32_t numColors, e00::
         return ec;
       }
 
-      output[i] = e00::Color(raw_palette[0], raw_palette[1], raw_palette[2]);
+      output.set(static_cast<size_t>(i), e00::Color(raw_palette[0], raw_palette[1], raw_palette[2]));
     }
   }
 
@@ -492,38 +548,6 @@ std::error_code ReadImageDescriptor(e00::Stream &stream, GifImageContext &image)
   return {};
 }
 
-/**
- * Read the LZW data from the GIF stream
- * 
- * @param stream the stream to read from
- * @return the read data, empty if there is an error
- */
-std::vector<uint8_t> ReadCompressedImageData(e00::Stream &stream) {
-  std::vector<uint8_t> compressedData;
-  while (true) {
-    uint8_t blockSize = 0;
-    // Read the block size
-    if (stream.Read(blockSize)) {
-      return {};
-    }
-
-    // End of LZW data (blockSize == 0 signifies the end of image data)
-    if (blockSize == 0) {
-      break;
-    }
-
-    std::vector<uint8_t> blockData(blockSize);
-    if (stream.Read(blockData)) {
-      return {};
-    }
-
-    // Append the block data to the compressed data
-    compressedData.insert(compressedData.end(), blockData.begin(), blockData.end());
-  }
-
-  return compressedData;
-}
-
 /**
  * 
  * @param stream the GIF file
@@ -547,14 +571,15 @@ std::error_code ReadImage(e00::Stream &stream, GifContext &context, const std::u
 
   std::vector<uint8_t> decompressedData;
 
-  /* Make sure compressed data is scoped very tight to free the data */
   {
-    // Step 3: Read LZW image data blocks
-    const auto compressedData = ReadCompressedImageData(stream);
+    // Step 3 and 4: Decompress the LZW data as its blocks are read
+    BitStreamReader bitReader(stream);
+    decompressedData = LZWDecompress(bitReader, lzwMinCodeSize, static_cast<size_t>(imageContext.dirtyRect.size.Area()));
 
-    // Step 4: Decompress the LZW data
-    // Handle LZW decompression (utilize a dedicated LZW decompression function)
-    decompressedData = LZWDecompress(compressedData, lzwMinCodeSize);
+    bitReader.SkipToEnd();
+    if (bitReader.Failed()) {
+      return std::make_error_code(std::errc::io_error);
+    }
   }
 
   // Step 5: Apply interlacing if necessary
@@ -2,6 +2,7 @@
 #include "EngineError.hpp"
 #include "IniParser.hpp"
 
+#include <bit>
 #include <charconv>
 
 namespace {
@@ -22,6 +23,79 @@ std::error_code ToSize(const std::string_view &str, size_t &size) {
   return {};
 }
 
+std::error_code ToFlag(const std::string_view &str, bool &flag) {
+  if (str == "true" || str == "yes" || str == "1") {
+    flag = true;
+    return {};
+  }
+  if (str == "false" || str == "no" || str == "0") {
+    flag = false;
+    return {};
+  }
+  return std::make_error_code(std::errc::invalid_argument);
+}
+
+// Tile ids as compiled maps store them, one or two bytes, little endian
+e00::TileIdType TileIdAt(const uint8_t *data, size_t idSize) {
+  return idSize == 1 ? data[0] : static_cast<e00::TileIdType>(data[0] | (data[1] << 8));
+}
+
+std::error_code ReadRawLayer(e00::Stream &stream, size_t size, size_t idSize, std::span<e00::TileIdType> tiles) {
+  if (size != tiles.size() * idSize) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+
+  // Read straight into the tiles; one byte ids land in the second half and are widened in place
+  auto *ids = reinterpret_cast<uint8_t *>(tiles.data()) + tiles.size_bytes() - size;
+  if (const auto ec = stream.Read(size, ids)) {
+    return ec;
+  }
+
+  // Two byte ids are already in place on little endian hosts, and swapped in place elsewhere.
+  // Each id is read before its tile is written, and never overlaps a tile still to come.
+  if (idSize == 1 || std::endian::native != std::endian::little) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+      tiles[i] = TileIdAt(ids + i * idSize, idSize);
+    }
+  }
+  return {};
+}
+
+std::error_code DecodeRuns(std::span<const uint8_t> data, size_t idSize, std::span<e00::TileIdType> tiles) {
+  const size_t runSize = 1 + idSize;
+  if (data.size() % runSize != 0) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+
+  size_t tile = 0;
+  for (size_t i = 0; i < data.size(); i += runSize) {
+    const size_t count = data[i];
+    if (count == 0 || count > tiles.size() - tile) {
+      return std::make_error_code(std::errc::invalid_argument);
+    }
+    std::fill_n(tiles.begin() + static_cast<std::ptrdiff_t>(tile), count, TileIdAt(&data[i + 1], idSize));
+    tile += count;
+  }
+
+  return tile == tiles.size() ? std::error_code() : std::make_error_code(std::errc::invalid_argument);
+}
+
+std::error_code ReadRunLengthLayer(e00::Stream &stream, size_t size, size_t idSize, std::span<e00::TileIdType> tiles) {
+  // Decoded in place when the stream has it in memory
+  if (const auto data = stream.Peek(size); data.size() == size) {
+    if (const auto ec = DecodeRuns(data, idSize, tiles)) {
+      return ec;
+    }
+    return stream.SeekTo(stream.Position() + size);
+  }
+
+  std::vector<uint8_t> data(size);
+  if (const auto ec = stream.Read(data)) {
+    return ec;
+  }
+  return DecodeRuns(data, idSize, tiles);
+}
+
 }// namespace
 
 namespace e00::impl {
@@ -35,7 +109,9 @@ bool WorldLoader::SupportsOption(type_t optionTypeid) const {
 }
 
 std::error_code WorldLoader::ParseTileset(Stream &stream, const std::unique_ptr<Map> &map) {
-  return IniParser::Parse(stream, [&](const IniParser::Item &item) -> std::error_code {
+  std::vector<Map::TileOptions> tileOptions;
+
+  const auto ec = IniParser::Parse(stream, [&](const IniParser::Item &item) -> std::error_code {
     if (item.category == "image") {
       if (item.key == "source") {
         if (map->Tileset()) {
@@ -75,12 +151,60 @@ std::error_code WorldLoader::ParseTileset(Stream &stream, const std::unique_ptr<
     }
 
     if (item.category.starts_with("tile:")) {
-      // Per tile options
-      GetDefaultLogger().Info(source_location::current(), "Tile: {} -> {} = {}", item.category, item.key, item.value);
+      // Per tile options; sections use the tileset's local ids, the map's ids start at 1
+      size_t localId;
+      if (const auto id_ec = ToSize<TileIdType>(item.category.substr(5), localId);
+          id_ec || localId == std::numeric_limits<TileIdType>::max()) {
+        GetDefaultLogger().Error(source_location::current(), "Failed to parse tile id {}", item.category);
+        return id_ec ? id_ec : std::make_error_code(std::errc::invalid_argument);
+      }
+
+      const auto tileId = localId + 1;
+      if (tileId >= tileOptions.size()) {
+        tileOptions.resize(tileId + 1);
+      }
+      auto &options = tileOptions[tileId];
+
+      if (item.key == "collision") {
+        if (item.value == "barrier" || item.value == "solid") {
+          options.solid = true;
+        } else if (item.value == "trigger") {
+          options.trigger = true;
+        } else if (item.value != "none") {
+          GetDefaultLogger().Error(source_location::current(), "Unknown collision {} for {}", item.value, item.category);
+          return std::make_error_code(std::errc::invalid_argument);
+        }
+      } else if (item.key == "solid" || item.key == "trigger") {
+        bool flag;
+        if (const auto flag_ec = ToFlag(item.value, flag)) {
+          GetDefaultLogger().Error(source_location::current(), "Failed to parse {} {} for {}", item.key, item.value, item.category);
+          return flag_ec;
+        }
+        if (item.key == "solid") {
+          options.solid = flag;
+        } else {
+          options.trigger = flag;
+        }
+      } else if (item.key == "cost") {
+        size_t cost;
+        if (const auto cost_ec = ToSize<uint8_t>(item.value, cost);
+            cost_ec || cost > 15) {
+          GetDefaultLogger().Error(source_location::current(), "Failed to parse cost {} for {}, must be 0 to 15", item.value, item.category);
+          return cost_ec ? cost_ec : std::make_error_code(std::errc::invalid_argument);
+        }
+        options.cost = static_cast<uint8_t>(cost);
+      }
     }
 
     return {};
   });
+
+  if (ec) {
+    return ec;
+  }
+
+  map->SetTileOptions(std::move(tileOptions));
+  return {};
 }
 
 std::error_code WorldLoader::ParseSet(Stream &stream, const std::unique_ptr<Map> &map) {
@@ -124,11 +248,70 @@ std::error_code WorldLoader::ParseSet(Stream &stream, const std::unique_ptr<Map>
 }
 
 
+ResourceLoader::Result WorldLoader::ReadCompiled(Stream &stream) {
+  mapfile::Header header{};
+  if (const auto ec = stream.Read(header)) {
+    GetDefaultLogger().Error(source_location::current(), "Failed to read compiled map header: {}", ec.message());
+    return ec;
+  }
+
+  if (header.version != mapfile::Version || header.width == 0 || header.height == 0 || header.layer_count == 0
+      || (header.tile_id_size != 1 && header.tile_id_size != sizeof(TileIdType))) {
+    GetDefaultLogger().Error(source_location::current(), "Unsupported compiled map: version {}, {}x{}, {} layers of {} byte tile ids", header.version, header.width, header.height, header.layer_count, header.tile_id_size);
+    return std::make_error_code(std::errc::not_supported);
+  }
+
+  mapfile::LayerHeader layer{};
+  if (const auto ec = stream.Read(layer)) {
+    GetDefaultLogger().Error(source_location::current(), "Failed to read compiled map layer: {}", ec.message());
+    return ec;
+  }
+
+  if (layer.size > stream.AvailableToRead()) {
+    GetDefaultLogger().Error(source_location::current(), "Compiled map layer is truncated: {} bytes, {} left", layer.size, stream.AvailableToRead());
+    return std::make_error_code(std::errc::io_error);
+  }
+
+  auto map = std::make_unique<Map>(header.width, header.height);
+  const auto ec = map->AssignTiles([&](std::span<TileIdType> tiles) -> std::error_code {
+    switch (static_cast<mapfile::Encoding>(layer.encoding)) {
+      case mapfile::Encoding::Raw: return ReadRawLayer(stream, layer.size, header.tile_id_size, tiles);
+      case mapfile::Encoding::RunLength: return ReadRunLengthLayer(stream, layer.size, header.tile_id_size, tiles);
+    }
+    return std::make_error_code(std::errc::not_supported);
+  });
+
+  if (ec) {
+    GetDefaultLogger().Error(source_location::current(), "Failed to read compiled map tiles: {}", ec.message());
+    return ec;
+  }
+
+  if (header.tileset != 0) {
+    if (const auto &tileset = _engine->FindStreamForResource(header.tileset)) {
+      if (const auto tileset_ec = ParseTileset(*tileset, map)) {
+        return tileset_ec;
+      }
+    } else {
+      GetDefaultLogger().Error(source_location::current(), "Failed to FindStreamForResource tileset {}", header.tileset);
+      return std::make_error_code(std::errc::invalid_argument);
+    }
+  }
+
+  return map;
+}
+
 bool WorldLoader::CanLoad(const LoadContext& context) {
   return true;
 }
 
 ResourceLoader::Result WorldLoader::ReadLoad(const LoadContext& context) {
+  // Compiled maps start with their magic, which no ini file does
+  if (uint32_t magic = 0; !context.stream.Read(magic) && magic == mapfile::Magic) {
+    (void) context.stream.SeekTo(0);
+    return ReadCompiled(context.stream);
+  }
+  (void) context.stream.SeekTo(0);
+
   size_t width = 0;
   size_t height = 0;
   std::unique_ptr<Map> map;
@@ -12,6 +12,11 @@ class WorldLoader : public ResourceLoader {
   std::error_code ParseTileset(Stream &stream, const std::unique_ptr<Map> &map);
   std::error_code ParseSet(Stream &stream, const std::unique_ptr<Map> &map);
 
+  /**
+   * Loads a map made by the map compiler, see MapFormat.hpp
+   */
+  Result ReadCompiled(Stream &stream);
+
 public:
   WorldLoader();
   ~WorldLoader() override;
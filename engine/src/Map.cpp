@@ -3,15 +3,104 @@
 namespace e00 {
 
 void Map::ComputeTilesetTileSize() {
+  _tile_rects.clear();
+  ++_revision;
+
   if (auto* res = _tileset.get()) {
     if (_tileset_size.x != 0 && _tileset_size.y != 0) {
       _tiles_per_row = (res->Size().x - _margin) / (_tileset_size.x + _spacing);
+      const auto tilesPerColumn = (res->Size().y - _margin) / (_tileset_size.y + _spacing);
+
+      // Atlas lookups are done for every painted tile, resolve them all once
+      _tile_rects.resize(1 + static_cast<size_t>(_tiles_per_row) * static_cast<size_t>(tilesPerColumn));
+      for (size_t localTileId = 0; localTileId + 1 < _tile_rects.size(); ++localTileId) {
+        const auto tileX = localTileId % _tiles_per_row;
+        const auto tileY = localTileId / _tiles_per_row;
+
+        _tile_rects[localTileId + 1] = {
+            Vec2D{static_cast<BitmapSizeType>(_margin + tileX * (_tileset_size.x + _spacing)),
+                  static_cast<BitmapSizeType>(_margin + tileY * (_tileset_size.y + _spacing))},
+            _tileset_size};
+      }
+    }
+  }
+}
+
+void Map::UpdateOptions(size_t position) {
+  const auto options = TileOptionsOf(_map_tile[position]);
+  _options[position] = options;
+
+  const auto y = position / _map_size.x;
+  const auto x = position % _map_size.x;
+  auto &word = _solid[y * _solid_words_per_row + x / 64];
+  const auto bit = uint64_t{1} << (x % 64);
+  word = options.solid ? (word | bit) : (word & ~bit);
+}
+
+void Map::UpdateAllOptions() {
+  for (size_t i = 0; i < _map_tile.size(); ++i) {
+    UpdateOptions(i);
+  }
+}
+
+void Map::SetTileOptions(TileIdType tileId, const TileOptions &options) {
+  if (tileId >= _tile_options.size()) {
+    _tile_options.resize(tileId + 1);
+  }
+  _tile_options[tileId] = options;
+
+  for (size_t i = 0; i < _map_tile.size(); ++i) {
+    if (_map_tile[i] == tileId) {
+      UpdateOptions(i);
     }
   }
+  ++_revision;
+}
+
+void Map::SetTileOptions(std::vector<TileOptions> byTileId) {
+  _tile_options = std::move(byTileId);
+  UpdateAllOptions();
+  ++_revision;
+}
+
+bool Map::IsSolid(const RectT<WorldCoordinateType> &area) const {
+  if (area.size.x == 0 || area.size.y == 0) {
+    return false;
+  }
+
+  const size_t x0 = area.origin.x;
+  const size_t y0 = area.origin.y;
+  const size_t x1 = x0 + area.size.x;
+  const size_t y1 = y0 + area.size.y;
+  if (x1 > _map_size.x || y1 > _map_size.y) {
+    return true;
+  }
+
+  const size_t firstWord = x0 / 64;
+  const size_t lastWord = (x1 - 1) / 64;
+  const uint64_t firstMask = ~uint64_t{0} << (x0 % 64);
+  const uint64_t lastMask = ~uint64_t{0} >> (63 - (x1 - 1) % 64);
+
+  for (size_t y = y0; y < y1; ++y) {
+    const auto *row = _solid.data() + y * _solid_words_per_row;
+    if (firstWord == lastWord) {
+      if (row[firstWord] & firstMask & lastMask) return true;
+      continue;
+    }
+
+    if (row[firstWord] & firstMask) return true;
+    for (size_t w = firstWord + 1; w < lastWord; ++w) {
+      if (row[w]) return true;
+    }
+    if (row[lastWord] & lastMask) return true;
+  }
+
+  return false;
 }
 
 void Map::SetTileset(ResourcePtrT<DrawableResource> set) {
   _tileset = std::move(set);
+  _baked.Reset();
   ComputeTilesetTileSize();
 }
 
@@ -20,8 +109,59 @@ void Map::SetTileSize(const Vec2D<BitmapSizeType> &size) {
   ComputeTilesetTileSize();
 }
 
+const DrawableSurface &Map::TilesetFor(const Painter &painter) {
+  const DrawableSurface &source = _tileset.Ref();
+  const auto target = painter.TargetFormat();
+
+  // No idea what we're painting on, or it has no palette to match against
+  if (target.bit_depth == DrawableSurface::BitDepth::DEPTH_INVALID
+      || (target.bit_depth == DrawableSurface::BitDepth::DEPTH_8 && !target.palette)) {
+    return source;
+  }
+
+  const auto sourcePalette = source.GetNativeFormat().palette;
+  const auto sourcePaletteRevision = sourcePalette ? sourcePalette->revision() : 0;
+  const auto targetPaletteRevision = target.palette ? target.palette->revision() : 0;
+
+  if (_baked.surface
+      && _baked.source == &source
+      && _baked.format.bit_depth == target.bit_depth
+      && _baked.format.palette == target.palette
+      && _baked.format.shift == target.shift
+      && _baked.format.mask == target.mask
+      && _baked.sourcePaletteRevision == sourcePaletteRevision
+      && _baked.targetPaletteRevision == targetPaletteRevision) {
+    return *_baked.surface;
+  }
+
+  _baked.Reset();
+
+  const bool indexed = target.bit_depth == DrawableSurface::BitDepth::DEPTH_8;
+  auto baked = Bitmap::Create(source.Size(), target.bit_depth, indexed ? static_cast<int>(target.palette->size()) : 0);
+  if (!baked) {
+    return source;
+  }
+
+  // Direct colour bitmaps use the default channel layout; if the target's differs, tiles
+  // still get a plain swizzle instead of a palette lookup
+  if (indexed) {
+    baked->SetPalette(*target.palette);
+  }
+
+  if (auto bakePainter = baked->BeginDraw()) {
+    bakePainter->DrawSurface(source, RectT<BitmapSizeType>{{0, 0}, source.Size()}, {0, 0});
+  }
+
+  _baked.surface = std::move(baked);
+  _baked.source = &source;
+  _baked.format = target;
+  _baked.sourcePaletteRevision = sourcePaletteRevision;
+  _baked.targetPaletteRevision = targetPaletteRevision;
+  return *_baked.surface;
+}
+
 void Map::PaintTile(const Position &position, Painter &painter, const Vec2D<BitmapSizeType> &origin) {
-  if (!_tileset || _tiles_per_row == 0) {
+  if (!_tileset || _tile_rects.empty()) {
     return;
   }
 
@@ -31,22 +171,65 @@ void Map::PaintTile(const Position &position, Painter &painter, const Vec2D<Bitm
   }
 
   const auto tileId = _map_tile.at(mapIndex);
-  if (tileId == 0) {
+  if (tileId == 0 || tileId >= _tile_rects.size()) {
     return;
   }
 
-  const auto localTileId = tileId - 1;
+  painter.DrawSurface(TilesetFor(painter), _tile_rects[tileId], origin);
+}
+
+void Map::PaintRegion(const Vec2D<uint32_t> &worldOrigin, const Vec2D<BitmapSizeType> &size, Painter &painter, const Vec2D<BitmapSizeType> &dstPos) {
+  if (!_tileset || _tile_rects.empty()) {
+    return;
+  }
+
+  const auto &tileset = TilesetFor(painter);
+  const Vec2D<uint32_t> tileSize{_tileset_size.x, _tileset_size.y};
+  const Vec2D<uint32_t> worldEnd{worldOrigin.x + size.x, worldOrigin.y + size.y};
+
+  // Tiles touched by the region, within the map
+  const uint32_t firstX = worldOrigin.x / tileSize.x;
+  const uint32_t firstY = worldOrigin.y / tileSize.y;
+  const uint32_t endX = std::min<uint32_t>((worldEnd.x + tileSize.x - 1) / tileSize.x, _map_size.x);
+  const uint32_t endY = std::min<uint32_t>((worldEnd.y + tileSize.y - 1) / tileSize.y, _map_size.y);
+  if (firstX >= endX || firstY >= endY) {
+    return;
+  }
+
+  std::vector<Painter::SurfaceBlit> rowBlits;
+  rowBlits.reserve(endX - firstX);
+
+  for (uint32_t ty = firstY; ty < endY; ++ty) {
+    rowBlits.clear();
+
+    // Visible rows of this tile row
+    const uint32_t tileTop = ty * tileSize.y;
+    const uint32_t y0 = std::max(tileTop, worldOrigin.y);
+    const uint32_t y1 = std::min(tileTop + tileSize.y, worldEnd.y);
 
-  const auto tileX = localTileId % _tiles_per_row;
-  const auto tileY = localTileId / _tiles_per_row;
+    for (uint32_t tx = firstX; tx < endX; ++tx) {
+      const auto tileId = _map_tile[static_cast<size_t>(ty) * _map_size.x + tx];
+      if (tileId == 0 || tileId >= _tile_rects.size()) {
+        continue;
+      }
 
-  const auto sourceX = static_cast<BitmapSizeType>(_margin + tileX * (_tileset_size.x + _spacing));
-  const auto sourceY = static_cast<BitmapSizeType>(_margin + tileY * (_tileset_size.y + _spacing));
+      const uint32_t tileLeft = tx * tileSize.x;
+      const uint32_t x0 = std::max(tileLeft, worldOrigin.x);
+      const uint32_t x1 = std::min(tileLeft + tileSize.x, worldEnd.x);
 
-  painter.DrawSurface(
-      _tileset.Ref(),
-      RectT{Vec2D{sourceX, sourceY}, _tileset_size},
-      origin);
+      const auto &atlas = _tile_rects[tileId];
+      rowBlits.push_back({
+          RectT<BitmapSizeType>{
+              static_cast<BitmapSizeType>(atlas.origin.x + (x0 - tileLeft)),
+              static_cast<BitmapSizeType>(atlas.origin.y + (y0 - tileTop)),
+              static_cast<BitmapSizeType>(x1 - x0),
+              static_cast<BitmapSizeType>(y1 - y0)},
+          {static_cast<BitmapSizeType>(dstPos.x + (x0 - worldOrigin.x)),
+           static_cast<BitmapSizeType>(dstPos.y + (y0 - worldOrigin.y))}});
+    }
+
+    painter.DrawSurfaces(tileset, rowBlits);
+  }
 }
 
 }// namespace e00
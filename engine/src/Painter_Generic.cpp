@@ -1,6 +1,18 @@
 
 #include "PrivateInclude.hpp"
 
+namespace {
+// Clip rectangle as [x0, x1) x [y0, y1), computed once per primitive
+struct ClipBounds {
+  long x0, y0, x1, y1;
+
+  explicit ClipBounds(const e00::RectT<e00::BitmapSizeType> &clip)
+      : x0(clip.origin.x), y0(clip.origin.y), x1(x0 + clip.size.x), y1(y0 + clip.size.y) {}
+
+  [[nodiscard]] bool Contains(long x, long y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+};
+}// namespace
+
 namespace e00 {
 void Painter::DrawRect(const RectT<BitmapSizeType> &rect) {
   // Since we're gonna change the pen, save it here
@@ -16,10 +28,12 @@ void Painter::DrawRect(const RectT<BitmapSizeType> &rect) {
       SetPenSolid(1, _brushIndex);
     }
 
-    for (BitmapSizeType y = 0; y < rect.size.y; ++y) {
-      for (BitmapSizeType x = 0; x < rect.size.x; ++x) {
-        DrawPoint({static_cast<unsigned short>(rect.origin.x + x),
-                   static_cast<unsigned short>(rect.origin.y + y)});
+    // Only the visible part is filled
+    const auto area = rect.Intersect(_clipRect);
+    for (BitmapSizeType y = 0; y < area.size.y; ++y) {
+      for (BitmapSizeType x = 0; x < area.size.x; ++x) {
+        DrawPoint({static_cast<unsigned short>(area.origin.x + x),
+                   static_cast<unsigned short>(area.origin.y + y)});
       }
     }
   }
@@ -51,13 +65,19 @@ void Painter::DrawLine(const Vec2D<BitmapSizeType> &start, const Vec2D<BitmapSiz
   const int x1 = end.x;
   const int y1 = end.y;
 
+  // Lines entirely outside of the clip are dropped as a whole
+  const ClipBounds clip(_clipRect);
+  if (std::max(x0, x1) < clip.x0 || std::min(x0, x1) >= clip.x1 || std::max(y0, y1) < clip.y0 || std::min(y0, y1) >= clip.y1) return;
+
   const int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
   const int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
   int err = dx + dy;
 
   for (;;) {
-    DrawPoint({static_cast<unsigned short>(x0), static_cast<unsigned short>(y0)});
-    
+    if (clip.Contains(x0, y0)) {
+      DrawPoint({static_cast<unsigned short>(x0), static_cast<unsigned short>(y0)});
+    }
+
     if (x0 == x1 && y0 == y1) break;
     const int e2 = 2 * err;
     if (e2 >= dy) {
@@ -72,6 +92,9 @@ void Painter::DrawLine(const Vec2D<BitmapSizeType> &start, const Vec2D<BitmapSiz
 }
 
 void Painter::DrawEllipse(const RectT<BitmapSizeType> &rect) {
+  if (!rect.Intersect(_clipRect).isValid()) return;
+  const ClipBounds clip(_clipRect);
+
   const long rx = rect.size.x / 2;
   const long ry = rect.size.y / 2;
   const long xc = rect.origin.x + rx;
@@ -89,14 +112,20 @@ void Painter::DrawEllipse(const RectT<BitmapSizeType> &rect) {
 
   auto plot_symmetrical = [&](long px, long py) {
     if (_brushStyle != BrushStyle::NoBrush) {
-      for (long ix = xc - px; ix <= xc + px; ++ix) {
-        if (_brushStyle == BrushStyle::SolidBrushIndex) {
-          SetPenSolid(1, _brushIndex);
-        } else {
-          SetPenSolid(1, _brushColor);
+      if (_brushStyle == BrushStyle::SolidBrushIndex) {
+        SetPenSolid(1, _brushIndex);
+      } else {
+        SetPenSolid(1, _brushColor);
+      }
+
+      // The span is clipped once, then only the rows that are visible are drawn
+      const long fromX = std::max(xc - px, clip.x0);
+      const long toX = std::min(xc + px + 1, clip.x1);
+      for (const long iy: {yc + py, yc - py}) {
+        if (iy < clip.y0 || iy >= clip.y1 || (iy == yc - py && py == 0)) continue;
+        for (long ix = fromX; ix < toX; ++ix) {
+          DrawPoint(Vec2D<BitmapSizeType>(static_cast<BitmapSizeType>(ix), static_cast<BitmapSizeType>(iy)));
         }
-        DrawPoints({Vec2D<BitmapSizeType>(ix, yc + py),
-                    Vec2D<BitmapSizeType>(ix, yc - py)});
       }
     }
 
@@ -107,12 +136,11 @@ void Painter::DrawEllipse(const RectT<BitmapSizeType> &rect) {
     }
 
     if (_penStyle != PenStyle::NoPen) {
-      DrawPoints({
-          Vec2D<BitmapSizeType>(xc + px, yc + py),
-          Vec2D<BitmapSizeType>(xc - px, yc + py),
-          Vec2D<BitmapSizeType>(xc + px, yc - py),
-          Vec2D<BitmapSizeType>(xc - px, yc - py),
-      });
+      for (const auto &[ix, iy]: {std::pair{xc + px, yc + py}, std::pair{xc - px, yc + py}, std::pair{xc + px, yc - py}, std::pair{xc - px, yc - py}}) {
+        if (clip.Contains(ix, iy)) {
+          DrawPoint(Vec2D<BitmapSizeType>(static_cast<BitmapSizeType>(ix), static_cast<BitmapSizeType>(iy)));
+        }
+      }
     }
   };
 
@@ -150,6 +178,15 @@ void Painter::DrawEllipse(const RectT<BitmapSizeType> &rect) {
 void Painter::DrawSurface(const DrawableSurface &src,
                          RectT<BitmapSizeType> srcRect,
                          Vec2D<BitmapSizeType> dstPos) {
+  // Clip the destination once, trimming the left / top moves the source origin along
+  const auto visible = RectT<BitmapSizeType>{dstPos, srcRect.size}.Intersect(_clipRect);
+  if (!visible.isValid()) return;
+
+  srcRect.origin.x += visible.origin.x - dstPos.x;
+  srcRect.origin.y += visible.origin.y - dstPos.y;
+  srcRect.size = visible.size;
+  dstPos = visible.origin;
+
   // Generic Path using 32-bit intermediate
   DrawableSurface::TargetInformation info32;
   info32.bit_depth = DrawableSurface::BitDepth::DEPTH_32;
@@ -179,4 +216,10 @@ void Painter::DrawSurface(const DrawableSurface &src,
     case PenStyle::SolidLineIndex: SetPenSolid(oldPenWidth, oldPenIndex); break;
   }
 }
+
+void Painter::DrawSurfaces(const DrawableSurface &src, std::span<const SurfaceBlit> blits) {
+  for (const auto &blit : blits) {
+    DrawSurface(src, blit.srcRect, blit.dstPos);
+  }
+}
 }// namespace e00
@@ -1,8 +1,14 @@
 #include "Painter_PaintDevice.hpp"
+#include "BlitKernels.hpp"
 #include "PrivateInclude.hpp"
 
 namespace e00 {
 
+SoftwarePainter::ClipBounds SoftwarePainter::CurrentClip() const {
+  const auto clip = _clipRect.Intersect({{0, 0}, _targetSize});
+  return {clip.origin.x, clip.origin.y, clip.origin.x + clip.size.x, clip.origin.y + clip.size.y};
+}
+
 void SoftwarePainter::PutPixel(BitmapSizeType x, BitmapSizeType y, const Color &color) {
   if (x >= _targetSize.x || y >= _targetSize.y) return;
   if (std::span<uint8_t> line = GetTargetLine(y);
@@ -37,6 +43,68 @@ void SoftwarePainter::PutPixel(BitmapSizeType x, BitmapSizeType y, uint8_t index
   }
 }
 
+uint32_t SoftwarePainter::ResolveRawColor(const Color &color) const {
+  switch (_bit_depth) {
+    case DrawableSurface::BitDepth::DEPTH_32: return helpers::BitmapDepth32::PackColor(color, _target.GetShift(), _target.GetMask());
+    case DrawableSurface::BitDepth::DEPTH_16: return helpers::BitmapDepth16::PackColor(color, _target.GetShift(), _target.GetMask());
+    case DrawableSurface::BitDepth::DEPTH_8: return _palette.findClosestColorIndex(color);
+    case DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE:
+      GetDefaultLogger().Error(source_location::current(), "Cannot draw RGB color to DEPTH_8_NO_PALETTE surface");
+      std::abort();
+    case DrawableSurface::BitDepth::DEPTH_1: return _palette.findClosestColorIndex(color);
+    default: break;
+  }
+  return 0;
+}
+
+uint32_t SoftwarePainter::ResolveRawColor(uint8_t index) const {
+  switch (_bit_depth) {
+    case DrawableSurface::BitDepth::DEPTH_32: return helpers::BitmapDepth32::PackColor(_palette[index], _target.GetShift(), _target.GetMask());
+    case DrawableSurface::BitDepth::DEPTH_16: return helpers::BitmapDepth16::PackColor(_palette[index], _target.GetShift(), _target.GetMask());
+    case DrawableSurface::BitDepth::DEPTH_8:
+    case DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE: return index;
+    case DrawableSurface::BitDepth::DEPTH_1: return index > 0;
+    default: break;
+  }
+  return 0;
+}
+
+uint32_t SoftwarePainter::ResolveRawBrush() const {
+  if (_brushStyle == BrushStyle::SolidBrushIndex) {
+    return ResolveRawColor(_brushIndex);
+  }
+  return ResolveRawColor(_brushColor);
+}
+
+uint32_t SoftwarePainter::ResolveRawPen() const {
+  if (_penStyle == PenStyle::SolidLineIndex) {
+    return ResolveRawColor(_penIndex);
+  }
+  return ResolveRawColor(_penColor);
+}
+
+void SoftwarePainter::FillSpan(const ClipBounds &clip, long x0, long x1, long y, uint32_t raw) {
+  // Clip once for the whole span, [x0, x1)
+  if (y < clip.y0 || y >= clip.y1) return;
+  if (x0 < clip.x0) x0 = clip.x0;
+  if (x1 > clip.x1) x1 = clip.x1;
+  if (x0 >= x1) return;
+
+  auto line = GetTargetLine(static_cast<BitmapSizeType>(y));
+  if (line.empty()) return;
+
+  const auto x = static_cast<BitmapSizeType>(x0);
+  const auto count = static_cast<BitmapSizeType>(x1 - x0);
+  switch (_bit_depth) {
+    case DrawableSurface::BitDepth::DEPTH_32: helpers::BitmapDepth32::Fill(line, x, count, raw); break;
+    case DrawableSurface::BitDepth::DEPTH_16: helpers::BitmapDepth16::Fill(line, x, count, static_cast<uint16_t>(raw)); break;
+    case DrawableSurface::BitDepth::DEPTH_8:
+    case DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE: helpers::BitmapDepth8::Fill(line, x, count, static_cast<uint8_t>(raw)); break;
+    case DrawableSurface::BitDepth::DEPTH_1: helpers::BitmapDepth1::Fill(line, x, count, raw != 0); break;
+    default: break;
+  }
+}
+
 void SoftwarePainter::Copy8BitNoPalette(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos) {
   const BitmapSizeType width = srcRect.size.x;
   const BitmapSizeType height = srcRect.size.y;
@@ -64,8 +132,8 @@ void SoftwarePainter::Copy8BitTo8Bit(const DrawableSurface &src, RectT<BitmapSiz
   FixedPalette srcPalette(srcPaletteSize);
   std::array<uint8_t, 256> colorMap{};
   for (size_t i = 0; i < srcPaletteSize; ++i) {
-    srcPalette[i] = src.GetColorFromPalette(i);
-    colorMap[i] = _palette.findClosestColorIndex(srcPalette[i]);
+    srcPalette.set(i, src.GetColorFromPalette(i));
+    colorMap[i] = _palette.findExactClosestColorIndex(srcPalette[i]);
   }
 
   std::vector<uint8_t> row_buffer(helpers::BitmapDepth8::BufferBytesPerLine(width));
@@ -88,9 +156,139 @@ void SoftwarePainter::Copy8BitTo8Bit(const DrawableSurface &src, RectT<BitmapSiz
     }
   }
 }
+struct SoftwarePainter::NativeBlit {
+  impl::blit::RowKernel kernel = nullptr;
+  impl::blit::RowParams params{};
+  std::array<uint32_t, FixedPalette::MAX_SIZE> paletteRaw{};
+  size_t srcBytesPerPixel = 0;
+  size_t dstBytesPerPixel = 0;
+};
+
+bool SoftwarePainter::ClipBlit(const ClipBounds &clip, const Vec2D<BitmapSizeType> &srcSize, RectT<BitmapSizeType> &srcRect, Vec2D<BitmapSizeType> &dstPos) {
+  if (srcRect.origin.x >= srcSize.x || srcRect.origin.y >= srcSize.y) return false;
+
+  long x0 = dstPos.x;
+  long y0 = dstPos.y;
+  long x1 = x0 + std::min<long>(srcRect.size.x, srcSize.x - srcRect.origin.x);
+  long y1 = y0 + std::min<long>(srcRect.size.y, srcSize.y - srcRect.origin.y);
+
+  // Trimming the left / top moves the source origin along
+  if (x0 < clip.x0) {
+    srcRect.origin.x += static_cast<BitmapSizeType>(clip.x0 - x0);
+    x0 = clip.x0;
+  }
+  if (y0 < clip.y0) {
+    srcRect.origin.y += static_cast<BitmapSizeType>(clip.y0 - y0);
+    y0 = clip.y0;
+  }
+  x1 = std::min(x1, clip.x1);
+  y1 = std::min(y1, clip.y1);
+  if (x1 <= x0 || y1 <= y0) return false;
+
+  dstPos = {static_cast<BitmapSizeType>(x0), static_cast<BitmapSizeType>(y0)};
+  srcRect.size = {static_cast<BitmapSizeType>(x1 - x0), static_cast<BitmapSizeType>(y1 - y0)};
+  return true;
+}
+
+bool SoftwarePainter::IsSameAsTargetPalette(const FixedPalette &palette) const {
+  if (&palette == &_palette) {
+    return true;
+  }
+
+  const auto revision = palette.revision();
+  const auto targetRevision = _palette.revision();
+  if (_lastPaletteMatch.palette != &palette || _lastPaletteMatch.revision != revision || _lastPaletteMatch.targetRevision != targetRevision) {
+    _lastPaletteMatch = {&palette, revision, targetRevision, palette.isSamePalette(_palette)};
+  }
+  return _lastPaletteMatch.same;
+}
+
+bool SoftwarePainter::PrepareNativeBlit(const DrawableSurface &src, NativeBlit &blit) const {
+  if (src.Size().y == 0 || src.GetNativeLine(0).empty()) {
+    return false;
+  }
+
+  const DrawableSurface::TargetInformation srcFormat = src.GetNativeFormat();
+  const DrawableSurface::TargetInformation dstFormat = TargetFormat();
+
+  blit.params = {srcFormat.shift, srcFormat.mask, dstFormat.shift, dstFormat.mask};
+  blit.params.dstPalette = &_palette;
+  blit.srcBytesPerPixel = DepthEnumToBits(srcFormat.bit_depth) / 8;
+  blit.dstBytesPerPixel = DepthEnumToBits(_bit_depth) / 8;
+
+  // Indexed to indexed: either the indices are kept as they are, or they go through a remapping table
+  if (helpers::is8Bit(srcFormat.bit_depth) && helpers::is8Bit(_bit_depth)) {
+    blit.srcBytesPerPixel = blit.dstBytesPerPixel = 1;
+
+    if (srcFormat.bit_depth == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE
+        || _bit_depth == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE
+        || (srcFormat.palette && IsSameAsTargetPalette(*srcFormat.palette))) {
+      blit.kernel = &impl::blit::CopyRow<impl::blit::D8>;
+      return true;
+    }
+
+    if (!srcFormat.palette) {
+      return false;
+    }
+
+    for (size_t i = 0; i < srcFormat.palette->size(); ++i) {
+      blit.paletteRaw[i] = _palette.findExactClosestColorIndex((*srcFormat.palette)[i]);
+    }
+    blit.params.paletteRaw = blit.paletteRaw.data();
+    blit.kernel = &impl::blit::RemapIndexedRow;
+    return true;
+  }
+
+  blit.kernel = impl::blit::SelectRowKernel(srcFormat, dstFormat);
+  if (!blit.kernel) {
+    return false;
+  }
+
+  if (srcFormat.bit_depth == DrawableSurface::BitDepth::DEPTH_8) {
+    if (!srcFormat.palette) {
+      return false;
+    }
+
+    for (size_t i = 0; i < srcFormat.palette->size(); ++i) {
+      blit.paletteRaw[i] = ResolveRawColor((*srcFormat.palette)[i]);
+    }
+    blit.params.paletteRaw = blit.paletteRaw.data();
+  }
+
+  return true;
+}
+
+void SoftwarePainter::RunNativeBlit(const DrawableSurface &src, const NativeBlit &blit, const RectT<BitmapSizeType> &srcRect, const Vec2D<BitmapSizeType> &dstPos) {
+  const size_t srcOffset = srcRect.origin.x * blit.srcBytesPerPixel;
+  const size_t dstOffset = dstPos.x * blit.dstBytesPerPixel;
+
+  for (BitmapSizeType y = 0; y < srcRect.size.y; ++y) {
+    const auto srcLine = src.GetNativeLine(srcRect.origin.y + y);
+    auto dstLine = _target.GetLineSpan(dstPos.y + y);
+    if (srcLine.empty() || dstLine.empty()) continue;
+
+    blit.kernel(srcLine.data() + srcOffset, dstLine.data() + dstOffset, srcRect.size.x, blit.params);
+  }
+}
+
+bool SoftwarePainter::DrawNativeData(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos) {
+  // Kernel is chosen once for the whole blit
+  NativeBlit blit;
+  if (!PrepareNativeBlit(src, blit)) {
+    return false;
+  }
+
+  RunNativeBlit(src, blit, srcRect, dstPos);
+  return true;
+}
+
 void SoftwarePainter::DrawGenericData(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos) {
-  // Optimized path for matching 8-bit with palette mapping
+  // Sources in system memory are converted straight into the target, one specialised kernel per depth pair
+  if (DrawNativeData(src, srcRect, dstPos)) {
+    return;
+  }
 
+  // Optimized path for matching 8-bit with palette mapping
   if (helpers::is8Bit(_bit_depth) && helpers::is8Bit(src.GetBitDepth())) {
     if (src.GetBitDepth() == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE || _bit_depth == DrawableSurface::BitDepth::DEPTH_8_NO_PALETTE) {
       Copy8BitNoPalette(src, srcRect, dstPos);
@@ -108,10 +306,19 @@ void SoftwarePainter::DrawGenericData(const DrawableSurface &src, RectT<BitmapSi
 
   const BitmapSizeType width = srcRect.size.x;
 
-  std::vector<uint8_t> line32(helpers::BitmapDepth32::BufferBytesPerLine(width));
+  // Read a band of lines at a time, so the source sets its conversion up once per band rather than once per line
+  constexpr BitmapSizeType BandLines = 16;
+  const size_t stride = helpers::BitmapDepth32::BufferBytesPerLine(width);
+  std::vector<uint8_t> band32(stride * BandLines);
 
   for (BitmapSizeType y = 0; y < srcRect.size.y; ++y) {
-    src.ReadLineInto(srcRect.origin.y + y, srcRect.origin.x, srcRect.origin.x + width, info32, line32);
+    const auto bandLine = static_cast<BitmapSizeType>(y % BandLines);
+    if (bandLine == 0) {
+      const auto lines = std::min(BandLines, static_cast<BitmapSizeType>(srcRect.size.y - y));
+      src.ReadLinesInto(srcRect.origin.y + y, lines, srcRect.origin.x, srcRect.origin.x + width, info32, band32, stride);
+    }
+
+    const auto line32 = std::span(band32).subspan(bandLine * stride, stride);
     auto targetLine = _target.GetLineSpan(dstPos.y + y);
     if (targetLine.empty()) continue;
 
@@ -134,6 +341,8 @@ void SoftwarePainter::DrawGenericData(const DrawableSurface &src, RectT<BitmapSi
 }
 
 void SoftwarePainter::DrawPoint(const Vec2D<BitmapSizeType> &pos) {
+  if (!CurrentClip().Contains(pos.x, pos.y)) return;
+
   switch (_penStyle) {
     case PenStyle::NoPen: break;
     case PenStyle::SolidLineColor: PutPixel(pos.x, pos.y, _penColor); break;
@@ -141,16 +350,57 @@ void SoftwarePainter::DrawPoint(const Vec2D<BitmapSizeType> &pos) {
   }
 }
 
+void SoftwarePainter::DrawLine(const Vec2D<BitmapSizeType> &start, const Vec2D<BitmapSizeType> &end) {
+  if (_penStyle == PenStyle::NoPen) return;
+
+  long x0 = start.x;
+  long y0 = start.y;
+  const long x1 = end.x;
+  const long y1 = end.y;
+
+  // Lines entirely outside of the clip are dropped as a whole
+  const auto clip = CurrentClip();
+  if (std::max(x0, x1) < clip.x0 || std::min(x0, x1) >= clip.x1 || std::max(y0, y1) < clip.y0 || std::min(y0, y1) >= clip.y1) return;
+
+  const uint32_t raw = ResolveRawPen();
+
+  // Horizontal lines (rect outlines, mostly) are a single span
+  if (y0 == y1) {
+    FillSpan(clip, std::min(x0, x1), std::max(x0, x1) + 1, y0, raw);
+    return;
+  }
+
+  const long dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  const long dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  long err = dx + dy;
+
+  for (;;) {
+    FillSpan(clip, x0, x0 + 1, y0, raw);
+
+    if (x0 == x1 && y0 == y1) break;
+    const long e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
 void SoftwarePainter::DrawRect(const RectT<BitmapSizeType> &rect) {
   if (_brushStyle != BrushStyle::NoBrush) {
-    for (BitmapSizeType y = 0; y < rect.size.y; ++y) {
-      for (BitmapSizeType x = 0; x < rect.size.x; ++x) {
-        if (_brushStyle == BrushStyle::SolidBrushIndex) {
-          PutPixel(rect.origin.x + x, rect.origin.y + y, _brushIndex);
-        } else {
-          PutPixel(rect.origin.x + x, rect.origin.y + y, _brushColor);
-        }
-      }
+    const uint32_t raw = ResolveRawBrush();
+    const long x0 = rect.origin.x;
+    const long x1 = x0 + rect.size.x;
+    const auto clip = CurrentClip();
+    const long y0 = std::max<long>(rect.origin.y, clip.y0);
+    const long y1 = std::min<long>(rect.origin.y + rect.size.y, clip.y1);
+
+    for (long y = y0; y < y1; ++y) {
+      FillSpan(clip, x0, x1, y, raw);
     }
   }
 
@@ -177,24 +427,25 @@ void SoftwarePainter::DrawEllipse(const RectT<BitmapSizeType> &rect) {
   long p = e00::lrint(ry2 - rx2 * ry + 0.25 * rx2);
   long dx = 2 * ry2 * x, dy = 2 * rx2 * y;
 
+  const auto clip = CurrentClip();
+  if (xc + rx < clip.x0 || xc - rx >= clip.x1 || yc + ry < clip.y0 || yc - ry >= clip.y1) return;
+
+  const uint32_t brushRaw = _brushStyle != BrushStyle::NoBrush ? ResolveRawBrush() : 0;
+  const uint32_t penRaw = _penStyle != PenStyle::NoPen ? ResolveRawPen() : 0;
+
   auto plot_symmetrical = [&](long px, long py) {
     if (_brushStyle != BrushStyle::NoBrush) {
-      for (long ix = xc - px; ix <= xc + px; ++ix) {
-        if (_brushStyle == BrushStyle::SolidBrushIndex) {
-          PutPixel(ix, yc + py, _brushIndex);
-          PutPixel(ix, yc - py, _brushIndex);
-        } else {
-          PutPixel(ix, yc + py, _brushColor);
-          PutPixel(ix, yc - py, _brushColor);
-        }
+      FillSpan(clip, xc - px, xc + px + 1, yc + py, brushRaw);
+      if (py != 0) {
+        FillSpan(clip, xc - px, xc + px + 1, yc - py, brushRaw);
       }
     }
 
     if (_penStyle != PenStyle::NoPen) {
-      DrawPoint(Vec2D<BitmapSizeType>(xc + px, yc + py));
-      DrawPoint(Vec2D<BitmapSizeType>(xc - px, yc + py));
-      DrawPoint(Vec2D<BitmapSizeType>(xc + px, yc - py));
-      DrawPoint(Vec2D<BitmapSizeType>(xc - px, yc - py));
+      FillSpan(clip, xc + px, xc + px + 1, yc + py, penRaw);
+      FillSpan(clip, xc - px, xc - px + 1, yc + py, penRaw);
+      FillSpan(clip, xc + px, xc + px + 1, yc - py, penRaw);
+      FillSpan(clip, xc - px, xc - px + 1, yc - py, penRaw);
     }
   };
 
@@ -233,16 +484,7 @@ void SoftwarePainter::DrawSurface(const DrawableSurface &src,
                                   RectT<BitmapSizeType> srcRect,
                                   Vec2D<BitmapSizeType> dstPos) {
   // Clipping
-  if (dstPos.x >= _targetSize.x || dstPos.y >= _targetSize.y) return;
-
-  BitmapSizeType width = srcRect.size.x;
-  BitmapSizeType height = srcRect.size.y;
-
-  if (dstPos.x + width > _targetSize.x) width = _targetSize.x - dstPos.x;
-  if (dstPos.y + height > _targetSize.y) height = _targetSize.y - dstPos.y;
-  if (width == 0 || height == 0) return;
-
-  srcRect.size = {width, height};
+  if (!ClipBlit(CurrentClip(), src.Size(), srcRect, dstPos)) return;
 
   // if (src.Type() == type_id<Bitmap>()) {
   //   auto &bmp = static_cast<const Bitmap &>(src);
@@ -261,4 +503,25 @@ void SoftwarePainter::DrawSurface(const DrawableSurface &src,
   DrawGenericData(src, srcRect, dstPos);
 }
 
+void SoftwarePainter::DrawSurfaces(const DrawableSurface &src, std::span<const SurfaceBlit> blits) {
+  // Format dispatch and palette tables are resolved once for the whole batch
+  NativeBlit native;
+  const bool isNative = PrepareNativeBlit(src, native);
+
+  const auto clip = CurrentClip();
+  const auto srcSize = src.Size();
+
+  for (const auto &[rect, pos] : blits) {
+    auto srcRect = rect;
+    auto dstPos = pos;
+    if (!ClipBlit(clip, srcSize, srcRect, dstPos)) continue;
+
+    if (isNative) {
+      RunNativeBlit(src, native, srcRect, dstPos);
+    } else {
+      DrawGenericData(src, srcRect, dstPos);
+    }
+  }
+}
+
 }// namespace e00
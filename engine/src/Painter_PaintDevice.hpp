@@ -10,6 +10,15 @@ class SoftwarePainter : public Painter {
   const FixedPalette &_palette;
   impl::BitmapData &_target;
 
+  // Outcome of the last comparison of a source palette against _palette, keyed on both revisions
+  struct PaletteMatch {
+    const FixedPalette *palette{};
+    uint32_t revision{};
+    uint32_t targetRevision{};
+    bool same{};
+  };
+  mutable PaletteMatch _lastPaletteMatch;
+
   [[nodiscard]] std::span<uint8_t> GetTargetLine(BitmapSizeType y) const {
     if (y < _targetSize.y) {
       return _target.GetLineSpan(y);
@@ -18,11 +27,38 @@ class SoftwarePainter : public Painter {
     return {};
   }
 
+  // Drawable area, the clip rectangle intersected with the target: [x0, x1) x [y0, y1)
+  // Computed once at the start of every primitive
+  struct ClipBounds {
+    long x0, y0, x1, y1;
+
+    [[nodiscard]] bool Contains(long x, long y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+  };
+  [[nodiscard]] ClipBounds CurrentClip() const;
+
   void PutPixel(BitmapSizeType x, BitmapSizeType y, const Color &color);
   void PutPixel(BitmapSizeType x, BitmapSizeType y, uint8_t index);
+
+  // Span filling: the colour is resolved once into the target's raw pixel encoding, then whole rows are written
+  [[nodiscard]] uint32_t ResolveRawColor(const Color &color) const;
+  [[nodiscard]] uint32_t ResolveRawColor(uint8_t index) const;
+  [[nodiscard]] uint32_t ResolveRawBrush() const;
+  [[nodiscard]] uint32_t ResolveRawPen() const;
+  void FillSpan(const ClipBounds &clip, long x0, long x1, long y, uint32_t raw);
   void Copy8BitNoPalette(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos);
   void Copy8BitTo8Bit(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos);
 
+  // Clips a blit against `clip`, moving the source origin along; false if nothing is left to draw
+  static bool ClipBlit(const ClipBounds &clip, const Vec2D<BitmapSizeType> &srcSize, RectT<BitmapSizeType> &srcRect, Vec2D<BitmapSizeType> &dstPos);
+
+  // Same colors as _palette, without comparing them again for every tile of the same source
+  [[nodiscard]] bool IsSameAsTargetPalette(const FixedPalette &palette) const;
+
+  // Blits from a source in system memory, resolved once and then run for any number of rects
+  struct NativeBlit;
+  bool PrepareNativeBlit(const DrawableSurface &src, NativeBlit &blit) const;
+  void RunNativeBlit(const DrawableSurface &src, const NativeBlit &blit, const RectT<BitmapSizeType> &srcRect, const Vec2D<BitmapSizeType> &dstPos);
+  bool DrawNativeData(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos);
   void DrawGenericData(const DrawableSurface &src, RectT<BitmapSizeType> srcRect, Vec2D<BitmapSizeType> dstPos);
 
 public:
@@ -36,12 +72,18 @@ public:
         _palette(palette),
         _target(target) {}
 
+  [[nodiscard]] DrawableSurface::TargetInformation TargetFormat() const override {
+    return {_bit_depth, &_palette, _target.GetShift(), _target.GetMask()};
+  }
+
   void DrawPoint(const Vec2D<BitmapSizeType> &pos) override;
+  void DrawLine(const Vec2D<BitmapSizeType> &start, const Vec2D<BitmapSizeType> &end) override;
   void DrawEllipse(const RectT<BitmapSizeType> &rect) override;
   void DrawRect(const RectT<BitmapSizeType> &rect) override;
   void DrawSurface(const DrawableSurface &src,
                    RectT<BitmapSizeType> srcRect,
                    Vec2D<BitmapSizeType> dstPos) override;
+  void DrawSurfaces(const DrawableSurface &src, std::span<const SurfaceBlit> blits) override;
 };
 
 }// namespace e00
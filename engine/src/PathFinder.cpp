@@ -0,0 +1,424 @@
+#include "PrivateInclude.hpp"
+
+namespace e00 {
+namespace {
+constexpr int32_t Sign(int32_t value) { return (value > 0) - (value < 0); }
+
+// Min-heap order: lowest f first, the deepest node when f ties
+constexpr auto OpenOrder = [](const auto &a, const auto &b) {
+  return a.f > b.f || (a.f == b.f && a.g < b.g);
+};
+}// namespace
+
+void PathFinder::SetMap(const Map *map) {
+  _map = map;
+  _gridValid = false;
+}
+
+PathFinder::RequestState *PathFinder::Find(RequestId id) {
+  const auto slot = SlotOf(id);
+  if (slot >= _requests.size()) return nullptr;
+
+  auto &request = _requests[slot];
+  return request.generation == GenerationOf(id) && request.status != Status::Invalid ? &request : nullptr;
+}
+
+const PathFinder::RequestState *PathFinder::Find(RequestId id) const {
+  const auto slot = SlotOf(id);
+  if (slot >= _requests.size()) return nullptr;
+
+  const auto &request = _requests[slot];
+  return request.generation == GenerationOf(id) && request.status != Status::Invalid ? &request : nullptr;
+}
+
+void PathFinder::Refresh() {
+  if (_gridValid && _map && _map->Revision() == _mapRevision) {
+    return;
+  }
+
+  // Nothing found on the old tiles holds anymore, including a search half way through
+  _cache.clear();
+  if (_active != InvalidRequest) {
+    _pending.push_front(_active);
+    _active = InvalidRequest;
+  }
+
+  _gridValid = _map != nullptr;
+  _width = _map ? _map->Width() : 0;
+  _height = _map ? _map->Height() : 0;
+  if (!_map) {
+    _cells.clear();
+    return;
+  }
+  _mapRevision = _map->Revision();
+
+  const auto area = static_cast<size_t>(_width) * static_cast<size_t>(_height);
+  _cells.resize(area);
+  _uniformCost = true;
+  for (int32_t y = 0; y < _height; ++y) {
+    for (int32_t x = 0; x < _width; ++x) {
+      const auto options = _map->OptionsAt({static_cast<WorldCoordinateType>(x), static_cast<WorldCoordinateType>(y)});
+      _cells[CellOf(x, y)] = options.solid ? Blocked : options.cost;
+      _uniformCost = _uniformCost && (options.solid || options.cost == 0);
+    }
+  }
+
+  _g.resize(area);
+  _parent.resize(area);
+  _seen.assign(area, 0);
+  _closed.assign(area, 0);
+  _stamp = 0;
+}
+
+void PathFinder::Remember(const Query &query, const std::vector<Position> &path) {
+  if (_cache.size() >= CacheCapacity) {
+    _cache.clear();
+  }
+  _cache[CacheKey(query)] = path;
+}
+
+void PathFinder::Complete(RequestState &request, SearchResult result) {
+  request.path.clear();
+  if (result == SearchResult::Found) {
+    BuildPath(request.path);
+  }
+
+  request.status = result == SearchResult::Found ? Status::Found : Status::NoPath;
+  Remember(request.query, request.path);
+}
+
+bool PathFinder::FromCache(RequestState &request) {
+  const auto cached = _cache.find(CacheKey(request.query));
+  if (cached == _cache.end()) {
+    return false;
+  }
+
+  request.path = cached->second;
+  request.status = request.path.empty() ? Status::NoPath : Status::Found;
+  return true;
+}
+
+uint32_t PathFinder::Heuristic(uint32_t cell) const {
+  // Octile distance, never more than the cheapest path
+  const auto dx = static_cast<uint32_t>(std::abs(XOf(cell) - XOf(_goal)));
+  const auto dy = static_cast<uint32_t>(std::abs(YOf(cell) - YOf(_goal)));
+  return StraightCost * std::max(dx, dy) + (DiagonalCost - StraightCost) * std::min(dx, dy);
+}
+
+void PathFinder::BeginSearch(const Query &query) {
+  if (++_stamp == 0) {
+    std::ranges::fill(_seen, 0);
+    std::ranges::fill(_closed, 0);
+    _stamp = 1;
+  }
+
+  _open.clear();
+  _goal = CellOf(query.to.x, query.to.y);
+
+  const auto start = CellOf(query.from.x, query.from.y);
+  Reach(start, start, 0);
+}
+
+void PathFinder::Reach(uint32_t cell, uint32_t from, uint32_t g) {
+  if (_closed[cell] == _stamp || (_seen[cell] == _stamp && _g[cell] <= g)) {
+    return;
+  }
+
+  _seen[cell] = _stamp;
+  _g[cell] = g;
+  _parent[cell] = from;
+  _open.push_back({g + Heuristic(cell), g, cell});
+  std::ranges::push_heap(_open, OpenOrder);
+}
+
+PathFinder::SearchResult PathFinder::RunSearch(size_t budget) {
+  while (!_open.empty()) {
+    if (_work >= budget) {
+      return SearchResult::Running;
+    }
+
+    std::ranges::pop_heap(_open, OpenOrder);
+    const auto entry = _open.back();
+    _open.pop_back();
+
+    // Reached again for cheaper since this entry was pushed
+    if (_closed[entry.cell] == _stamp || entry.g != _g[entry.cell]) {
+      continue;
+    }
+
+    _closed[entry.cell] = _stamp;
+    ++_work;
+
+    if (entry.cell == _goal) {
+      return SearchResult::Found;
+    }
+    Expand(entry.cell);
+  }
+
+  return SearchResult::NoPath;
+}
+
+uint32_t PathFinder::Jump(int32_t x, int32_t y, int32_t dx, int32_t dy) {
+  while (true) {
+    ++_work;
+    if (!Walkable(x, y)) {
+      return NoCell;
+    }
+
+    const auto cell = CellOf(x, y);
+    if (cell == _goal) {
+      return cell;
+    }
+
+    if (dx != 0 && dy != 0) {
+      // Diagonal: stop where a straight line from here finds something
+      if (Jump(x + dx, y, dx, 0) != NoCell || Jump(x, y + dy, 0, dy) != NoCell) {
+        return cell;
+      }
+    } else if (dx != 0) {
+      // Horizontal: stop next to where a wall along the way ends
+      if ((Walkable(x, y - 1) && !Walkable(x - dx, y - 1)) || (Walkable(x, y + 1) && !Walkable(x - dx, y + 1))) {
+        return cell;
+      }
+    } else {
+      if ((Walkable(x - 1, y) && !Walkable(x - 1, y - dy)) || (Walkable(x + 1, y) && !Walkable(x + 1, y - dy))) {
+        return cell;
+      }
+    }
+
+    // No corner cutting
+    if (!Walkable(x + dx, y) || !Walkable(x, y + dy)) {
+      return NoCell;
+    }
+
+    x += dx;
+    y += dy;
+  }
+}
+
+void PathFinder::Expand(uint32_t cell) {
+  const auto x = XOf(cell);
+  const auto y = YOf(cell);
+
+  std::array<Vec2D<int32_t>, 8> directions;
+  size_t count = 0;
+  const auto add = [&](int32_t dx, int32_t dy) { directions[count++] = {dx, dy}; };
+
+  const auto parent = _parent[cell];
+  const auto dx = Sign(x - XOf(parent));
+  const auto dy = Sign(y - YOf(parent));
+
+  if (!_uniformCost || parent == cell) {
+    // Every neighbour
+    for (int32_t ny = -1; ny <= 1; ++ny) {
+      for (int32_t nx = -1; nx <= 1; ++nx) {
+        if ((nx == 0 && ny == 0) || !Walkable(x + nx, y + ny)) continue;
+        if (nx != 0 && ny != 0 && (!Walkable(x + nx, y) || !Walkable(x, y + ny))) continue;
+        add(nx, ny);
+      }
+    }
+  } else if (dx != 0 && dy != 0) {
+    // Jump point pruning: keep going the same way, plus what the way here couldn't reach
+    const bool horizontal = Walkable(x + dx, y);
+    const bool vertical = Walkable(x, y + dy);
+    if (vertical) add(0, dy);
+    if (horizontal) add(dx, 0);
+    if (horizontal && vertical) add(dx, dy);
+  } else if (dx != 0) {
+    const bool next = Walkable(x + dx, y);
+    const bool below = Walkable(x, y + 1);
+    const bool above = Walkable(x, y - 1);
+    if (next) {
+      add(dx, 0);
+      if (below) add(dx, 1);
+      if (above) add(dx, -1);
+    }
+    if (below) add(0, 1);
+    if (above) add(0, -1);
+  } else {
+    const bool next = Walkable(x, y + dy);
+    const bool right = Walkable(x + 1, y);
+    const bool left = Walkable(x - 1, y);
+    if (next) {
+      add(0, dy);
+      if (right) add(1, dy);
+      if (left) add(-1, dy);
+    }
+    if (right) add(1, 0);
+    if (left) add(-1, 0);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const auto [nx, ny] = directions[i];
+    const auto stepCost = nx != 0 && ny != 0 ? DiagonalCost : StraightCost;
+
+    if (_uniformCost) {
+      const auto jumpPoint = Jump(x + nx, y + ny, nx, ny);
+      if (jumpPoint == NoCell) continue;
+
+      const auto steps = std::max(std::abs(XOf(jumpPoint) - x), std::abs(YOf(jumpPoint) - y));
+      Reach(jumpPoint, cell, _g[cell] + static_cast<uint32_t>(steps) * stepCost);
+    } else {
+      const auto next = CellOf(x + nx, y + ny);
+      Reach(next, cell, _g[cell] + stepCost * (1 + _cells[next]));
+    }
+  }
+}
+
+void PathFinder::BuildPath(std::vector<Position> &path) const {
+  // Back from the goal, filling in the straight runs between jump points
+  auto cell = _goal;
+  auto x = XOf(cell);
+  auto y = YOf(cell);
+  path.push_back({static_cast<WorldCoordinateType>(x), static_cast<WorldCoordinateType>(y)});
+
+  while (_parent[cell] != cell) {
+    const auto parent = _parent[cell];
+    const auto px = XOf(parent);
+    const auto py = YOf(parent);
+    const auto dx = Sign(px - x);
+    const auto dy = Sign(py - y);
+
+    while (x != px || y != py) {
+      x += dx;
+      y += dy;
+      path.push_back({static_cast<WorldCoordinateType>(x), static_cast<WorldCoordinateType>(y)});
+    }
+    cell = parent;
+  }
+
+  std::ranges::reverse(path);
+}
+
+PathFinder::RequestId PathFinder::Request(const Position &from, const Position &to) {
+  Refresh();
+
+  uint16_t slot;
+  if (!_freeRequests.empty()) {
+    slot = _freeRequests.back();
+    _freeRequests.pop_back();
+  } else {
+    // Keep the last slot out, its id could be InvalidRequest
+    if (_requests.size() >= std::numeric_limits<uint16_t>::max()) {
+      return InvalidRequest;
+    }
+    slot = static_cast<uint16_t>(_requests.size());
+    _requests.emplace_back();
+  }
+
+  auto &request = _requests[slot];
+  request.query = {from, to};
+  request.status = Status::Pending;
+  request.path.clear();
+
+  const RequestId id = slot | (static_cast<RequestId>(request.generation) << 16);
+  if (!InMap(from) || !InMap(to) || !Walkable(to.x, to.y)) {
+    request.status = Status::NoPath;
+  } else if (!FromCache(request)) {
+    _pending.push_back(id);
+  }
+
+  return id;
+}
+
+void PathFinder::Request(std::span<const Query> queries, std::vector<RequestId> &ids) {
+  ids.reserve(ids.size() + queries.size());
+  for (const auto &query : queries) {
+    ids.push_back(Request(query.from, query.to));
+  }
+}
+
+size_t PathFinder::Process(size_t budget) {
+  Refresh();
+  _work = 0;
+
+  while (_work < budget) {
+    if (_active == InvalidRequest) {
+      if (_pending.empty()) {
+        break;
+      }
+
+      const auto id = _pending.front();
+      _pending.pop_front();
+
+      // An earlier request of the batch may have found the same path
+      auto *request = Find(id);
+      if (!request || request->status != Status::Pending || FromCache(*request)) {
+        continue;
+      }
+
+      BeginSearch(request->query);
+      _active = id;
+    }
+
+    const auto result = RunSearch(budget);
+    if (result == SearchResult::Running) {
+      break;
+    }
+
+    if (auto *request = Find(_active)) {
+      Complete(*request, result);
+    }
+    _active = InvalidRequest;
+  }
+
+  return _work;
+}
+
+PathFinder::Status PathFinder::StatusOf(RequestId id) const {
+  const auto *request = Find(id);
+  return request ? request->status : Status::Invalid;
+}
+
+std::span<const Position> PathFinder::PathOf(RequestId id) const {
+  const auto *request = Find(id);
+  return request ? std::span<const Position>(request->path) : std::span<const Position>();
+}
+
+void PathFinder::Release(RequestId id) {
+  auto *request = Find(id);
+  if (!request) {
+    return;
+  }
+
+  request->status = Status::Invalid;
+  request->path.clear();
+  ++request->generation;
+  _freeRequests.push_back(SlotOf(id));
+
+  if (_active == id) {
+    _active = InvalidRequest;
+  }
+  std::erase(_pending, id);
+}
+
+bool PathFinder::FindPath(const Position &from, const Position &to, std::vector<Position> &path) {
+  Refresh();
+  path.clear();
+
+  if (!InMap(from) || !InMap(to) || !Walkable(to.x, to.y)) {
+    return false;
+  }
+
+  const Query query{from, to};
+  if (const auto cached = _cache.find(CacheKey(query)); cached != _cache.end()) {
+    path = cached->second;
+    return !path.empty();
+  }
+
+  // The buffers are shared, the interrupted search starts over
+  if (_active != InvalidRequest) {
+    _pending.push_front(_active);
+    _active = InvalidRequest;
+  }
+
+  BeginSearch(query);
+  const auto result = RunSearch(std::numeric_limits<size_t>::max());
+  if (result == SearchResult::Found) {
+    BuildPath(path);
+  }
+
+  Remember(query, path);
+  return result == SearchResult::Found;
+}
+}// namespace e00
@@ -0,0 +1,282 @@
+#include "PixelConvert.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define E00_PIXEL_CONVERT_SSE2
+#include <emmintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define E00_PIXEL_CONVERT_AVX2
+#include <immintrin.h>
+#define E00_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace e00::impl::pixel {
+namespace {
+
+/******************************************************************************
+ *
+ * Scalar, used everywhere and for the tails of the vector versions
+ *
+ *****************************************************************************/
+
+uint32_t Expand565(uint16_t p) {
+  const uint32_t r5 = (p >> 11) & 0x1Fu;
+  const uint32_t g6 = (p >> 5) & 0x3Fu;
+  const uint32_t b5 = p & 0x1Fu;
+
+  return (((r5 << 3) | (r5 >> 2)) << 16) | (((g6 << 2) | (g6 >> 4)) << 8) | ((b5 << 3) | (b5 >> 2));
+}
+
+uint16_t Compress8888(uint32_t p) {
+  return static_cast<uint16_t>(((p >> 8) & 0xF800u) | ((p >> 5) & 0x07E0u) | ((p >> 3) & 0x001Fu));
+}
+
+uint32_t SwapRedBlue(uint32_t p) {
+  return ((p >> 16) & 0xFFu) | (p & 0xFF00u) | ((p & 0xFFu) << 16);
+}
+
+void Rgb565ToXrgb8888_Scalar(const uint8_t *src, uint8_t *dst, size_t width) {
+  for (size_t x = 0; x < width; ++x) {
+    uint16_t p;
+    std::memcpy(&p, src + x * 2, 2);
+    const uint32_t out = Expand565(p);
+    std::memcpy(dst + x * 4, &out, 4);
+  }
+}
+
+void Xrgb8888ToRgb565_Scalar(const uint8_t *src, uint8_t *dst, size_t width) {
+  for (size_t x = 0; x < width; ++x) {
+    uint32_t p;
+    std::memcpy(&p, src + x * 4, 4);
+    const uint16_t out = Compress8888(p);
+    std::memcpy(dst + x * 2, &out, 2);
+  }
+}
+
+void SwapRedBlue8888_Scalar(const uint8_t *src, uint8_t *dst, size_t width) {
+  for (size_t x = 0; x < width; ++x) {
+    uint32_t p;
+    std::memcpy(&p, src + x * 4, 4);
+    p = SwapRedBlue(p);
+    std::memcpy(dst + x * 4, &p, 4);
+  }
+}
+
+void ExpandIndexed32_Scalar(const uint8_t *src, uint8_t *dst, size_t width, const uint32_t *lut) {
+  for (size_t x = 0; x < width; ++x) {
+    std::memcpy(dst + x * 4, &lut[src[x]], 4);
+  }
+}
+
+#ifdef E00_PIXEL_CONVERT_SSE2
+/******************************************************************************
+ *
+ * SSE2, always available on x86-64
+ *
+ *****************************************************************************/
+
+__m128i Expand565_SSE2(__m128i p) {
+  const __m128i mask5 = _mm_set1_epi32(0x1F);
+  const __m128i mask6 = _mm_set1_epi32(0x3F);
+
+  const __m128i r5 = _mm_and_si128(_mm_srli_epi32(p, 11), mask5);
+  const __m128i g6 = _mm_and_si128(_mm_srli_epi32(p, 5), mask6);
+  const __m128i b5 = _mm_and_si128(p, mask5);
+
+  const __m128i r8 = _mm_or_si128(_mm_slli_epi32(r5, 3), _mm_srli_epi32(r5, 2));
+  const __m128i g8 = _mm_or_si128(_mm_slli_epi32(g6, 2), _mm_srli_epi32(g6, 4));
+  const __m128i b8 = _mm_or_si128(_mm_slli_epi32(b5, 3), _mm_srli_epi32(b5, 2));
+
+  return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r8, 16), _mm_slli_epi32(g8, 8)), b8);
+}
+
+__m128i Compress8888_SSE2(__m128i p) {
+  const __m128i r = _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xF800));
+  const __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0));
+  const __m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001F));
+  const __m128i v = _mm_or_si128(_mm_or_si128(r, g), b);
+
+  // Sign-extend the low 16 bits so the signed saturating pack keeps the bit pattern as-is
+  return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
+
+__m128i SwapRedBlue_SSE2(__m128i p) {
+  const __m128i low = _mm_set1_epi32(0xFF);
+  const __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), low);
+  const __m128i g = _mm_and_si128(p, _mm_set1_epi32(0xFF00));
+  const __m128i b = _mm_slli_epi32(_mm_and_si128(p, low), 16);
+  return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+void Rgb565ToXrgb8888_SSE2(const uint8_t *src, uint8_t *dst, size_t width) {
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), Expand565_SSE2(_mm_unpacklo_epi16(p, zero)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 16), Expand565_SSE2(_mm_unpackhi_epi16(p, zero)));
+  }
+
+  Rgb565ToXrgb8888_Scalar(src + x * 2, dst + x * 4, width - x);
+}
+
+void Xrgb8888ToRgb565_SSE2(const uint8_t *src, uint8_t *dst, size_t width) {
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4 + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 2), _mm_packs_epi32(Compress8888_SSE2(lo), Compress8888_SSE2(hi)));
+  }
+
+  Xrgb8888ToRgb565_Scalar(src + x * 4, dst + x * 2, width - x);
+}
+
+void SwapRedBlue8888_SSE2(const uint8_t *src, uint8_t *dst, size_t width) {
+  size_t x = 0;
+  for (; x + 4 <= width; x += 4) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), SwapRedBlue_SSE2(p));
+  }
+
+  SwapRedBlue8888_Scalar(src + x * 4, dst + x * 4, width - x);
+}
+#endif
+
+#ifdef E00_PIXEL_CONVERT_AVX2
+/******************************************************************************
+ *
+ * AVX2, only used when the CPU reports it
+ *
+ *****************************************************************************/
+
+E00_TARGET_AVX2 __m256i Expand565_AVX2(__m256i p) {
+  const __m256i mask5 = _mm256_set1_epi32(0x1F);
+  const __m256i mask6 = _mm256_set1_epi32(0x3F);
+
+  const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(p, 11), mask5);
+  const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(p, 5), mask6);
+  const __m256i b5 = _mm256_and_si256(p, mask5);
+
+  const __m256i r8 = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+  const __m256i g8 = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+  const __m256i b8 = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+
+  return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r8, 16), _mm256_slli_epi32(g8, 8)), b8);
+}
+
+E00_TARGET_AVX2 __m256i Compress8888_AVX2(__m256i p) {
+  const __m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 8), _mm256_set1_epi32(0xF800));
+  const __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0));
+  const __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x001F));
+  const __m256i v = _mm256_or_si256(_mm256_or_si256(r, g), b);
+  return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+
+E00_TARGET_AVX2 void Rgb565ToXrgb8888_AVX2(const uint8_t *src, uint8_t *dst, size_t width) {
+  size_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2 + 16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), Expand565_AVX2(_mm256_cvtepu16_epi32(lo)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4 + 32), Expand565_AVX2(_mm256_cvtepu16_epi32(hi)));
+  }
+
+  Rgb565ToXrgb8888_SSE2(src + x * 2, dst + x * 4, width - x);
+}
+
+E00_TARGET_AVX2 void Xrgb8888ToRgb565_AVX2(const uint8_t *src, uint8_t *dst, size_t width) {
+  size_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4 + 32));
+
+    // The pack works per 128-bit lane, put the quadwords back in order afterwards
+    const __m256i packed = _mm256_packs_epi32(Compress8888_AVX2(lo), Compress8888_AVX2(hi));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 2), _mm256_permute4x64_epi64(packed, 0xD8));
+  }
+
+  Xrgb8888ToRgb565_SSE2(src + x * 4, dst + x * 2, width - x);
+}
+
+E00_TARGET_AVX2 void SwapRedBlue8888_AVX2(const uint8_t *src, uint8_t *dst, size_t width) {
+  const __m256i low = _mm256_set1_epi32(0xFF);
+  const __m256i green = _mm256_set1_epi32(0xFF00);
+
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4));
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 16), low);
+    const __m256i g = _mm256_and_si256(p, green);
+    const __m256i b = _mm256_slli_epi32(_mm256_and_si256(p, low), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), _mm256_or_si256(_mm256_or_si256(r, g), b));
+  }
+
+  SwapRedBlue8888_SSE2(src + x * 4, dst + x * 4, width - x);
+}
+
+E00_TARGET_AVX2 void ExpandIndexed32_AVX2(const uint8_t *src, uint8_t *dst, size_t width, const uint32_t *lut) {
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x)));
+    const __m256i px = _mm256_i32gather_epi32(reinterpret_cast<const int *>(lut), idx, 4);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), px);
+  }
+
+  ExpandIndexed32_Scalar(src + x, dst + x * 4, width - x, lut);
+}
+#endif
+
+/******************************************************************************
+ *
+ * Dispatch
+ *
+ *****************************************************************************/
+
+struct Kernels {
+  void (*rgb565ToXrgb8888)(const uint8_t *, uint8_t *, size_t);
+  void (*xrgb8888ToRgb565)(const uint8_t *, uint8_t *, size_t);
+  void (*swapRedBlue8888)(const uint8_t *, uint8_t *, size_t);
+  void (*expandIndexed32)(const uint8_t *, uint8_t *, size_t, const uint32_t *);
+};
+
+Kernels SelectKernels() {
+#ifdef E00_PIXEL_CONVERT_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return {&Rgb565ToXrgb8888_AVX2, &Xrgb8888ToRgb565_AVX2, &SwapRedBlue8888_AVX2, &ExpandIndexed32_AVX2};
+  }
+#endif
+
+#ifdef E00_PIXEL_CONVERT_SSE2
+  return {&Rgb565ToXrgb8888_SSE2, &Xrgb8888ToRgb565_SSE2, &SwapRedBlue8888_SSE2, &ExpandIndexed32_Scalar};
+#else
+  return {&Rgb565ToXrgb8888_Scalar, &Xrgb8888ToRgb565_Scalar, &SwapRedBlue8888_Scalar, &ExpandIndexed32_Scalar};
+#endif
+}
+
+const Kernels &ActiveKernels() {
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+}// namespace
+
+void Rgb565ToXrgb8888(const uint8_t *src, uint8_t *dst, size_t width) {
+  ActiveKernels().rgb565ToXrgb8888(src, dst, width);
+}
+
+void Xrgb8888ToRgb565(const uint8_t *src, uint8_t *dst, size_t width) {
+  ActiveKernels().xrgb8888ToRgb565(src, dst, width);
+}
+
+void SwapRedBlue8888(const uint8_t *src, uint8_t *dst, size_t width) {
+  ActiveKernels().swapRedBlue8888(src, dst, width);
+}
+
+void ExpandIndexed32(const uint8_t *src, uint8_t *dst, size_t width, const uint32_t *lut) {
+  ActiveKernels().expandIndexed32(src, dst, width, lut);
+}
+
+}// namespace e00::impl::pixel
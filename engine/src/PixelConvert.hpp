@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace e00::impl::pixel {
+/**
+ * Pixel format converters working on whole rows.
+ *
+ * On x86-64 these are dispatched at runtime to SSE2 or AVX2 implementations depending on the CPU;
+ * every other target (including the i386 DOS build) uses the portable scalar versions.
+ *
+ * Pointers don't need to be aligned, `src` and `dst` must not overlap (except for SwapRedBlue8888,
+ * which can be done in place).
+ */
+
+// RGB565 (r: 11, g: 5, b: 0) to XRGB8888 (r: 16, g: 8, b: 0), channels are scaled up with bit replication
+void Rgb565ToXrgb8888(const uint8_t *src, uint8_t *dst, size_t width);
+
+// XRGB8888 (r: 16, g: 8, b: 0) to RGB565 (r: 11, g: 5, b: 0), channels are truncated
+void Xrgb8888ToRgb565(const uint8_t *src, uint8_t *dst, size_t width);
+
+// XRGB8888 <-> XBGR8888; the X byte is cleared
+void SwapRedBlue8888(const uint8_t *src, uint8_t *dst, size_t width);
+
+// 8-bit indices through a table of already packed 32-bit pixels; the table must hold 256 entries
+void ExpandIndexed32(const uint8_t *src, uint8_t *dst, size_t width, const uint32_t *lut);
+
+}// namespace e00::impl::pixel
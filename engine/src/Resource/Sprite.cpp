@@ -26,6 +26,11 @@ std::unique_ptr<Sprite> Sprite::Create(const Vec2D<BitmapSizeType> &size, BitDep
 
 Sprite::~Sprite() = default;
 
+size_t Sprite::MemoryUsage() const {
+  // Every frame is a full bitmap
+  return DrawableResource::MemoryUsage() * static_cast<size_t>(std::ranges::count_if(_images, [](const auto &image) { return image != nullptr; }));
+}
+
 std::unique_ptr<Sprite> Sprite::Create(const Vec2D<BitmapSizeType> &size, BitDepth bit_depth, FixedPalette palette) {
   return std::unique_ptr<Sprite>(new Sprite(size, bit_depth, std::move(palette)));
 }
@@ -92,6 +97,20 @@ std::unique_ptr<Painter> Sprite::BeginDraw() {
   return nullptr;
 }
 
+DrawableSurface::TargetInformation Sprite::GetNativeFormat() const {
+  if (const auto *image = GetCurrentImage()) {
+    return {GetBitDepth(), &_palette, image->bitmap->GetShift(), image->bitmap->GetMask()};
+  }
+  return {GetBitDepth(), &_palette, {}, {}};
+}
+
+std::span<const uint8_t> Sprite::GetNativeLine(BitmapSizeType y) const {
+  if (const auto *image = GetCurrentImage(); image && y < Size().y) {
+    return std::as_const(*image->bitmap).GetLineSpan(y);
+  }
+  return {};
+}
+
 void Sprite::ReadLineInto(
     BitmapSizeType line,
     BitmapSizeType startX, BitmapSizeType endX,
@@ -101,6 +120,15 @@ void Sprite::ReadLineInto(
   }
 }
 
+void Sprite::ReadLinesInto(
+    BitmapSizeType firstLine, BitmapSizeType lineCount,
+    BitmapSizeType startX, BitmapSizeType endX,
+    const TargetInformation &targetInformation, std::span<uint8_t> targetBuffer, size_t targetStride) const {
+  if (const auto *image = GetCurrentImage()) {
+    image->bitmap->ReadLinesInto(firstLine, lineCount, startX, endX, targetInformation, GetBitDepth(), _palette, targetBuffer, targetStride);
+  }
+}
+
 std::error_code Sprite::AddFrame(ResourcePtrT<Bitmap> data, std::chrono::milliseconds duration) {
   if (!data) {
     return std::make_error_code(std::errc::invalid_argument);
@@ -2,11 +2,114 @@
 
 #include "PrivateInclude.hpp"
 
+#include "Platform.hpp"
+#include "SpinLock.hpp"
+
 namespace {
 std::unique_ptr<e00::ResourceManager> _globalResourceManager;
+
+// Resources needed by the load in progress on this thread, nullptr when not loading
+thread_local std::vector<e00::ResourceManager::ResourceKey> *_loadDependencies = nullptr;
+
+void AddDependency(std::vector<e00::ResourceManager::ResourceKey> &dependencies, const e00::ResourceManager::ResourceKey &key) {
+  if (std::ranges::find(dependencies, key) == dependencies.end()) {
+    dependencies.push_back(key);
+  }
+}
 }// namespace
 
 namespace e00 {
+std::error_code detail::ControlBlock::EnsureLoaded() {
+  const impl::SpinLockGuard lock(_load_lock);
+
+  // Loaded by another thread while this one waited
+  if (_resource.load(std::memory_order_acquire)) {
+    return {};
+  }
+  return OnLoadLazyResource();
+}
+
+/**
+ * Control block of a resource loaded in the background. Not loaded until the load is delivered, then it
+ * can be unloaded and loaded again, synchronously, like a lazy resource.
+ */
+class ResourceManager::AsyncControlBlock : public detail::ControlBlock {
+  ResourceManager *const _owner;
+  const std::vector<std::unique_ptr<LoadOption>> _opts;
+  const std::vector<LoadOption *> _opt_ptrs;
+  std::error_code _status = std::make_error_code(std::errc::resource_unavailable_try_again);
+
+  static std::vector<LoadOption *> PointersTo(const std::vector<std::unique_ptr<LoadOption>> &opts) {
+    std::vector<LoadOption *> ptrs;
+    ptrs.reserve(opts.size());
+    for (const auto &opt: opts) ptrs.push_back(opt.get());
+    return ptrs;
+  }
+
+public:
+  AsyncControlBlock(ResourceManager *owner, ResourceId id, type_t type, std::vector<std::unique_ptr<LoadOption>> &&opts)
+      : ControlBlock(id, type),
+        _owner(owner),
+        _opts(std::move(opts)),
+        _opt_ptrs(PointersTo(_opts)) {}
+
+  ~AsyncControlBlock() override { delete _resource; }
+
+  [[nodiscard]] std::span<LoadOption *const> Options() const { return _opt_ptrs; }
+
+  void Deliver(std::expected<std::unique_ptr<Resource>, std::error_code> &&result) {
+    if (result) {
+      _resource = result.value().release();
+      _owner->ResourceLoaded(*this);
+      _status = {};
+
+      // Nothing wants it anymore, treat it like any other resource that lost its last reference
+      if (UseCount() == 0) {
+        OnZeroShared();
+      }
+    } else {
+      _status = result.error();
+    }
+  }
+
+  [[nodiscard]] bool IsReloadable() const override { return !_status; }
+
+  std::error_code OnLoadLazyResource() override {
+    // Still in flight, or failed
+    if (_status) {
+      return _status;
+    }
+
+    // Unloaded since, load it again right away
+    if (auto resource = _owner->LoadResource(id(), type(), Options()); resource) {
+      _resource = resource.value().release();
+      _owner->ResourceLoaded(*this);
+      return {};
+    }
+    return std::make_error_code(std::errc::no_such_file_or_directory);
+  }
+
+protected:
+  void OnZeroShared() noexcept override {
+    if (_owner->KeepsUnreferencedResources() && IsReloadable()) {
+      return;
+    }
+
+    _owner->ResourceUnloaded(*this);
+    delete _resource;
+    _resource = nullptr;
+  }
+};
+
+struct ResourceManager::AsyncLoad {
+  AsyncControlBlock *cb;
+  std::expected<std::unique_ptr<Resource>, std::error_code> result;
+  std::atomic<bool> claimed{false};// << Set by whoever runs the load, the worker or Tick()
+  std::atomic<bool> done{false};   // << `result` is ready
+  bool started{};
+  uint32_t ticks_waited{};
+};
+
 ResourceManager &ResourceManager::GlobalResourceManager() {
   if (!_globalResourceManager) {
     _globalResourceManager = std::unique_ptr<ResourceManager>(new ResourceManager);
@@ -34,20 +137,46 @@ std::error_code ResourceManager::AddLoader(std::unique_ptr<ResourceLoader> &&loa
 }
 
 void ResourceManager::SetAlias(ResourceId id, std::string_view real_name) {
-  _aliases.emplace_back(id, std::string(real_name));
+  // Kept sorted so lookups are a binary search; setting an alias again replaces it
+  AliasEntry entry{id, std::string(real_name)};
+  if (const auto it = std::lower_bound(_aliases.begin(), _aliases.end(), entry);
+      it != _aliases.end() && it->id == id) {
+    it->filename = std::move(entry.filename);
+  } else {
+    _aliases.insert(it, std::move(entry));
+  }
 }
 
 ResourceManager::ResourceManager()
     : _stream_factory(StreamFactory::GlobalStreamFactory()) {
 }
 
+ResourceManager::~ResourceManager() {
+  // Workers may still be using this manager, wait for them
+  for (const auto &load: _async_loads) {
+    if (load->started && load->claimed.exchange(true, std::memory_order_acq_rel)) {
+      while (!load->done.load(std::memory_order_acquire)) {
+        platform::Yield();
+      }
+    }
+  }
+
+  // Resources may reference each other: drop them all while every block is still there
+  _tearing_down = true;
+  for (const auto &[_, cb]: _loaded_resources_cb) {
+    cb->Unload();
+  }
+}
+
 std::unique_ptr<Stream> ResourceManager::FindStreamForResource(ResourceId id, type_t type) {
-  const auto aliasIt = std::ranges::find_if(_aliases, [&](const auto &alias) {
-    return alias.id == id;
-  });
+  // Packed resources are found by id, no alias needed
+  if (auto packed = _stream_factory.OpenResourceStream(id)) {
+    return packed;
+  }
 
-  if (aliasIt != _aliases.end()) {
-    GetDefaultLogger().Info(source_location::current(), "Alias found for {} -> {}", id, aliasIt->filename);
+  const auto aliasIt = std::lower_bound(_aliases.begin(), _aliases.end(), AliasEntry{id, {}});
+  if (aliasIt != _aliases.end() && aliasIt->id == id) {
+    GetDefaultLogger().Verbose(source_location::current(), "Alias found for {} -> {}", id, aliasIt->filename);
     return _stream_factory.OpenStream(aliasIt->filename);
   }
 
@@ -56,15 +185,46 @@ std::unique_ptr<Stream> ResourceManager::FindStreamForResource(ResourceId id, ty
 }
 
 detail::ControlBlock *ResourceManager::FindKnownControlBlockFor(ResourceId id, type_t type) const {
+  const impl::SpinLockGuard lock(_cb_lock);
+
   // Do we know about this resource already?
-  for (const auto &a: _loaded_resources_cb) {
-    if (a->type() == type && a->id() == id) {
-      GetDefaultLogger().Info(source_location::current(), "Resource {} of type {} already known", id, type);
-      return a.get();
-    }
+  const auto known = _known_resources.find({id, type});
+  if (known == _known_resources.end()) {
+    return nullptr;
   }
 
-  return nullptr;
+  NoteDependency({id, type});
+  return known->second;
+}
+
+void ResourceManager::NoteDependency(const ResourceKey &key) {
+  if (_loadDependencies) {
+    AddDependency(*_loadDependencies, key);
+  }
+}
+
+void ResourceManager::SetDependencies(const ResourceKey &key, std::vector<ResourceKey> dependencies) {
+  const impl::SpinLockGuard lock(_cb_lock);
+  _dependencies[key] = std::move(dependencies);
+}
+
+std::vector<ResourceManager::ResourceKey> ResourceManager::DependenciesOf(const ResourceKey &key) const {
+  const impl::SpinLockGuard lock(_cb_lock);
+  const auto it = _dependencies.find(key);
+  return it != _dependencies.end() ? it->second : std::vector<ResourceKey>{};
+}
+
+detail::ControlBlock *ResourceManager::AddControlBlock(std::unique_ptr<detail::ControlBlock> &&cb) {
+  auto *const added = cb.get();
+  const impl::SpinLockGuard lock(_cb_lock);
+
+  // Resources without a name (TakeOwnership) can't be looked up, no need to index them
+  if (added->id() != 0) {
+    _known_resources[{added->id(), added->type()}] = added;
+  }
+
+  _loaded_resources_cb.emplace(added, std::move(cb));
+  return added;
 }
 
 detail::ControlBlock *ResourceManager::MakeMemoryContainer(ResourceId id, type_t type, std::unique_ptr<Resource> &&theResource, const source_location &from) {
@@ -76,20 +236,24 @@ detail::ControlBlock *ResourceManager::MakeMemoryContainer(ResourceId id, type_t
         : ControlBlock(n, t),
           _owner(e) {
       _resource = r.release();
+      _owner->ResourceLoaded(*this);
     }
 
-    ~R() override { _owner->EraseControlBlock(this); }
+    ~R() override { delete _resource; }
 
     std::error_code OnLoadLazyResource() override { return std::make_error_code(std::errc::not_supported); }
 
   protected:
+    // Can't be loaded again, nothing is left to find: the block goes too, and a later lookup starts over
     void OnZeroShared() noexcept override {
-      delete _resource;
-      _resource = nullptr;
+      _owner->ResourceUnloaded(*this);
+
+      // Destroys this block
+      _owner->EraseControlBlock(this);
     }
   };
 
-  auto const &ret = _loaded_resources_cb.emplace_back(
+  auto *const ret = AddControlBlock(
       std::make_unique<R>(
           this,
           type,
@@ -97,7 +261,7 @@ detail::ControlBlock *ResourceManager::MakeMemoryContainer(ResourceId id, type_t
           std::move(theResource)));
 
   GetDefaultLogger().Info(source_location::current(), "Memory create resource {} of type {}", id, type);
-  return ret.get();
+  return ret;
 }
 
 bool ResourceManager::CanLoad(ResourceId id, type_t type) {
@@ -120,6 +284,24 @@ bool ResourceManager::CanLoad(ResourceId id, type_t type) {
 }
 
 std::expected<std::unique_ptr<Resource>, std::error_code> ResourceManager::LoadResource(ResourceId resource_id, type_t resource_type, std::span<LoadOption *const> options) {
+  // Whoever is loading needs this one, and whatever this one needs
+  const ResourceKey key{resource_id, resource_type};
+  NoteDependency(key);
+  std::vector<ResourceKey> dependencies;
+  auto *const outer = std::exchange(_loadDependencies, &dependencies);
+  auto loaded = LoadResourceFromStream(resource_id, resource_type, options);
+  _loadDependencies = outer;
+
+  if (loaded) {
+    if (outer) {
+      for (const auto &dependency: dependencies) AddDependency(*outer, dependency);
+    }
+    SetDependencies(key, std::move(dependencies));
+  }
+  return loaded;
+}
+
+std::expected<std::unique_ptr<Resource>, std::error_code> ResourceManager::LoadResourceFromStream(ResourceId resource_id, type_t resource_type, std::span<LoadOption *const> options) {
   // Find the stream
   if (const auto stream = FindStreamForResource(resource_id, resource_type)) {
     GetDefaultLogger().Info(source_location::current(), "Loading resource {} of type {}", resource_id, resource_type);
@@ -151,25 +333,168 @@ std::expected<std::unique_ptr<Resource>, std::error_code> ResourceManager::LoadR
 }
 
 bool ResourceManager::EraseControlBlock(detail::ControlBlock *cb) {
-  GetDefaultLogger().Info(source_location::current(), "Erasing control block {}", cb->id());
+  GetDefaultLogger().Verbose(source_location::current(), "Erasing control block {}", cb->id());
 
-  // Find the control block
-  const auto i = std::ranges::find_if(_loaded_resources_cb,
-                                      [&cb](const auto &uptr) {
-                                        return uptr.get() == cb;
-                                      });
+  // The destructor owns them all by now
+  if (_tearing_down) {
+    return false;
+  }
 
-  if (i != _loaded_resources_cb.end()) {
-    _loaded_resources_cb.erase(i);
-    return true;
+  // Destroyed once the lock is released: its resource may hold the last reference to another one
+  std::unique_ptr<detail::ControlBlock> erased;
+  {
+    const impl::SpinLockGuard lock(_cb_lock);
+
+    // Find the control block
+    auto node = _loaded_resources_cb.extract(cb);
+    if (node.empty()) {
+      return false;
+    }
+
+    if (const auto known = _known_resources.find({cb->id(), cb->type()});
+        known != _known_resources.end() && known->second == cb) {
+      _known_resources.erase(known);
+    }
+    erased = std::move(node.mapped());
   }
 
-  return false;
+  return true;
+}
+
+detail::ControlBlock *ResourceManager::QueueAsyncLoad(ResourceId id, type_t type, std::vector<std::unique_ptr<LoadOption>> &&options) {
+  auto *const cb = static_cast<AsyncControlBlock *>(AddControlBlock(
+      std::make_unique<AsyncControlBlock>(this, id, type, std::move(options))));
+
+  auto load = std::make_shared<AsyncLoad>();
+  load->cb = cb;
+  _async_loads.push_back(std::move(load));
+
+  GetDefaultLogger().Info(source_location::current(), "Queued background load of resource {} of type {}", id, type);
+  StartAsyncLoads();
+  return cb;
+}
+
+void ResourceManager::StartAsyncLoads() {
+  while (_async_in_flight < detail::BackgroundLoadsInFlight && _async_in_flight < _async_loads.size()) {
+    const auto &load = _async_loads[_async_in_flight];
+    load->started = true;
+    ++_async_in_flight;
+
+    // A thread that never runs would hold its slot and stack forever, Tick() does the load
+    if constexpr (!detail::BackgroundLoadThreads) {
+      continue;
+    }
+
+    // The worker keeps the load alive; if it never runs, Tick() claims the load instead
+    const auto thread = platform::CreateThread([this, load]() {
+      if (!load->claimed.exchange(true, std::memory_order_acq_rel)) {
+        RunAsyncLoad(*load);
+      }
+    });
+
+    if (thread == platform::InvalidThreadId) {
+      GetDefaultLogger().Info(source_location::current(), "No thread for background load of {}, loading during Tick()", load->cb->id());
+    }
+  }
+}
+
+void ResourceManager::RunAsyncLoad(AsyncLoad &load) {
+  load.result = LoadResource(load.cb->id(), load.cb->type(), load.cb->Options());
+  load.done.store(true, std::memory_order_release);
+}
+
+void ResourceManager::CompleteAsyncLoads(const bool wait) {
+  bool loadedHere = false;
+  do {
+    // Started loads come first
+    for (auto it = _async_loads.begin(); it != _async_loads.end() && (*it)->started;) {
+      auto &load = **it;
+
+      // No worker picked it up (no threads on this platform, or none left): load it here, one per tick unless waiting
+      const bool noWorker = !detail::BackgroundLoadThreads || ++load.ticks_waited > AsyncClaimTicks;
+      if ((wait || (noWorker && !loadedHere))
+          && !load.claimed.exchange(true, std::memory_order_acq_rel)) {
+        RunAsyncLoad(load);
+        loadedHere = true;
+      }
+
+      if (!load.done.load(std::memory_order_acquire)) {
+        ++it;
+        continue;
+      }
+
+      if (!load.result) {
+        GetDefaultLogger().Error(source_location::current(), "Background load of resource {} failed: {}", load.cb->id(), load.result.error().message());
+
+        // Later lookups try again rather than find the failure
+        const impl::SpinLockGuard lock(_cb_lock);
+        _known_resources.erase({load.cb->id(), load.cb->type()});
+      }
+      load.cb->Deliver(std::move(load.result));
+
+      it = _async_loads.erase(it);
+      --_async_in_flight;
+    }
+
+    StartAsyncLoads();
+    if (wait && !_async_loads.empty()) {
+      platform::Yield();
+    }
+  } while (wait && !_async_loads.empty());
+}
+
+void ResourceManager::ResourceLoaded(detail::ControlBlock &cb) noexcept {
+  if (const auto *resource = cb._resource.load(std::memory_order_relaxed)) {
+    const auto size = resource->MemoryUsage();
+    _memory_in_use.fetch_add(size, std::memory_order_relaxed);
+    _memory_in_use.fetch_sub(cb._memory_usage.exchange(size, std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+}
+
+void ResourceManager::ResourceUnloaded(detail::ControlBlock &cb) noexcept {
+  _memory_in_use.fetch_sub(cb._memory_usage.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
 void ResourceManager::Tick(const std::chrono::milliseconds delta) {
-  // Go through all the resources that need ticks
   std::ignore = delta;
+
+  CompleteAsyncLoads(false);
+
+  // Whatever is accessed from now on is stamped with the new tick
+  const auto lastTick = detail::ControlBlock::UseClock++;
+
+  // Nothing to look for under budget; without one, only what was kept under an earlier one, if anything.
+  // Background loads may be using resources they found loaded, leave them be until they are done
+  const auto budget = MemoryBudget();
+  const bool overBudget = budget != 0 ? MemoryInUse() > budget : _drop_unreferenced;
+  if (!overBudget || _async_in_flight > 0) {
+    return;
+  }
+
+  _unload_candidates.clear();
+  {
+    const impl::SpinLockGuard lock(_cb_lock);
+    for (const auto &[_, cb]: _loaded_resources_cb) {
+      // Referenced resources may be pointed to directly (the current map by the path finder), and edited
+      if (cb->IsLoaded() && cb->IsReloadable() && cb->UseCount() == 0 && (budget == 0 || cb->LastUsed() != lastTick)) {
+        _unload_candidates.push_back(cb.get());
+      }
+    }
+  }
+
+  // Least recently used first; without a budget, drop them all.
+  // Not under the lock: a resource may hold the last reference to one that is then erased
+  std::ranges::sort(_unload_candidates, {}, &detail::ControlBlock::LastUsed);
+  for (auto *cb: _unload_candidates) {
+    if (budget != 0 && MemoryInUse() <= budget) {
+      break;
+    }
+
+    GetDefaultLogger().Info(source_location::current(), "Unloading resource {} of type {} ({} bytes)", cb->id(), cb->type(), cb->_memory_usage.load(std::memory_order_relaxed));
+    ResourceUnloaded(*cb);
+    cb->Unload();
+  }
+  _drop_unreferenced = false;
 }
 
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Platform.hpp"
+
+#include <atomic>
+
+namespace e00::impl {
+/**
+ * Holds `flag` for as long as it lives, yielding while someone else holds it.
+ * For short sections shared with background loads.
+ */
+class SpinLockGuard {
+  std::atomic_flag &_flag;
+
+public:
+  explicit SpinLockGuard(std::atomic_flag &flag) : _flag(flag) {
+    while (_flag.test_and_set(std::memory_order_acquire)) {
+      platform::Yield();
+    }
+  }
+
+  ~SpinLockGuard() { _flag.clear(std::memory_order_release); }
+
+  SpinLockGuard(const SpinLockGuard &) = delete;
+  SpinLockGuard &operator=(const SpinLockGuard &) = delete;
+};
+}// namespace e00::impl
@@ -1,4 +1,5 @@
 #include "PrivateInclude.hpp"
+#include "Archive.hpp"
 #include "Platform.hpp"
 
 namespace {
@@ -6,6 +7,16 @@ std::unique_ptr<e00::StreamFactory> _streamFactory;
 
 class RootStreamFactory : public e00::StreamFactory {
   std::string _resource_directory;
+  std::shared_ptr<e00::impl::Archive> _archive;
+  size_t _block_size{e00::detail::StreamBlockSize};
+
+  // Streams in memory are already cheap to read in small pieces
+  [[nodiscard]] std::unique_ptr<e00::Stream> Buffered(std::unique_ptr<e00::Stream> &&stream) const {
+    if (!stream || _block_size == 0 || stream->Size() == 0 || !stream->Map().empty()) {
+      return std::move(stream);
+    }
+    return std::make_unique<e00::BufferedStream>(std::move(stream), _block_size);
+  }
 
 public:
   RootStreamFactory() : _resource_directory("res/") {};
@@ -13,7 +24,31 @@ public:
   ~RootStreamFactory() override = default;
 
   std::unique_ptr<e00::Stream> OpenStream(const std::string &name) override {
-    return platform::OpenStream(_resource_directory + name);
+    if (_archive) {
+      if (auto stream = _archive->OpenEntry(e00::HashName(name))) {
+        return Buffered(std::move(stream));
+      }
+    }
+    return Buffered(platform::OpenStream(_resource_directory + name));
+  }
+
+  std::unique_ptr<e00::Stream> OpenResourceStream(e00::ResourceId id) override {
+    return _archive ? Buffered(_archive->OpenEntry(id)) : nullptr;
+  }
+
+  std::error_code MountArchive(const std::string &name) override {
+    auto archive = e00::impl::Archive::Open(platform::OpenStream(_resource_directory + name));
+    if (!archive) {
+      return archive.error();
+    }
+
+    _archive = std::move(archive.value());
+    e00::GetDefaultLogger().Info(e00::source_location::current(), "Mounted {} with {} entries", name, _archive->EntryCount());
+    return {};
+  }
+
+  void SetStreamBlockSize(size_t blockSize) override {
+    _block_size = blockSize;
   }
 
   std::unique_ptr<e00::WritableStream> OpenStreamForWrite(const std::string &name) override {
@@ -3,58 +3,178 @@
 namespace e00 {
 World::World(std::string name)
     : _name(std::move(name)),
-      _map(nullptr) {
+      _map(nullptr),
+      _index(RectT<WorldCoordinateType>::maxArea()) {
+  _freeSlots.reserve(MaxActors);
+  for (auto i = MaxActors; i > 0; --i) {
+    _freeSlots.push_back(static_cast<uint16_t>(i - 1));
+  }
 }
 
 World::~World() = default;
 
+std::error_code World::AddMap(ResourcePtrT<e00::Map> &&map) {
+  _map = std::move(map);
+  _paths.SetMap(_map.get());
+
+  // Index only what the map covers, the tree is better balanced that way
+  const auto size = _map->Size();
+  _index.Reset({{0, 0}, size});
+  for (size_t i = 0; i < _numActors; i++) {
+    // Actors past the edge of a smaller map are pulled back onto its last row or column
+    const Vec2D<WorldCoordinateType> position{
+        std::min<WorldCoordinateType>(_x[i], size.x > 0 ? size.x - 1 : 0),
+        std::min<WorldCoordinateType>(_y[i], size.y > 0 ? size.y - 1 : 0)};
+    if (position.x != _x[i] || position.y != _y[i]) {
+      GetDefaultLogger().Warning(source_location::current(), "Actor {} at {},{} is outside of the new map, moved to {},{}", _handle[i], _x[i], _y[i], position.x, position.y);
+      _x[i] = position.x;
+      _y[i] = position.y;
+      _flags[i] |= FlagMoved;
+    }
+
+    if (!_index.Insert(_handle[i], position)) {
+      GetDefaultLogger().Error(source_location::current(), "Failed to index actor {} at {},{}", _handle[i], position.x, position.y);
+    }
+  }
+
+  return {};
+}
+
+void World::CopyActor(size_t from, size_t to) {
+  _actor[to] = _actor[from];
+  _x[to] = _x[from];
+  _y[to] = _y[from];
+  _width[to] = _width[from];
+  _height[to] = _height[from];
+  _body[to] = _body[from];
+  _flags[to] = _flags[from];
+  _handle[to] = _handle[from];
+  _slotIndex[SlotOf(_handle[to])] = static_cast<uint16_t>(to);
+}
+
 World::NodeID World::Insert(Actor *actor, const Vec2D<WorldCoordinateType> &position) {
   // Is this actor in this world ?
-  if (Size() < position) {
+  if (!RectT<WorldCoordinateType>({0, 0}, Size()).Contains(position)) {
     return InvalidNodeID;
   }
 
-  // Find first `null` actor
-  for (auto i = 0u; i < _elements.size(); i++) {
-    auto &element = _elements.at(i);
-    if (element.actor == nullptr) {
-      element.actor = actor;
-      element.position = position;
+  if (_freeSlots.empty()) {
+    return InvalidNodeID;
+  }
 
-      return i;
-    }
+  const auto slot = _freeSlots.back();
+  _freeSlots.pop_back();
+
+  const auto i = _numActors++;
+  const NodeID id = slot | (static_cast<NodeID>(_slotGeneration[slot]) << 16);
+  _slotIndex[slot] = static_cast<uint16_t>(i);
+
+  const auto size = actor->Size();
+  _actor[i] = actor;
+  _x[i] = position.x;
+  _y[i] = position.y;
+  _width[i] = size.x;
+  _height[i] = size.y;
+  _body[i] = actor->Type();
+  _flags[i] = 0;
+  _handle[i] = id;
+  if (!_index.Insert(id, position)) {
+    GetDefaultLogger().Error(source_location::current(), "Failed to index actor {} at {},{}", id, position.x, position.y);
+    --_numActors;
+    _freeSlots.push_back(slot);
+    return InvalidNodeID;
   }
 
-  return InvalidNodeID;
+  return id;
 }
 
 void World::Update(NodeID element, const Vec2D<WorldCoordinateType> &position) {
-  if (_elements.size() > element) {
-    if (Size() < position) {
-      return;
-    }
+  const auto i = IndexOf(element);
+  if (i == InvalidIndex) {
+    return;
+  }
 
-    auto &value = _elements.at(element);
-    value.position = position;
-    // Call updated position on actor ?
+  if (!RectT<WorldCoordinateType>({0, 0}, Size()).Contains(position)) {
+    return;
   }
+
+  if (!_index.Move(element, {_x[i], _y[i]}, position)) {
+    // The index still has the actor at its old position, keep the columns in agreement
+    GetDefaultLogger().Error(source_location::current(), "Failed to move actor {} from {},{} to {},{}", element, _x[i], _y[i], position.x, position.y);
+    return;
+  }
+
+  _x[i] = position.x;
+  _y[i] = position.y;
+  _flags[i] |= FlagMoved;
+
+  const auto size = _actor[i]->Size();
+  _width[i] = size.x;
+  _height[i] = size.y;
+  _body[i] = _actor[i]->Type();
+  // Call updated position on actor ?
 }
 
 void World::Remove(NodeID element) {
-  if (element < _elements.size()) {
-    auto &value = _elements.at(element);
-    value.actor = nullptr;
-    value.position = {};
+  const auto i = IndexOf(element);
+  if (i == InvalidIndex) {
+    return;
+  }
+
+  _index.Remove(element, {_x[i], _y[i]});
+
+  // Keep the columns packed: the last actor takes the hole
+  const auto last = --_numActors;
+  if (i != last) {
+    CopyActor(last, i);
   }
+  _actor[last] = nullptr;
+
+  // Outstanding handles to this slot stop resolving
+  const auto slot = SlotOf(element);
+  ++_slotGeneration[slot];
+  _freeSlots.push_back(slot);
 }
 
 bool World::ProcessAction(const ActionInstance &action) {
 }
 
 size_t World::NumActors() const {
-  return std::ranges::count_if(_elements, [](const auto &element) {
-    return element.actor != nullptr;
-  });
+  return _numActors;
+}
+
+World::ActorColumns World::Actors() const {
+  return {
+      {_actor.data(), _numActors},
+      {_x.data(), _numActors},
+      {_y.data(), _numActors},
+      {_width.data(), _numActors},
+      {_height.data(), _numActors},
+      {_body.data(), _numActors},
+      {_flags.data(), _numActors},
+      {_handle.data(), _numActors}};
+}
+
+Actor *World::GetActor(NodeID element) const {
+  const auto i = IndexOf(element);
+  return i != InvalidIndex ? _actor[i] : nullptr;
+}
+
+Vec2D<WorldCoordinateType> World::PositionOf(NodeID element) const {
+  const auto i = IndexOf(element);
+  return i != InvalidIndex ? Vec2D<WorldCoordinateType>{_x[i], _y[i]} : Vec2D<WorldCoordinateType>{};
+}
+
+RectT<WorldCoordinateType> World::BoundsOf(NodeID element) const {
+  const auto i = IndexOf(element);
+  return i != InvalidIndex ? RectT<WorldCoordinateType>{_x[i], _y[i], _width[i], _height[i]} : RectT<WorldCoordinateType>{};
+}
+
+void World::ClearFlags(uint8_t flags) {
+  const uint8_t keep = ~flags;
+  for (size_t i = 0; i < _numActors; ++i) {
+    _flags[i] &= keep;
+  }
 }
 
 void World::PaintTile(const Position &tilePosition, Painter &painter, const Vec2D<BitmapSizeType> &origin) const {
@@ -62,15 +182,73 @@ void World::PaintTile(const Position &tilePosition, Painter &painter, const Vec2
 }
 
 std::vector<World::NodeID> &World::Query(const RectT<WorldCoordinateType> &bounds, std::vector<NodeID> &output) const {
-  // TODO This is horrible; make some kind of BSP
-  for (NodeID i = 0; i < _elements.size(); i++) {
-    const auto &[actor, position] = _elements.at(i);
-    if (actor != nullptr && bounds.Contains(position)) {
-      output.push_back(i);
+  return _index.Query(bounds, output);
+}
+
+std::vector<World::NodeID> &World::Overlapping(const RectT<WorldCoordinateType> &area, std::vector<NodeID> &output) const {
+  const int32_t areaX0 = area.origin.x;
+  const int32_t areaY0 = area.origin.y;
+  const int32_t areaX1 = areaX0 + area.size.x;
+  const int32_t areaY1 = areaY0 + area.size.y;
+
+  // Branch free test over the columns first, so the compiler can vectorise it, then gather the hits
+  std::array<uint8_t, MaxActors> hit;
+  for (size_t i = 0; i < _numActors; ++i) {
+    const int32_t x0 = _x[i];
+    const int32_t y0 = _y[i];
+    // Actors without a size still take their own cell
+    const int32_t x1 = x0 + std::max<int32_t>(_width[i], 1);
+    const int32_t y1 = y0 + std::max<int32_t>(_height[i], 1);
+    hit[i] = static_cast<uint8_t>((x0 < areaX1) & (x1 > areaX0) & (y0 < areaY1) & (y1 > areaY0));
+  }
+
+  for (size_t i = 0; i < _numActors; ++i) {
+    if (hit[i]) {
+      output.push_back(_handle[i]);
     }
   }
 
   return output;
 }
 
+std::vector<World::OverlapPair> &World::FindOverlaps(std::vector<OverlapPair> &output) {
+  _sweep.clear();
+  for (size_t i = 0; i < _numActors; ++i) {
+    const int32_t x0 = _x[i];
+    _sweep.push_back({x0, x0 + std::max<int32_t>(_width[i], 1), static_cast<uint16_t>(i)});
+  }
+  std::ranges::sort(_sweep, {}, &SweepEntry::x0);
+
+  // Actors still open along x while sweeping left to right, only these can overlap the next one
+  _sweepActive.clear();
+  for (const auto &entry : _sweep) {
+    std::erase_if(_sweepActive, [&entry](const SweepEntry &open) { return open.x1 <= entry.x0; });
+
+    const auto i = entry.index;
+    const bool iDynamic = _body[i] == Actor::BodyType::Dynamic;
+    const int32_t y0 = _y[i];
+    const int32_t y1 = y0 + std::max<int32_t>(_height[i], 1);
+
+    for (const auto &open : _sweepActive) {
+      const auto j = open.index;
+      const bool jDynamic = _body[j] == Actor::BodyType::Dynamic;
+      if (!iDynamic && !jDynamic) continue;
+
+      const int32_t otherY0 = _y[j];
+      const int32_t otherY1 = otherY0 + std::max<int32_t>(_height[j], 1);
+      if (y0 < otherY1 && otherY0 < y1) {
+        output.push_back(iDynamic ? OverlapPair{_handle[i], _handle[j]} : OverlapPair{_handle[j], _handle[i]});
+      }
+    }
+
+    _sweepActive.push_back(entry);
+  }
+
+  return output;
+}
+
+std::vector<World::NodeID> &World::Nearest(const Vec2D<WorldCoordinateType> &point, size_t count, std::vector<NodeID> &output) const {
+  return _index.Nearest(point, count, output);
+}
+
 }// namespace e00
@@ -25,6 +25,11 @@ std::error_code Init() {
   const auto current_platform = platform::PlatformName();
   const auto platform_prefix = std::string("platform:") + std::string(current_platform);
 
+  // Resources are read from the archive when there is one, from loose files otherwise
+  if (const auto archiveEc = StreamFactory::GlobalStreamFactory().MountArchive(std::string(archive::DefaultName))) {
+    GetDefaultLogger().Verbose(source_location::current(), "No resource archive ({}), reading loose files", archiveEc.message());
+  }
+
   if (const auto config = StreamFactory::GlobalStreamFactory().OpenStream("game.ini")) {
     const auto iniEc = impl::IniParser::Parse(*config, [&](const impl::IniParser::Item &item) -> std::error_code {
       if (item.category == "platform" || item.category == platform_prefix) {
@@ -0,0 +1,151 @@
+#include "tests.hpp"
+
+#include "Archive.hpp"
+
+using namespace e00;
+
+namespace {
+// Reads from memory
+// In memory, shows its data through Map() when `mapped`
+class BufferStream : public Stream {
+  std::vector<uint8_t> _data;
+  bool _mapped;
+
+public:
+  explicit BufferStream(std::vector<uint8_t> data, bool mapped = false)
+      : Stream(data.size()), _data(std::move(data)), _mapped(mapped) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::memcpy(data, _data.data() + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+
+  std::span<const uint8_t> real_map() const override {
+    return _mapped ? std::span<const uint8_t>(_data) : std::span<const uint8_t>();
+  }
+};
+
+template<typename T>
+void Append(std::vector<uint8_t> &out, const T &value) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// "first" and "second" have their own data, "alias" shares the data of "first"
+std::vector<uint8_t> MakeArchive() {
+  const std::string first = "first data";
+  const std::string second = "second";
+
+  std::vector<archive::IndexEntry> index{
+      {"first"_id, 0, static_cast<uint32_t>(first.size())},
+      {"second"_id, 0, static_cast<uint32_t>(second.size())},
+      {"alias"_id, 0, static_cast<uint32_t>(first.size())},
+  };
+  const auto dataStart = static_cast<uint32_t>(sizeof(archive::Header) + index.size() * sizeof(archive::IndexEntry));
+  index[0].offset = dataStart;
+  index[1].offset = dataStart + static_cast<uint32_t>(first.size());
+  index[2].offset = dataStart;
+  std::ranges::sort(index, {}, &archive::IndexEntry::id);
+
+  std::vector<uint8_t> out;
+  Append(out, archive::Header{archive::Magic, archive::Version, static_cast<uint32_t>(index.size()), 0});
+  for (const auto &entry: index) Append(out, entry);
+  out.insert(out.end(), first.begin(), first.end());
+  out.insert(out.end(), second.begin(), second.end());
+  return out;
+}
+
+std::string ReadAll(Stream &stream) {
+  std::string text(stream.Size(), '\0');
+  if (!text.empty()) {
+    REQUIRE_FALSE(stream.Read(text.size(), text.data()));
+  }
+  return text;
+}
+}// namespace
+
+TEST_CASE("Archive - Entries by id", "[archive]") {
+  auto archive = impl::Archive::Open(std::make_unique<BufferStream>(MakeArchive()));
+  REQUIRE(archive);
+  auto &pack = *archive.value();
+  CHECK(pack.EntryCount() == 3);
+  CHECK(pack.Contains("FIRST"_id));
+  CHECK_FALSE(pack.Contains("third"_id));
+  CHECK(pack.OpenEntry("third"_id) == nullptr);
+
+  auto first = pack.OpenEntry("first"_id);
+  auto second = pack.OpenEntry("second"_id);
+  auto alias = pack.OpenEntry("alias"_id);
+  REQUIRE(first);
+  REQUIRE(second);
+  REQUIRE(alias);
+
+  // Slices of the same stream don't disturb each other
+  char c;
+  REQUIRE_FALSE(second->Read(c));
+  CHECK(c == 's');
+  CHECK(ReadAll(*first) == "first data");
+  CHECK(second->Position() == 1);
+  REQUIRE_FALSE(second->Read(c));
+  CHECK(c == 'e');
+
+  REQUIRE_FALSE(second->SeekTo(0));
+  CHECK(ReadAll(*second) == "second");
+  CHECK(second->AtEnd());
+  CHECK(second->Read(c));
+
+  CHECK(ReadAll(*alias) == "first data");
+}
+
+TEST_CASE("Archive - Invalid archives", "[archive]") {
+  CHECK_FALSE(impl::Archive::Open(nullptr));
+
+  auto badMagic = MakeArchive();
+  badMagic[0] = 'X';
+  CHECK_FALSE(impl::Archive::Open(std::make_unique<BufferStream>(badMagic)));
+
+  // Entry going past the end of the archive
+  auto truncated = MakeArchive();
+  truncated.resize(truncated.size() - 3);
+  CHECK_FALSE(impl::Archive::Open(std::make_unique<BufferStream>(truncated)));
+
+  // Index longer than the archive
+  auto shortIndex = MakeArchive();
+  shortIndex.resize(sizeof(archive::Header) + sizeof(archive::IndexEntry));
+  CHECK_FALSE(impl::Archive::Open(std::make_unique<BufferStream>(shortIndex)));
+}
+
+TEST_CASE("Archive - Mapped entries", "[archive]") {
+  auto archive = impl::Archive::Open(std::make_unique<BufferStream>(MakeArchive(), true));
+  REQUIRE(archive);
+
+  auto second = archive.value()->OpenEntry("second"_id);
+  REQUIRE(second);
+  const auto mapped = second->Map();
+  REQUIRE(mapped.size() == 6);
+  CHECK(std::string(mapped.begin(), mapped.end()) == "second");
+
+  // Peeking doesn't move
+  REQUIRE_FALSE(second->SeekTo(2));
+  const auto peeked = second->Peek(3);
+  REQUIRE(peeked.size() == 3);
+  CHECK(peeked.data() == mapped.data() + 2);
+  CHECK(second->Position() == 2);
+  CHECK(second->Peek(5).empty());
+
+  char c;
+  REQUIRE_FALSE(second->Read(c));
+  CHECK(c == 'c');
+
+  // Streams that aren't in memory can't be peeked at
+  auto unmapped = impl::Archive::Open(std::make_unique<BufferStream>(MakeArchive()));
+  REQUIRE(unmapped);
+  auto first = unmapped.value()->OpenEntry("first"_id);
+  REQUIRE(first);
+  CHECK(first->Map().empty());
+  CHECK(first->Peek(1).empty());
+  CHECK(ReadAll(*first) == "first data");
+}
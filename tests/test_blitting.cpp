@@ -3,6 +3,10 @@
 #include <Engine/Platform/Painter.hpp>
 #include <Engine/Platform/DrawableSurface.hpp>
 #include <Engine/DefaultBitmapHelpers.hpp>
+#include <Engine.hpp>
+
+#include <cstring>
+#include <vector>
 
 using namespace e00;
 
@@ -154,4 +158,307 @@ TEST_CASE("Bitmap Blitting - Bit Depth Conversion", "[blitting]") {
         CHECK(dstData[6] == 1);
         CHECK(dstData[7] == 0);
     }
+
+    SECTION("16-bit to 32-bit conversion") {
+        auto src = Bitmap::Create({4, 2}, DrawableSurface::BitDepth::DEPTH_16);
+        {
+            auto painter = src->BeginDraw();
+            painter->SetPenSolid(1, Color(255, 0, 255));
+            painter->DrawPoint({1, 1});
+        }
+
+        auto dst = Bitmap::Create({4, 2}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = dst->BeginDraw();
+            painter->DrawSurface(*src, {{0, 0}, {4, 2}}, {0, 0});
+        }
+
+        auto line = dst->GetLineData(1);
+        CHECK(helpers::BitmapDepth32::ReadColor(line, 0) == Color(0, 0, 0));
+        CHECK(helpers::BitmapDepth32::ReadColor(line, 1) == Color(255, 0, 255));
+    }
+
+    SECTION("32-bit to 16-bit conversion") {
+        auto src = Bitmap::Create({4, 1}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = src->BeginDraw();
+            painter->SetPenSolid(1, Color(0, 255, 0));
+            painter->DrawPoint({2, 0});
+        }
+
+        auto dst = Bitmap::Create({4, 1}, DrawableSurface::BitDepth::DEPTH_16);
+        {
+            auto painter = dst->BeginDraw();
+            painter->DrawSurface(*src, {{0, 0}, {4, 1}}, {0, 0});
+        }
+
+        auto line = dst->GetLineData(0);
+        CHECK(helpers::BitmapDepth16::ReadColor(line, 1) == Color(0, 0, 0));
+        CHECK(helpers::BitmapDepth16::ReadColor(line, 2) == Color(0, 255, 0));
+    }
+
+    SECTION("32-bit to 32-bit sub-rect copy") {
+        auto src = Bitmap::Create({8, 8}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = src->BeginDraw();
+            painter->SetPenSolid(1, Color(10, 20, 30));
+            painter->DrawPoint({5, 6});
+        }
+
+        auto dst = Bitmap::Create({4, 4}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = dst->BeginDraw();
+            painter->DrawSurface(*src, {{4, 4}, {4, 4}}, {1, 1});
+        }
+
+        CHECK(helpers::BitmapDepth32::ReadColor(dst->GetLineData(3), 2) == Color(10, 20, 30));
+        CHECK(helpers::BitmapDepth32::ReadColor(dst->GetLineData(3), 3) == Color(0, 0, 0));
+    }
+}
+
+TEST_CASE("Bitmap Blitting - Whole row conversion", "[blitting]") {
+    // Wide enough for the vector loops plus a scalar tail
+    constexpr BitmapSizeType width = 37;
+
+    DrawableSurface::TargetInformation info16;
+    info16.bit_depth = DrawableSurface::BitDepth::DEPTH_16;
+    info16.shift = helpers::BitmapDepth16::DefaultShift;
+    info16.mask = helpers::BitmapDepth16::DefaultMask;
+
+    DrawableSurface::TargetInformation info32;
+    info32.bit_depth = DrawableSurface::BitDepth::DEPTH_32;
+    info32.shift = helpers::BitmapDepth32::DefaultShift;
+    info32.mask = helpers::BitmapDepth32::DefaultMask;
+
+    auto colorAt = [](BitmapSizeType x) {
+        return Color(static_cast<uint8_t>(x * 7), static_cast<uint8_t>(255 - x * 5), static_cast<uint8_t>(x * 3));
+    };
+
+    SECTION("16-bit to 32-bit") {
+        auto src = Bitmap::Create({width, 1}, DrawableSurface::BitDepth::DEPTH_16);
+        auto line = src->GetLineData(0);
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            helpers::BitmapDepth16::WriteColor(line, x, colorAt(x));
+        }
+
+        std::vector<uint8_t> result(width * 4);
+        src->ReadLineInto(0, 0, width, info32, result);
+
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            CHECK(helpers::BitmapDepth32::ReadColor(result, x) == helpers::BitmapDepth16::ReadColor(line, x));
+        }
+    }
+
+    SECTION("32-bit to 16-bit") {
+        auto src = Bitmap::Create({width, 1}, DrawableSurface::BitDepth::DEPTH_32);
+        auto line = src->GetLineData(0);
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            helpers::BitmapDepth32::WriteColor(line, x, colorAt(x));
+        }
+
+        std::vector<uint8_t> result(width * 2);
+        src->ReadLineInto(0, 0, width, info16, result);
+
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            uint16_t raw;
+            std::memcpy(&raw, result.data() + x * 2, 2);
+            CHECK(raw == helpers::BitmapDepth16::PackColor(colorAt(x)));
+        }
+    }
+
+    SECTION("32-bit to swapped 32-bit") {
+        auto src = Bitmap::Create({width, 1}, DrawableSurface::BitDepth::DEPTH_32);
+        auto line = src->GetLineData(0);
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            helpers::BitmapDepth32::WriteColor(line, x, colorAt(x));
+        }
+
+        auto infoBgr = info32;
+        infoBgr.shift = {0, 8, 16};
+
+        std::vector<uint8_t> result(width * 4);
+        src->ReadLineInto(0, 0, width, infoBgr, result);
+
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            CHECK(helpers::BitmapDepth32::ReadColor(result, x, infoBgr.shift, infoBgr.mask) == colorAt(x));
+        }
+    }
+
+    SECTION("8-bit to 32-bit with an offset") {
+        auto src = Bitmap::Create({width, 1}, DrawableSurface::BitDepth::DEPTH_8, 256);
+        for (size_t i = 0; i < 256; ++i) {
+            (void)src->SetPaletteColor(static_cast<uint8_t>(i), colorAt(static_cast<BitmapSizeType>(i)));
+        }
+
+        auto line = src->GetLineData(0);
+        for (BitmapSizeType x = 0; x < width; ++x) {
+            line[x] = static_cast<uint8_t>(x * 11);
+        }
+
+        constexpr BitmapSizeType startX = 3;
+        std::vector<uint8_t> result((width - startX) * 4);
+        src->ReadLineInto(0, startX, width, info32, result);
+
+        for (BitmapSizeType x = startX; x < width; ++x) {
+            CHECK(helpers::BitmapDepth32::ReadColor(result, x - startX) == colorAt(static_cast<BitmapSizeType>(static_cast<uint8_t>(x * 11))));
+        }
+    }
+
+    SECTION("8-bit to 16-bit, several lines at once") {
+        constexpr BitmapSizeType lines = 5;
+        auto src = Bitmap::Create({width, lines}, DrawableSurface::BitDepth::DEPTH_8, 256);
+        for (size_t i = 0; i < 256; ++i) {
+            (void)src->SetPaletteColor(i, colorAt(static_cast<BitmapSizeType>(i)));
+        }
+
+        for (BitmapSizeType y = 0; y < lines; ++y) {
+            auto line = src->GetLineData(y);
+            for (BitmapSizeType x = 0; x < width; ++x) {
+                line[x] = static_cast<uint8_t>(x + y * 13);
+            }
+        }
+
+        // Lines 1 to 4, with room to spare between them
+        const size_t stride = width * 2 + 6;
+        std::vector<uint8_t> result(stride * (lines - 1));
+        src->ReadLinesInto(1, lines - 1, 0, width, info16, result, stride);
+
+        for (BitmapSizeType y = 1; y < lines; ++y) {
+            for (BitmapSizeType x = 0; x < width; ++x) {
+                uint16_t raw;
+                std::memcpy(&raw, result.data() + (y - 1) * stride + x * 2, 2);
+                CHECK(raw == helpers::BitmapDepth16::PackColor(colorAt(static_cast<uint8_t>(x + y * 13))));
+            }
+        }
+    }
+}
+
+TEST_CASE("Bitmap Blitting - Tileset baked to the target format", "[blitting]") {
+    // 2 tiles of 2x2: tile 1 is palette index 3 (red), tile 2 is index 4 (green)
+    auto tiles = Bitmap::Create({4, 2}, DrawableSurface::BitDepth::DEPTH_8, 256);
+    (void)tiles->SetPaletteColor(3, Color(255, 0, 0));
+    (void)tiles->SetPaletteColor(4, Color(0, 255, 0));
+    for (BitmapSizeType y = 0; y < 2; ++y) {
+        auto line = tiles->GetLineData(y);
+        line[0] = line[1] = 3;
+        line[2] = line[3] = 4;
+    }
+
+    Map map(2, 1);
+    map.SetTileSize({2, 2});
+    map.SetTileset(ResourceManager::GlobalResourceManager().TakeOwnership(std::move(tiles)));
+    REQUIRE(map.Set({0, 0}, 1));
+    REQUIRE(map.Set({1, 0}, 2));
+
+    // Target palette orders the colours differently
+    auto dst = Bitmap::Create({4, 2}, DrawableSurface::BitDepth::DEPTH_8, 256);
+    (void)dst->SetPaletteColor(1, Color(0, 255, 0));
+    (void)dst->SetPaletteColor(2, Color(255, 0, 0));
+
+    const auto paintMap = [&] {
+        auto painter = dst->BeginDraw();
+        CHECK(painter->TargetFormat().bit_depth == DrawableSurface::BitDepth::DEPTH_8);
+        map.PaintTile({0, 0}, *painter, {0, 0});
+        map.PaintTile({1, 0}, *painter, {2, 0});
+    };
+
+    paintMap();
+    CHECK(dst->GetLineData(1)[0] == 2);
+    CHECK(dst->GetLineData(1)[3] == 1);
+
+    // Painting again from the cached copy gives the same pixels
+    std::memset(dst->GetLineData(1).data(), 0, 4);
+    paintMap();
+    CHECK(dst->GetLineData(1)[1] == 2);
+    CHECK(dst->GetLineData(1)[2] == 1);
+
+    // Changing the target palette re-bakes the tileset
+    (void)dst->SetPaletteColor(5, Color(255, 0, 0));
+    (void)dst->SetPaletteColor(2, Color(0, 0, 255));
+    paintMap();
+    CHECK(dst->GetLineData(0)[0] == 5);
+    CHECK(dst->GetLineData(0)[2] == 1);
+
+    SECTION("32-bit target") {
+        auto dst32 = Bitmap::Create({4, 2}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = dst32->BeginDraw();
+            map.PaintTile({0, 0}, *painter, {0, 0});
+            map.PaintTile({1, 0}, *painter, {2, 0});
+        }
+
+        CHECK(helpers::BitmapDepth32::ReadColor(dst32->GetLineData(1), 0) == Color(255, 0, 0));
+        CHECK(helpers::BitmapDepth32::ReadColor(dst32->GetLineData(1), 3) == Color(0, 255, 0));
+    }
+}
+
+TEST_CASE("Bitmap Blitting - Batched tile rows", "[blitting]") {
+    // 3 tiles of 2x2 in a row, tile N is filled with palette index N
+    auto tiles = Bitmap::Create({6, 2}, DrawableSurface::BitDepth::DEPTH_8, 256);
+    (void)tiles->SetPaletteColor(1, Color(255, 0, 0));
+    (void)tiles->SetPaletteColor(2, Color(0, 255, 0));
+    (void)tiles->SetPaletteColor(3, Color(0, 0, 255));
+    for (BitmapSizeType y = 0; y < 2; ++y) {
+        auto line = tiles->GetLineData(y);
+        for (BitmapSizeType x = 0; x < 6; ++x) {
+            line[x] = static_cast<uint8_t>(1 + x / 2);
+        }
+    }
+
+    Map map(4, 3);
+    map.SetTileSize({2, 2});
+    map.SetTileset(ResourceManager::GlobalResourceManager().TakeOwnership(std::move(tiles)));
+    for (WorldCoordinateType y = 0; y < 3; ++y) {
+        for (WorldCoordinateType x = 0; x < 4; ++x) {
+            REQUIRE(map.Set({x, y}, static_cast<TileIdType>((x + y) % 4)));
+        }
+    }
+
+    const auto depth = GENERATE(DrawableSurface::BitDepth::DEPTH_8, DrawableSurface::BitDepth::DEPTH_32);
+    auto one = Bitmap::Create({8, 6}, depth, 256);
+    auto batched = Bitmap::Create({8, 6}, depth, 256);
+    if (depth == DrawableSurface::BitDepth::DEPTH_8) {
+        // Same colours, different indices: every tile goes through the remapping table
+        for (auto &bmp : {one.get(), batched.get()}) {
+            (void)bmp->SetPaletteColor(7, Color(255, 0, 0));
+            (void)bmp->SetPaletteColor(8, Color(0, 255, 0));
+            (void)bmp->SetPaletteColor(9, Color(0, 0, 255));
+        }
+    }
+
+    const auto paint = [&](Bitmap &target, bool tileByTile) {
+        auto painter = target.BeginDraw();
+        // Cuts the left column of tiles in half
+        painter->PushClip({{1, 0}, {8, 6}});
+        if (tileByTile) {
+            for (WorldCoordinateType y = 0; y < 3; ++y) {
+                for (WorldCoordinateType x = 0; x < 4; ++x) {
+                    map.PaintTile({x, y}, *painter, {static_cast<BitmapSizeType>(x * 2), static_cast<BitmapSizeType>(y * 2)});
+                }
+            }
+        } else {
+            // Bigger than the map on purpose
+            map.PaintRegion({0, 0}, {10, 8}, *painter, {0, 0});
+        }
+    };
+
+    paint(*one, true);
+    paint(*batched, false);
+
+    for (BitmapSizeType y = 0; y < 6; ++y) {
+        const auto a = one->GetLineData(y);
+        const auto b = batched->GetLineData(y);
+        CHECK(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+    }
+
+    // Column 0 is clipped, tile (1, 0) is tile id 1
+    if (depth == DrawableSurface::BitDepth::DEPTH_8) {
+        CHECK(batched->GetLineData(0)[0] == 0);
+        CHECK(batched->GetLineData(0)[1] == 0);
+        CHECK(batched->GetLineData(0)[2] == 7);
+        CHECK(batched->GetLineData(2)[2] == 8);
+    } else {
+        CHECK(helpers::BitmapDepth32::ReadColor(batched->GetLineData(0), 2) == Color(255, 0, 0));
+        CHECK(helpers::BitmapDepth32::ReadColor(batched->GetLineData(2), 2) == Color(0, 255, 0));
+    }
 }
@@ -0,0 +1,112 @@
+#include "tests.hpp"
+
+using namespace e00;
+
+namespace {
+// In memory but not mapped, counts the reads that reach it
+class CountingStream : public Stream {
+  std::string _data;
+
+public:
+  size_t reads{0};
+
+  explicit CountingStream(std::string data) : Stream(data.size()), _data(std::move(data)) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    ++reads;
+    std::memcpy(data, _data.data() + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+};
+
+std::string Numbers(int count) {
+  std::string text;
+  for (int i = 0; i < count; ++i) {
+    text += std::to_string(i % 100) + ",";
+  }
+  return text;
+}
+}// namespace
+
+TEST_CASE("BufferedStream - Small reads", "[stream]") {
+  const auto text = Numbers(1000);
+  auto counting = std::make_unique<CountingStream>(text);
+  auto &inner = *counting;
+  BufferedStream stream(std::move(counting), 64);
+  REQUIRE(stream.Size() == text.size());
+
+  std::string read;
+  while (!stream.AtEnd()) {
+    uint8_t c;
+    REQUIRE_FALSE(stream.ReadByte(c));
+    read += static_cast<char>(c);
+  }
+  CHECK(read == text);
+  CHECK(inner.reads == (text.size() + 63) / 64);
+
+  uint8_t c;
+  CHECK(stream.ReadByte(c));
+
+  // Seeking inside the buffer doesn't read again
+  const auto reads = inner.reads;
+  REQUIRE_FALSE(stream.SeekTo(text.size() - 3));
+  char last[3];
+  REQUIRE_FALSE(stream.Read(3, last));
+  CHECK(std::string(last, 3) == text.substr(text.size() - 3));
+  CHECK(inner.reads == reads);
+}
+
+TEST_CASE("BufferedStream - Peek and ReadUntil", "[stream]") {
+  auto counting = std::make_unique<CountingStream>("12,345,,6789");
+  auto &inner = *counting;
+  BufferedStream stream(std::move(counting), 4);
+
+  const auto peeked = stream.Peek(3);
+  REQUIRE(peeked.size() == 3);
+  CHECK(std::string(peeked.begin(), peeked.end()) == "12,");
+  CHECK(stream.Position() == 0);
+  CHECK(stream.Peek(5).empty());
+
+  std::string value;
+  REQUIRE_FALSE(stream.ReadUntil(',', value));
+  CHECK(value == "12");
+  REQUIRE_FALSE(stream.ReadUntil(',', value));
+  CHECK(value == "345");
+  REQUIRE_FALSE(stream.ReadUntil(',', value));
+  CHECK(value.empty());
+  REQUIRE_FALSE(stream.ReadUntil(',', value));
+  CHECK(value == "6789");
+  CHECK(stream.AtEnd());
+  CHECK(stream.ReadUntil(',', value));
+
+  // Reads of a block or more skip the buffer
+  REQUIRE_FALSE(stream.SeekTo(1));
+  const auto reads = inner.reads;
+  std::string all(11, '\0');
+  REQUIRE_FALSE(stream.Read(all.size(), all.data()));
+  CHECK(all == "2,345,,6789");
+  CHECK(inner.reads == reads + 1);
+}
+
+TEST_CASE("BufferedStream - Lines", "[stream]") {
+  auto counting = std::make_unique<CountingStream>("[map]\nwidth=10\n\nheight=20");
+  auto &inner = *counting;
+  BufferedStream stream(std::move(counting), 64);
+
+  char line[32];
+  REQUIRE(stream.ReadLineInto(line, sizeof(line)) != nullptr);
+  CHECK(std::string(line) == "[map]");
+  REQUIRE(stream.ReadLineInto(line, sizeof(line)) != nullptr);
+  CHECK(std::string(line) == "width=10");
+  REQUIRE(stream.ReadLineInto(line, sizeof(line)) != nullptr);
+  CHECK(std::string(line).empty());
+  REQUIRE(stream.ReadLineInto(line, sizeof(line)) != nullptr);
+  CHECK(std::string(line) == "height=20");
+  CHECK(stream.ReadLineInto(line, sizeof(line)) == nullptr);
+
+  // Lines are found in the buffer, without reading past them and seeking back
+  CHECK(inner.reads == 1);
+}
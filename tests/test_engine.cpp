@@ -8,6 +8,57 @@ public:
   [[nodiscard]] e00::type_t Type() const override { return e00::type_id<TestResource>(); }
 };
 
+// 1000 bytes each, loads counted
+class SizedResource : public e00::Resource {
+public:
+  static constexpr size_t Size = 1000;
+  static inline int Loads = 0;
+
+  SizedResource() { ++Loads; }
+  [[nodiscard]] e00::type_t Type() const override { return e00::type_id<SizedResource>(); }
+  [[nodiscard]] size_t MemoryUsage() const override { return Size; }
+};
+
+class SizedResourceLoader : public e00::ResourceLoader {
+public:
+  [[nodiscard]] bool SupportsType(e00::type_t type) const override { return type == e00::type_id<SizedResource>(); }
+  bool CanLoad(const LoadContext &) override { return true; }
+  Result ReadLoad(const LoadContext &) override { return std::make_unique<SizedResource>(); }
+};
+
+// Needs a SizedResource, like a map needs its tileset
+class DependentResource : public e00::Resource {
+public:
+  e00::ResourcePtrT<SizedResource> dependency;
+
+  [[nodiscard]] e00::type_t Type() const override { return e00::type_id<DependentResource>(); }
+};
+
+class DependentResourceLoader : public e00::ResourceLoader {
+public:
+  [[nodiscard]] bool SupportsType(e00::type_t type) const override { return type == e00::type_id<DependentResource>(); }
+  bool CanLoad(const LoadContext &) override { return true; }
+  Result ReadLoad(const LoadContext &) override {
+    auto resource = std::make_unique<DependentResource>();
+    resource->dependency = _engine->LoadResourceDirectly<SizedResource>("Dependency resource"_id);
+    return resource;
+  }
+};
+
+// 4x4 maps that need a SizedResource, like a map needs its tileset
+class TestMapLoader : public e00::ResourceLoader {
+public:
+  static inline int Loads = 0;
+
+  [[nodiscard]] bool SupportsType(e00::type_t type) const override { return type == e00::type_id<e00::Map>(); }
+  bool CanLoad(const LoadContext &) override { return true; }
+  Result ReadLoad(const LoadContext &) override {
+    ++Loads;
+    (void) _engine->LoadResourceDirectly<SizedResource>("World tileset"_id);
+    return std::make_unique<e00::Map>(4, 4);
+  }
+};
+
 class AnEngine : public e00::Engine {
 public:
   explicit AnEngine() {
@@ -30,6 +81,17 @@ protected:
 };
 
 
+// Remembers the worlds it went through, by map id
+class WorldEngine : public AnEngine {
+public:
+  std::vector<e00::ResourceId> loaded;
+  size_t unloaded = 0;
+
+protected:
+  void OnWorldUnload(const std::unique_ptr<e00::World> &) override { ++unloaded; }
+  void OnWorldLoaded(const std::unique_ptr<e00::World> &world) override { loaded.push_back(world->Map().Id()); }
+};
+
 static std::unique_ptr<e00::Engine> CreateGameEngine() {
   auto ptr = std::make_unique<AnEngine>();
   if (ptr->Init()) {
@@ -68,3 +130,227 @@ TEST_CASE("Resource PTR", "[core]") {
     auto res = e00::ResourceManager::GlobalResourceManager().Make<TestResource>("Test Bitmap 4"_id, e00::Vec2D<uint16_t>(120, 120), e00::DrawableSurface::BitDepth::DEPTH_8);
   }
 }
+
+TEST_CASE("Resource manager - Named lookups", "[core]") {
+  auto &manager = e00::ResourceManager::GlobalResourceManager();
+
+  auto made = manager.Make<TestResource>("Lookup resource"_id, e00::Vec2D<uint16_t>(1, 1), e00::DrawableSurface::BitDepth::DEPTH_8);
+  REQUIRE(made != nullptr);
+
+  // Same id and type: the same resource, nothing is loaded
+  auto found = manager.LoadResourceDirectly<TestResource>("Lookup resource"_id);
+  CHECK(found == made);
+  CHECK(found.get() == made.get());
+
+  // Same id, other type: not the same resource
+  CHECK(manager.LoadResourceDirectly<e00::Map>("Lookup resource"_id) == nullptr);
+
+  // Once nothing references it, it is forgotten rather than found unloaded
+  made = nullptr;
+  CHECK(found != nullptr);
+  CHECK(manager.LoadResourceDirectly<TestResource>("Lookup resource"_id) == found);
+  found = nullptr;
+  CHECK(manager.LoadResourceDirectly<TestResource>("Lookup resource"_id) == nullptr);
+  const auto remade = manager.Make<TestResource>("Lookup resource"_id, e00::Vec2D<uint16_t>(1, 1), e00::DrawableSurface::BitDepth::DEPTH_8);
+  CHECK(manager.LoadResourceDirectly<TestResource>("Lookup resource"_id) == remade);
+
+  // Setting an alias again replaces it
+  manager.SetAlias("Lookup alias"_id, "does/not/exist.bmp");
+  manager.SetAlias("Lookup alias"_id, "tests/labeled_overworldtiles.png");
+  CHECK(manager.FindStreamForResource("Lookup alias"_id) != nullptr);
+  CHECK(manager.FindStreamForResource("Lookup missing"_id) == nullptr);
+}
+
+TEST_CASE("Resource manager - Memory budget", "[core]") {
+  using namespace std::chrono_literals;
+  auto &manager = e00::ResourceManager::GlobalResourceManager();
+  (void) manager.AddLoader<SizedResourceLoader>();
+  manager.SetAlias("Budget resource 1"_id, "tests/labeled_overworldtiles.png");
+  manager.SetAlias("Budget resource 2"_id, "tests/labeled_overworldtiles.png");
+
+  auto first = manager.LazyResource<SizedResource>("Budget resource 1"_id);
+  auto second = manager.LazyResource<SizedResource>("Budget resource 2"_id);
+  REQUIRE(first.get() != nullptr);
+  REQUIRE(second.get() != nullptr);
+  const auto loads = SizedResource::Loads;
+
+  // Counted as they are loaded, not by Tick()
+  const auto inUse = manager.MemoryInUse();
+  CHECK(inUse >= 2 * SizedResource::Size);
+  manager.Tick(16ms);
+  CHECK(manager.MemoryInUse() == inUse);
+
+  // Held resources stay whatever the budget, even when unused for a while
+  manager.SetMemoryBudget(1);
+  manager.Tick(16ms);
+  manager.Tick(16ms);
+  CHECK(manager.MemoryInUse() == inUse);
+  CHECK(first.IsLoaded());
+  CHECK(second.IsLoaded());
+
+  // Once nothing holds `first`, it's kept for as long as there's room
+  manager.SetMemoryBudget(inUse);
+  first = nullptr;
+  manager.Tick(16ms);
+  CHECK(manager.MemoryInUse() == inUse);
+
+  // Then goes to make room; `second`, still held, stays
+  manager.SetMemoryBudget(inUse - SizedResource::Size);
+  manager.Tick(16ms);
+  CHECK(manager.MemoryInUse() == inUse - SizedResource::Size);
+  CHECK(second.IsLoaded());
+  CHECK(SizedResource::Loads == loads);
+
+  // And comes back when needed
+  first = manager.LazyResource<SizedResource>("Budget resource 1"_id);
+  CHECK(first.get() != nullptr);
+  CHECK(SizedResource::Loads == loads + 1);
+
+  // Without a budget anymore, what was kept goes at the next tick
+  first = nullptr;
+  CHECK(manager.MemoryInUse() == inUse);
+  manager.SetMemoryBudget(0);
+  manager.Tick(16ms);
+  CHECK(manager.MemoryInUse() == inUse - SizedResource::Size);
+}
+
+TEST_CASE("Resource manager - Background loads", "[core]") {
+  using namespace std::chrono_literals;
+  auto &manager = e00::ResourceManager::GlobalResourceManager();
+  (void) manager.AddLoader<SizedResourceLoader>();
+  manager.SetAlias("Async resource"_id, "tests/labeled_overworldtiles.png");
+
+  auto resource = manager.LoadResourceAsync<SizedResource>("Async resource"_id);
+  auto missing = manager.LoadResourceAsync<SizedResource>("Async missing resource"_id);
+  REQUIRE(resource);
+  CHECK(manager.LoadResourceAsync<SizedResource>("Async resource"_id) == resource);
+
+  // Nothing is delivered outside of Tick()
+  CHECK_FALSE(resource.IsLoaded());
+  CHECK(resource.EnsureLoad() == std::errc::resource_unavailable_try_again);
+  CHECK(manager.PendingAsyncLoads() == 2);
+
+  for (int ticks = 0; ticks < 1000 && manager.PendingAsyncLoads() > 0; ++ticks) {
+    manager.Tick(16ms);
+  }
+  REQUIRE(manager.PendingAsyncLoads() == 0);
+
+  CHECK(resource.IsLoaded());
+  CHECK(resource.EnsureLoad() == std::error_code());
+  CHECK(resource.get() != nullptr);
+  CHECK_FALSE(missing.IsLoaded());
+  CHECK(missing.EnsureLoad() == std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("Resource manager - Dependencies", "[core]") {
+  using Key = e00::ResourceManager::ResourceKey;
+  auto &manager = e00::ResourceManager::GlobalResourceManager();
+  (void) manager.AddLoader<SizedResourceLoader>();
+  (void) manager.AddLoader<DependentResourceLoader>();
+  manager.SetAlias("Dependency resource"_id, "tests/labeled_overworldtiles.png");
+  manager.SetAlias("Dependent resource"_id, "tests/labeled_overworldtiles.png");
+  manager.SetAlias("Prefetched resource"_id, "tests/labeled_overworldtiles.png");
+
+  // Recorded while loading
+  const Key dependentKey{"Dependent resource"_id, e00::type_id<DependentResource>()};
+  CHECK(manager.DependenciesOf(dependentKey).empty());
+  auto dependent = manager.LoadResourceDirectly<DependentResource>("Dependent resource"_id);
+  REQUIRE(dependent);
+  REQUIRE(dependent->dependency);
+  const std::vector<Key> expected{{"Dependency resource"_id, e00::type_id<SizedResource>()}};
+  CHECK(manager.DependenciesOf(dependentKey) == expected);
+
+  // Or declared
+  const Key declaredKey{"Declared resource"_id, e00::type_id<DependentResource>()};
+  manager.SetDependencies(declaredKey, expected);
+  CHECK(manager.DependenciesOf(declaredKey) == expected);
+
+  // And prefetched without knowing their type statically
+  auto prefetched = manager.Prefetch({"Prefetched resource"_id, e00::type_id<SizedResource>()});
+  REQUIRE(prefetched);
+  manager.WaitForAsyncLoads();
+  CHECK(manager.PendingAsyncLoads() == 0);
+  CHECK(prefetched.IsLoaded());
+}
+
+TEST_CASE("Engine - Background world loads", "[core]") {
+  using namespace std::chrono_literals;
+  auto &manager = e00::ResourceManager::GlobalResourceManager();
+  (void) manager.AddLoader<SizedResourceLoader>();
+  (void) manager.AddLoader<TestMapLoader>();
+  manager.SetAlias("World tileset"_id, "tests/labeled_overworldtiles.png");
+  for (const auto *name: {"first world", "second world", "third world", "fourth world", "fifth world", "sixth world", "seventh world", "eighth world"}) {
+    manager.SetAlias(e00::HashName(name), "tests/labeled_overworldtiles.png");
+  }
+
+  WorldEngine engine;
+  REQUIRE_FALSE(engine.Init());
+
+  // Like the platform's main loop
+  const auto tickUntilLoaded = [&]() {
+    for (int ticks = 0; ticks < 1000 && engine.IsLoadingWorld(); ++ticks) {
+      engine.Tick(16ms);
+      manager.Tick(16ms);
+    }
+    return !engine.IsLoadingWorld();
+  };
+
+  REQUIRE_FALSE(engine.LoadWorld("first world"));
+  CHECK(engine.loaded == std::vector<e00::ResourceId>{e00::HashName("first world")});
+
+  // The current world stays until the new one is in, then they are swapped during a tick
+  REQUIRE_FALSE(engine.LoadWorldAsync("second world"));
+  CHECK(engine.IsLoadingWorld());
+  CHECK(engine.loaded.size() == 1);
+  REQUIRE(tickUntilLoaded());
+  CHECK(engine.loaded.back() == e00::HashName("second world"));
+  CHECK(engine.unloaded == 1);
+
+  // LoadWorld() on a world being prefetched waits for it rather than load it again
+  const auto mapLoads = TestMapLoader::Loads;
+  REQUIRE_FALSE(engine.PrefetchWorld("third world"));
+  CHECK_FALSE(engine.IsLoadingWorld());
+  CHECK(manager.PendingAsyncLoads() > 0);
+  REQUIRE_FALSE(engine.LoadWorld("third world"));
+  CHECK(manager.PendingAsyncLoads() == 0);
+  CHECK(engine.loaded.back() == e00::HashName("third world"));
+  CHECK(TestMapLoader::Loads == mapLoads + 1);
+
+  // Known dependencies come first, the map only once they are in
+  const e00::ResourceManager::ResourceKey fourthKey{e00::HashName("fourth world"), e00::type_id<e00::Map>()};
+  manager.SetAlias("Fourth world tileset"_id, "tests/labeled_overworldtiles.png");
+  manager.SetDependencies(fourthKey, {{"Fourth world tileset"_id, e00::type_id<SizedResource>()}});
+  REQUIRE_FALSE(engine.PrefetchWorld("fourth world"));
+  CHECK(manager.PendingAsyncLoads() == 1);
+
+  // Then LoadWorldAsync() picks up the prefetch where it is
+  REQUIRE_FALSE(engine.LoadWorldAsync("fourth world"));
+  REQUIRE(tickUntilLoaded());
+  CHECK(engine.loaded.back() == e00::HashName("fourth world"));
+  CHECK(TestMapLoader::Loads == mapLoads + 2);
+
+  // Asking for another world while one is in flight replaces it; the first one is never switched to
+  REQUIRE_FALSE(engine.LoadWorldAsync("fifth world"));
+  REQUIRE_FALSE(engine.LoadWorldAsync("sixth world"));
+  REQUIRE(tickUntilLoaded());
+  manager.WaitForAsyncLoads();
+  engine.Tick(16ms);
+  CHECK(engine.loaded.back() == e00::HashName("sixth world"));
+  CHECK(std::ranges::find(engine.loaded, e00::HashName("fifth world")) == engine.loaded.end());
+
+  // So does a synchronous load
+  const auto switches = engine.loaded.size();
+  REQUIRE_FALSE(engine.LoadWorldAsync("seventh world"));
+  REQUIRE_FALSE(engine.LoadWorld("eighth world"));
+  CHECK_FALSE(engine.IsLoadingWorld());
+  manager.WaitForAsyncLoads();
+  engine.Tick(16ms);
+  CHECK(engine.loaded.size() == switches + 1);
+  CHECK(engine.loaded.back() == e00::HashName("eighth world"));
+
+  // A world that fails to load leaves the current one in place
+  REQUIRE_FALSE(engine.LoadWorldAsync("missing world"));
+  REQUIRE(tickUntilLoaded());
+  CHECK(engine.loaded.size() == switches + 1);
+  CHECK(engine.unloaded == switches);
+}
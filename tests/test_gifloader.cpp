@@ -2,6 +2,80 @@
 
 #include "Loaders/SpriteGifLoader.hpp"
 
+namespace {
+// A file read into memory, that says so through Map() only when `mapped`
+class GifStream : public e00::Stream {
+  std::vector<uint8_t> _data;
+  bool _mapped;
+
+public:
+  GifStream(std::vector<uint8_t> data, bool mapped) : Stream(data.size()), _data(std::move(data)), _mapped(mapped) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::memcpy(data, _data.data() + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+
+  [[nodiscard]] std::span<const uint8_t> real_map() const override {
+    return _mapped ? std::span<const uint8_t>(_data) : std::span<const uint8_t>();
+  }
+};
+
+// Peeks out of a scratch buffer that is scribbled over on every read or seek, like a stream allowed to
+// reuse its buffer would
+class ScratchPeekStream : public GifStream {
+  std::vector<uint8_t> _scratch;
+
+public:
+  explicit ScratchPeekStream(const std::vector<uint8_t> &data) : GifStream(data, true) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::ranges::fill(_scratch, uint8_t{0xCD});
+    return GifStream::real_read(size, data);
+  }
+
+  std::error_code real_seek(size_t position) override {
+    std::ranges::fill(_scratch, uint8_t{0xCD});
+    return GifStream::real_seek(position);
+  }
+
+  [[nodiscard]] std::span<const uint8_t> real_peek(size_t size) override {
+    const auto data = GifStream::real_peek(size);
+    _scratch.assign(data.begin(), data.end());
+    return _scratch;
+  }
+};
+
+std::vector<uint8_t> ReadFile(const std::string_view &fileName) {
+  const auto file = TestFileStream::CreateFromFilename(fileName);
+  REQUIRE(file != nullptr);
+  std::vector<uint8_t> data(file->Size());
+  REQUIRE_FALSE(file->Read(data));
+  return data;
+}
+
+e00::ResourceLoader::Result LoadGif(e00::Stream &stream) {
+  e00::impl::GifSpriteLoader loader;
+  return loader.ReadLoad({stream, e00::type_id<e00::Sprite>(), {}});
+}
+
+void CheckSameFrames(e00::Sprite &expected, e00::Sprite &sprite) {
+  REQUIRE(sprite.Size() == expected.Size());
+  REQUIRE(sprite.NumberOfImages() == expected.NumberOfImages());
+  for (size_t image = 0; image < expected.NumberOfImages(); ++image) {
+    expected.SetImageIndex(image);
+    sprite.SetImageIndex(image);
+    for (e00::BitmapSizeType y = 0; y < expected.Size().y; ++y) {
+      CAPTURE(image, y);
+      CHECK(std::ranges::equal(sprite.GetNativeLine(y), expected.GetNativeLine(y)));
+    }
+  }
+}
+}// namespace
 
 TEST_CASE("Load Sample Gif", "[resources]") {
   e00::impl::GifSpriteLoader loader;
@@ -10,17 +84,18 @@ TEST_CASE("Load Sample Gif", "[resources]") {
   const auto stream = TestFileStream::CreateFromFilename("tests/sample_1.gif");
   REQUIRE(stream != nullptr);
 
-  REQUIRE(loader.CanLoad(*stream));
+  REQUIRE(loader.CanLoad({*stream, e00::type_id<e00::Sprite>(), {}}));
   (void) stream->SeekTo(0);
 
-  if (const auto sp = loader.ReadLoad(*stream, e00::type_id<e00::Sprite>());
+  if (const auto sp = loader.ReadLoad({*stream, e00::type_id<e00::Sprite>(), {}});
       sp.IsType<e00::Sprite>()) {
     auto& sprite = sp.resource->As<e00::Sprite>();
     REQUIRE(sprite.Size().x == 10);
-    
+
     sprite.SetCurrentTime(std::chrono::milliseconds(0));
-    
+
     const auto out = TestFileStream::CreateFromFilename("test1.bmp", true);
+    REQUIRE(out != nullptr);
     sprite.SaveToBMP(*out);
   }
 }
@@ -32,16 +107,46 @@ TEST_CASE("Load Sample Animated Gif", "[resources]") {
   const auto stream = TestFileStream::CreateFromFilename("tests/sample-animated-400x300.gif");
   REQUIRE(stream != nullptr);
 
-  REQUIRE(loader.CanLoad(*stream));
+  REQUIRE(loader.CanLoad({*stream, e00::type_id<e00::Sprite>(), {}}));
   (void) stream->SeekTo(0);
 
-  if (const auto sp = loader.ReadLoad(*stream, e00::type_id<e00::Sprite>());
+  if (const auto sp = loader.ReadLoad({*stream, e00::type_id<e00::Sprite>(), {}});
       sp.IsType<e00::Sprite>()) {
     auto& sprite = sp.resource->As<e00::Sprite>();
-    
+
     sprite.SetCurrentTime(std::chrono::milliseconds(600));
-    
+
     const auto out = TestFileStream::CreateFromFilename("test2.bmp", true);
+    REQUIRE(out != nullptr);
     sprite.SaveToBMP(*out);
   }
 }
+
+TEST_CASE("GIF loader - Mapped and unmapped streams", "[resources]") {
+  for (const auto *fileName: {"tests/sample_1.gif", "tests/sample-animated-400x300.gif"}) {
+    CAPTURE(fileName);
+    const auto data = ReadFile(fileName);
+
+    GifStream unmapped(data, false);
+    auto expected = LoadGif(unmapped);
+    REQUIRE(expected.IsType<e00::Sprite>());
+    auto &expectedSprite = expected.resource->As<e00::Sprite>();
+
+    GifStream mapped(data, true);
+    auto result = LoadGif(mapped);
+    REQUIRE(result.IsType<e00::Sprite>());
+    CheckSameFrames(expectedSprite, result.resource->As<e00::Sprite>());
+
+    // Sub-blocks are only valid until the stream moves
+    ScratchPeekStream scratch(data);
+    result = LoadGif(scratch);
+    REQUIRE(result.IsType<e00::Sprite>());
+    CheckSameFrames(expectedSprite, result.resource->As<e00::Sprite>());
+
+    // Sub-blocks are peeked out of the buffer, which is refilled as the data is read
+    e00::BufferedStream buffered(std::make_unique<GifStream>(data, false), 300);
+    result = LoadGif(buffered);
+    REQUIRE(result.IsType<e00::Sprite>());
+    CheckSameFrames(expectedSprite, result.resource->As<e00::Sprite>());
+  }
+}
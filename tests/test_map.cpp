@@ -1,5 +1,7 @@
 #include "tests.hpp"
 
+#include "Loaders/WorldLoader.hpp"
+
 extern unsigned char testMap_160_by_50[];
 /*
 
@@ -47,3 +49,146 @@ TEST_CASE("Can load a map") {
 }
 
 */
+
+namespace {
+class MapStream : public e00::Stream {
+  std::vector<uint8_t> _data;
+
+public:
+  explicit MapStream(std::vector<uint8_t> data) : Stream(data.size()), _data(std::move(data)) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::memcpy(data, _data.data() + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+};
+
+// A 4x2 compiled map without tileset, the layer as given
+std::vector<uint8_t> CompiledMap(uint8_t idSize, e00::mapfile::Encoding encoding, const std::vector<uint8_t> &layer) {
+  std::vector<uint8_t> out(sizeof(e00::mapfile::Header) + sizeof(e00::mapfile::LayerHeader));
+  const e00::mapfile::Header header{e00::mapfile::Magic, e00::mapfile::Version, 4, 2, 0, idSize, 1, 0};
+  const e00::mapfile::LayerHeader layerHeader{static_cast<uint8_t>(encoding), {}, static_cast<uint32_t>(layer.size())};
+  std::memcpy(out.data(), &header, sizeof(header));
+  std::memcpy(out.data() + sizeof(header), &layerHeader, sizeof(layerHeader));
+  out.insert(out.end(), layer.begin(), layer.end());
+  return out;
+}
+
+e00::ResourceLoader::Result LoadCompiled(std::vector<uint8_t> data) {
+  MapStream stream(std::move(data));
+  e00::impl::WorldLoader loader;
+  return loader.ReadLoad({stream, e00::type_id<e00::Map>(), {}});
+}
+}// namespace
+
+TEST_CASE("Map - Compiled maps", "[map]") {
+  const std::vector<e00::TileIdType> expected{1, 1, 1, 2, 300, 300, 0, 0};
+
+  SECTION("Raw, one byte ids") {
+    const auto result = LoadCompiled(CompiledMap(1, e00::mapfile::Encoding::Raw, {1, 1, 1, 2, 7, 7, 0, 0}));
+    REQUIRE(result.IsType<e00::Map>());
+    const auto &map = static_cast<const e00::Map &>(*result.resource);
+    CHECK(map.Size() == e00::Vec2D<e00::WorldCoordinateType>(4, 2));
+    CHECK(std::ranges::equal(map.Tiles(), std::vector<e00::TileIdType>{1, 1, 1, 2, 7, 7, 0, 0}));
+  }
+
+  SECTION("Raw, two byte ids") {
+    const auto result = LoadCompiled(CompiledMap(2, e00::mapfile::Encoding::Raw, {1, 0, 1, 0, 1, 0, 2, 0, 44, 1, 44, 1, 0, 0, 0, 0}));
+    REQUIRE(result.IsType<e00::Map>());
+    CHECK(std::ranges::equal(static_cast<const e00::Map &>(*result.resource).Tiles(), expected));
+  }
+
+  SECTION("Run length") {
+    const auto result = LoadCompiled(CompiledMap(2, e00::mapfile::Encoding::RunLength, {3, 1, 0, 1, 2, 0, 2, 44, 1, 2, 0, 0}));
+    REQUIRE(result.IsType<e00::Map>());
+    const auto &map = static_cast<const e00::Map &>(*result.resource);
+    CHECK(std::ranges::equal(map.Tiles(), expected));
+    CHECK(map.Get({0, 1}) == 300);
+  }
+
+  SECTION("Invalid maps") {
+    // Runs going past the end of the map, or not reaching it
+    CHECK(LoadCompiled(CompiledMap(1, e00::mapfile::Encoding::RunLength, {9, 1})).error);
+    CHECK(LoadCompiled(CompiledMap(1, e00::mapfile::Encoding::RunLength, {3, 1})).error);
+    CHECK(LoadCompiled(CompiledMap(1, e00::mapfile::Encoding::RunLength, {0, 1, 8, 1})).error);
+
+    // Layer shorter than the map, or than it says
+    CHECK(LoadCompiled(CompiledMap(1, e00::mapfile::Encoding::Raw, {1, 2, 3})).error);
+    auto truncated = CompiledMap(1, e00::mapfile::Encoding::Raw, {1, 1, 1, 1, 1, 1, 1, 1});
+    truncated.pop_back();
+    CHECK(LoadCompiled(truncated).error);
+
+    CHECK(LoadCompiled(CompiledMap(3, e00::mapfile::Encoding::Raw, std::vector<uint8_t>(24))).error);
+  }
+}
+
+TEST_CASE("Map - Tile collision", "[map]") {
+  e00::Map map(100, 4);
+  map.Set({3, 1}, 7);
+  map.Set({70, 2}, 7);
+  map.Set({5, 1}, 9);
+
+  map.SetTileOptions(7, {.solid = 1});
+  map.SetTileOptions(9, {.trigger = 1, .cost = 3});
+  CHECK(map.OptionsAt({5, 1}) == e00::Map::TileOptions{.trigger = 1, .cost = 3});
+
+  CHECK(map.IsSolid(e00::Position{3, 1}));
+  CHECK_FALSE(map.IsSolid(e00::Position{5, 1}));
+  CHECK(map.IsSolid(e00::Position{100, 0}));
+
+  CHECK(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{0, 0, 4, 2}));
+  CHECK_FALSE(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{4, 0, 60, 4}));
+  CHECK_FALSE(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{0, 2, 70, 2}));
+  CHECK(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{0, 2, 71, 2}));
+  CHECK(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{60, 0, 40, 4}));
+  CHECK(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{90, 0, 11, 1}));
+
+  // Placing and replacing tiles keeps the grid up to date
+  map.Set({3, 1}, 9);
+  map.Set({64, 0}, 7);
+  CHECK_FALSE(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{0, 0, 64, 4}));
+  CHECK(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{63, 0, 2, 1}));
+
+  map.SetTileOptions(std::vector<e00::Map::TileOptions>{});
+  CHECK_FALSE(map.IsSolid(e00::RectT<e00::WorldCoordinateType>{0, 0, 100, 4}));
+}
+
+TEST_CASE("Map - Copies and moves", "[map]") {
+  e00::Map map(4, 2);
+  map.SetTileSize({2, 2});
+  map.SetTileset(e00::ResourceManager::GlobalResourceManager().TakeOwnership(e00::Bitmap::Create({6, 4}, e00::DrawableSurface::BitDepth::DEPTH_8, 256)));
+  map.Set({1, 1}, 3);
+  map.SetTileOptions(3, {.solid = 1});
+
+  const auto sameMap = [&](const e00::Map &other) {
+    CHECK(other.Size() == map.Size());
+    CHECK(other.TileSize() == map.TileSize());
+    CHECK(other.Tileset().get() == map.Tileset().get());
+    CHECK(std::ranges::equal(other.Tiles(), map.Tiles()));
+    CHECK(other.IsSolid(e00::Position{1, 1}));
+  };
+
+  e00::Map copy(map);
+  sameMap(copy);
+  CHECK(copy.Revision() == map.Revision());
+
+  e00::Map moved(std::move(copy));
+  sameMap(moved);
+  CHECK(moved.Revision() == map.Revision());
+
+  // Assignments are changes to the map assigned to
+  e00::Map assigned(1, 1);
+  const auto before = assigned.Revision();
+  assigned = map;
+  sameMap(assigned);
+  CHECK(assigned.Revision() > before);
+  CHECK(assigned.Revision() > map.Revision());
+
+  e00::Map moveAssigned(1, 1);
+  moveAssigned = std::move(moved);
+  sameMap(moveAssigned);
+  CHECK(moveAssigned.Revision() > map.Revision());
+}
@@ -258,6 +258,58 @@ TEST_CASE("Painter - Clipping", "[painter]") {
             }
         }
     }
+
+    SECTION("Clip stack") {
+        painter->SetNoPen();
+        painter->SetBrushIndex(3);
+
+        painter->PushClip({{2, 2}, {6, 6}});
+        painter->PushClip({{4, 0}, {10, 5}});
+        CHECK(painter->ClipRect() == RectT<BitmapSizeType>(4, 2, 4, 3));
+        painter->DrawRect({{0, 0}, {10, 10}});
+        painter->PopClip();
+
+        CHECK(painter->ClipRect() == RectT<BitmapSizeType>(2, 2, 6, 6));
+        painter->SetBrushIndex(4);
+        painter->DrawEllipse({{0, 0}, {10, 10}});
+        painter->PopClip();
+
+        // Unbalanced pops are ignored
+        painter->PopClip();
+        CHECK(painter->ClipRect() == RectT<BitmapSizeType>::maxArea());
+
+        CHECK(bmp->GetLineData(1)[5] == 0);
+        CHECK(bmp->GetLineData(4)[1] == 0);
+        CHECK(bmp->GetLineData(5)[5] == 4);
+        CHECK(bmp->GetLineData(8)[5] == 0);
+    }
+
+    SECTION("Lines and blits honour the clip") {
+        painter->PushClip({{3, 3}, {4, 4}});
+        painter->DrawLine({0, 5}, {9, 5});
+
+        auto src = Bitmap::Create({10, 10}, DrawableSurface::BitDepth::DEPTH_8, 256);
+        (void)src->SetPaletteColor(7, Color(0, 0, 255));
+        (void)bmp->SetPaletteColor(7, Color(0, 0, 255));
+        for (BitmapSizeType y = 0; y < 10; ++y) {
+            auto line = src->GetLineData(y);
+            std::fill(line.begin(), line.end(), uint8_t{7});
+        }
+        painter->DrawSurface(*src, {{0, 0}, {10, 2}}, {0, 3});
+        painter->PopClip();
+
+        auto row5 = bmp->GetLineData(5);
+        CHECK(row5[2] == 0);
+        CHECK(row5[3] == 1);
+        CHECK(row5[6] == 1);
+        CHECK(row5[7] == 0);
+
+        auto row3 = bmp->GetLineData(3);
+        CHECK(row3[2] == 0);
+        CHECK(row3[3] == 7);
+        CHECK(row3[6] == 7);
+        CHECK(row3[7] == 0);
+    }
 }
 
 TEST_CASE("Painter - DrawSurface", "[painter]") {
@@ -299,4 +351,81 @@ TEST_CASE("Painter - DrawSurface", "[painter]") {
         auto data = dst->GetLineData(0);
         CHECK(data[0] == 1);
     }
+
+    SECTION("Source palette changed between blits") {
+        (void)dst->SetPaletteColor(0, Color(0, 0, 0));
+        painter->DrawSurface(*src, {{0, 0}, {1, 1}}, {0, 0});
+        CHECK(dst->GetLineData(0)[0] == 1);
+
+        // The palettes no longer match, index 1 has to be remapped
+        (void)src->SetPaletteColor(1, Color(0, 0, 0));
+        painter->DrawSurface(*src, {{0, 0}, {1, 1}}, {0, 0});
+        CHECK(dst->GetLineData(0)[0] == 0);
+    }
+}
+
+TEST_CASE("Painter - Span fill", "[painter]") {
+    SECTION("DrawRect 32-bit") {
+        auto bmp = Bitmap::Create({8, 4}, DrawableSurface::BitDepth::DEPTH_32);
+        {
+            auto painter = bmp->BeginDraw();
+            painter->SetNoPen();
+            painter->SetBrushColor(Color(0x12, 0x34, 0x56));
+            painter->DrawRect({{2, 1}, {4, 2}});
+        }
+        auto line = bmp->GetLineData(1);
+        CHECK(helpers::BitmapDepth32::ReadColor(line, 1) == Color(0, 0, 0));
+        for (BitmapSizeType x = 2; x < 6; ++x) {
+            CHECK(helpers::BitmapDepth32::ReadColor(line, x) == Color(0x12, 0x34, 0x56));
+        }
+        CHECK(helpers::BitmapDepth32::ReadColor(line, 6) == Color(0, 0, 0));
+        CHECK(helpers::BitmapDepth32::ReadColor(bmp->GetLineData(3), 3) == Color(0, 0, 0));
+    }
+
+    SECTION("DrawRect 16-bit") {
+        auto bmp = Bitmap::Create({8, 4}, DrawableSurface::BitDepth::DEPTH_16);
+        {
+            auto painter = bmp->BeginDraw();
+            painter->SetNoPen();
+            painter->SetBrushColor(Color(255, 0, 0));
+            painter->DrawRect({{0, 0}, {8, 4}});
+        }
+        for (BitmapSizeType y = 0; y < 4; ++y) {
+            auto line = bmp->GetLineData(y);
+            for (size_t x = 0; x < 8; ++x) {
+                CHECK(line[x * 2] == 0x00);
+                CHECK(line[x * 2 + 1] == 0xF8);
+            }
+        }
+    }
+
+    SECTION("DrawRect 1-bit across byte boundaries") {
+        auto bmp = Bitmap::Create({24, 2}, DrawableSurface::BitDepth::DEPTH_1, 2);
+        {
+            auto painter = bmp->BeginDraw();
+            painter->SetNoPen();
+            painter->SetBrushIndex(1);
+            painter->DrawRect({{5, 0}, {14, 1}});
+        }
+        auto line = bmp->GetLineData(0);
+        CHECK(line[0] == 0x07);
+        CHECK(line[1] == 0xFF);
+        CHECK(line[2] == 0xE0);
+        CHECK(bmp->GetLineData(1)[1] == 0x00);
+    }
+
+    SECTION("DrawEllipse fill rows") {
+        auto bmp = Bitmap::Create({10, 10}, DrawableSurface::BitDepth::DEPTH_8, 256);
+        {
+            auto painter = bmp->BeginDraw();
+            painter->SetNoPen();
+            painter->SetBrushIndex(3);
+            painter->DrawEllipse({{0, 0}, {6, 10}});
+        }
+        auto data5 = bmp->GetLineData(5);
+        for (size_t x = 0; x <= 6; ++x) {
+            CHECK(data5[x] == 3);
+        }
+        CHECK(data5[7] == 0);
+    }
 }
@@ -0,0 +1,85 @@
+#include <catch2/catch_all.hpp>
+#include <Engine/Resource/Palette.hpp>
+
+using namespace e00;
+
+namespace {
+FixedPalette MakeGreyRamp() {
+    FixedPalette palette(256);
+    for (size_t i = 0; i < palette.size(); ++i) {
+        const auto v = static_cast<uint8_t>(i);
+        palette.set(i, Color(v, v, v));
+    }
+    return palette;
+}
+}// namespace
+
+TEST_CASE("Palette - Closest color lookup", "[palette]") {
+    SECTION("Palette colors map to themselves") {
+        FixedPalette palette(32);
+        for (size_t i = 0; i < palette.size(); ++i) {
+            palette.set(i, Color(static_cast<uint8_t>(i * 8), static_cast<uint8_t>(255 - i * 8), static_cast<uint8_t>(i * 4)));
+        }
+
+        for (size_t i = 0; i < palette.size(); ++i) {
+            CHECK(palette.findClosestColorIndex(palette[i]) == i);
+        }
+    }
+
+    SECTION("Palette colors sharing a cell still map to themselves") {
+        auto palette = MakeGreyRamp();
+        palette.set(100, Color(64, 64, 64));
+        palette.set(101, Color(65, 66, 67));
+        palette.set(102, Color(64, 64, 64));
+
+        CHECK(palette.findClosestColorIndex(Color(64, 64, 64)) == 64);
+        CHECK(palette.findClosestColorIndex(Color(65, 66, 67)) == 101);
+        CHECK(palette.findClosestColorIndex(Color(66, 66, 66)) == 66);
+    }
+
+    SECTION("Off-palette colors stay close to the exact match") {
+        auto palette = MakeGreyRamp();
+        for (int v = 0; v < 256; v += 3) {
+            const Color c(static_cast<uint8_t>(v), static_cast<uint8_t>(v), static_cast<uint8_t>(v));
+            const auto cached = palette.findClosestColorIndex(c);
+            const auto exact = palette.findExactClosestColorIndex(c);
+            CHECK(std::abs(static_cast<int>(palette[cached].red) - static_cast<int>(palette[exact].red)) < 8);
+        }
+    }
+
+    SECTION("Writes invalidate the cache") {
+        FixedPalette palette(16);
+        palette.set(0, Color(255, 0, 0));
+        CHECK(palette.findClosestColorIndex(Color(250, 10, 10)) == 0);
+
+        palette.set(5, Color(250, 10, 10));
+        CHECK(palette.findClosestColorIndex(Color(250, 10, 10)) == 5);
+
+        palette.set(7, Color(0, 0, 250));
+        CHECK(palette.findClosestColorIndex(Color(0, 0, 250)) == 7);
+
+        palette.resize(6);
+        CHECK(palette.findClosestColorIndex(Color(0, 0, 250)) != 7);
+    }
+
+    SECTION("Reads keep the revision") {
+        FixedPalette palette = MakeGreyRamp();
+        const auto revision = palette.revision();
+
+        CHECK(palette[3] == Color(3, 3, 3));
+        CHECK(std::count(palette.begin(), palette.end(), Color(3, 3, 3)) == 1);
+        CHECK(palette.revision() == revision);
+
+        palette.set(3, Color(4, 4, 4));
+        CHECK(palette.revision() != revision);
+    }
+
+    SECTION("Small palettes are matched exactly") {
+        FixedPalette palette(2);
+        palette.set(0, Color(0, 0, 0));
+        palette.set(1, Color(255, 255, 255));
+
+        CHECK(palette.findClosestColorIndex(Color(127, 127, 127)) == 0);
+        CHECK(palette.findClosestColorIndex(Color(128, 128, 128)) == 1);
+    }
+}
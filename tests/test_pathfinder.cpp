@@ -0,0 +1,222 @@
+#include "tests.hpp"
+
+#include <queue>
+#include <random>
+
+using namespace e00;
+
+namespace {
+constexpr TileIdType Wall = 1;
+constexpr TileIdType Mud = 2;
+
+// The position of a tile computed with signed offsets, known to be on the map
+Position At(int x, int y) {
+  return {static_cast<WorldCoordinateType>(x), static_cast<WorldCoordinateType>(y)};
+}
+
+// Cost of walking `path` the way the path finder counts it
+uint32_t PathCost(const Map &map, std::span<const Position> path) {
+  uint32_t cost = 0;
+  for (size_t i = 1; i < path.size(); ++i) {
+    const bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+    cost += (diagonal ? 14u : 10u) * (1u + map.OptionsAt(path[i]).cost);
+  }
+  return cost;
+}
+
+// Every step is to a neighbour, never through a wall or across the corner of one
+bool IsWalkable(const Map &map, std::span<const Position> path) {
+  for (size_t i = 0; i < path.size(); ++i) {
+    if (map.IsSolid(path[i])) return false;
+    if (i == 0) continue;
+
+    const int dx = path[i].x - path[i - 1].x;
+    const int dy = path[i].y - path[i - 1].y;
+    if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) return false;
+    if (dx != 0 && dy != 0
+        && (map.IsSolid(At(path[i - 1].x + dx, path[i - 1].y)) || map.IsSolid(At(path[i - 1].x, path[i - 1].y + dy)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Plain Dijkstra over every tile, what the path finder has to match
+uint32_t CheapestCost(const Map &map, Position from, Position to) {
+  const int width = map.Width();
+  const int height = map.Height();
+  const auto cellOf = [&](int x, int y) { return static_cast<size_t>(y * width + x); };
+
+  std::vector<uint32_t> best(cellOf(0, height), std::numeric_limits<uint32_t>::max());
+  using Entry = std::pair<uint32_t, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+
+  best[cellOf(from.x, from.y)] = 0;
+  open.push({0, cellOf(from.x, from.y)});
+  while (!open.empty()) {
+    const auto [cost, cell] = open.top();
+    open.pop();
+    if (cost != best[cell]) continue;
+    if (cell == cellOf(to.x, to.y)) return cost;
+
+    const int x = static_cast<int>(cell) % width;
+    const int y = static_cast<int>(cell) / width;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        const int nx = x + dx;
+        const int ny = y + dy;
+        if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+        const Position next = At(nx, ny);
+        if (map.IsSolid(next)) continue;
+        if (dx != 0 && dy != 0 && (map.IsSolid(At(nx, y)) || map.IsSolid(At(x, ny)))) continue;
+
+        const uint32_t nextCost = cost + (dx != 0 && dy != 0 ? 14u : 10u) * (1u + map.OptionsAt(next).cost);
+        if (nextCost < best[cellOf(nx, ny)]) {
+          best[cellOf(nx, ny)] = nextCost;
+          open.push({nextCost, cellOf(nx, ny)});
+        }
+      }
+    }
+  }
+
+  return std::numeric_limits<uint32_t>::max();
+}
+}// namespace
+
+TEST_CASE("PathFinder - Around a wall", "[pathfinder]") {
+  Map map(20, 10);
+  map.SetTileOptions(Wall, {.solid = 1});
+  for (uint16_t y = 0; y < 9; ++y) {
+    map.Set({10, y}, Wall);
+  }
+
+  PathFinder paths(&map);
+  std::vector<Position> path;
+  REQUIRE(paths.FindPath({2, 2}, {17, 2}, path));
+  CHECK(path.front() == Position(2, 2));
+  CHECK(path.back() == Position(17, 2));
+  CHECK(IsWalkable(map, path));
+  CHECK(std::ranges::find(path, Position(10, 9)) != path.end());
+  CHECK(PathCost(map, path) == CheapestCost(map, {2, 2}, {17, 2}));
+
+  // Closing the gap is seen right away, even though the path was cached
+  map.Set({10, 9}, Wall);
+  CHECK_FALSE(paths.FindPath({2, 2}, {17, 2}, path));
+  CHECK(path.empty());
+
+  CHECK(paths.FindPath({4, 4}, {4, 4}, path));
+  CHECK(path == std::vector<Position>{{4, 4}});
+  CHECK_FALSE(paths.FindPath({2, 2}, {10, 0}, path));
+  CHECK_FALSE(paths.FindPath({2, 2}, {20, 0}, path));
+}
+
+TEST_CASE("PathFinder - Optimal on random maps", "[pathfinder]") {
+  std::mt19937 random(42);
+
+  for (int round = 0; round < 20; ++round) {
+    Map map(40, 30);
+    map.SetTileOptions(Wall, {.solid = 1});
+    // Half the maps have costly tiles, the other half only uses jump points
+    map.SetTileOptions(Mud, {.cost = static_cast<uint8_t>(round % 2 ? 3 : 0)});
+    for (uint16_t y = 0; y < 30; ++y) {
+      for (uint16_t x = 0; x < 40; ++x) {
+        const auto roll = random() % 10;
+        map.Set({x, y}, roll < 3 ? Wall : roll < 5 ? Mud : 0);
+      }
+    }
+    map.Set({0, 0}, 0);
+
+    PathFinder paths(&map);
+    std::vector<Position> path;
+    for (int query = 0; query < 10; ++query) {
+      const auto to = At(static_cast<int>(random() % 40), static_cast<int>(random() % 30));
+      const auto expected = CheapestCost(map, {0, 0}, to);
+      const bool found = paths.FindPath({0, 0}, to, path);
+      REQUIRE(found == (expected != std::numeric_limits<uint32_t>::max()));
+      if (found) {
+        CHECK(IsWalkable(map, path));
+        CHECK(PathCost(map, path) == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("PathFinder - Batched requests within a budget", "[pathfinder]") {
+  Map map(64, 64);
+  map.SetTileOptions(Wall, {.solid = 1});
+  for (uint16_t y = 0; y < 63; ++y) {
+    map.Set({32, y}, Wall);
+  }
+
+  PathFinder paths(&map);
+  const std::vector<PathFinder::Query> queries{
+      {{1, 1}, {60, 1}},
+      {{1, 5}, {60, 5}},
+      {{1, 1}, {60, 1}},
+      {{1, 1}, {32, 0}},
+  };
+  std::vector<PathFinder::RequestId> ids;
+  paths.Request(queries, ids);
+  REQUIRE(ids.size() == 4);
+  CHECK(paths.StatusOf(ids[3]) == PathFinder::Status::NoPath);
+
+  // A tiny budget only gets part of the way; the expansion that goes over it still finishes its jumps
+  CHECK(paths.Process(2) >= 2);
+  CHECK(paths.StatusOf(ids[0]) == PathFinder::Status::Pending);
+  CHECK(paths.PathOf(ids[0]).empty());
+
+  size_t ticks = 0;
+  while (paths.PendingRequests() > 0 && ticks < 1000) {
+    paths.Process(512);
+    ++ticks;
+  }
+  CHECK(ticks > 1);
+  REQUIRE(paths.StatusOf(ids[0]) == PathFinder::Status::Found);
+  REQUIRE(paths.StatusOf(ids[1]) == PathFinder::Status::Found);
+  REQUIRE(paths.StatusOf(ids[2]) == PathFinder::Status::Found);
+  CHECK(std::ranges::equal(paths.PathOf(ids[0]), paths.PathOf(ids[2])));
+  CHECK(IsWalkable(map, paths.PathOf(ids[1])));
+
+  // Cached: answered without searching
+  const auto again = paths.Request({1, 5}, {60, 5});
+  CHECK(paths.StatusOf(again) == PathFinder::Status::Found);
+
+  // Until a tile changes
+  map.Set({40, 40}, Wall);
+  const auto afterChange = paths.Request({1, 5}, {60, 5});
+  CHECK(paths.StatusOf(afterChange) == PathFinder::Status::Pending);
+
+  // Released handles stop resolving, their slot is reused
+  paths.Release(afterChange);
+  CHECK(paths.StatusOf(afterChange) == PathFinder::Status::Invalid);
+  CHECK(paths.PendingRequests() == 0);
+  const auto reused = paths.Request({1, 1}, {2, 2});
+  CHECK(reused != afterChange);
+  CHECK(paths.StatusOf(afterChange) == PathFinder::Status::Invalid);
+  paths.Process(detail::PathSearchBudgetPerTick);
+  CHECK(paths.StatusOf(reused) == PathFinder::Status::Found);
+}
+
+TEST_CASE("PathFinder - Tile options changes", "[pathfinder]") {
+  Map map(20, 10);
+  for (uint16_t y = 0; y < 10; ++y) {
+    map.Set({10, y}, Mud);
+  }
+
+  PathFinder paths(&map);
+  std::vector<Position> path;
+  REQUIRE(paths.FindPath({2, 2}, {17, 2}, path));
+
+  // The same tiles turning solid cut the map in two
+  map.SetTileOptions(Mud, {.solid = 1});
+  CHECK_FALSE(paths.FindPath({2, 2}, {17, 2}, path));
+
+  // And replacing every option opens it again, at a cost
+  std::vector<Map::TileOptions> options(Mud + 1);
+  options[Mud].cost = 3;
+  map.SetTileOptions(std::move(options));
+  REQUIRE(paths.FindPath({2, 2}, {17, 2}, path));
+  CHECK(IsWalkable(map, path));
+  CHECK(PathCost(map, path) == CheapestCost(map, {2, 2}, {17, 2}));
+}
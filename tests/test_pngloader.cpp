@@ -0,0 +1,432 @@
+#include "tests.hpp"
+
+#include "Loaders/PngFilters.hpp"
+#include "Loaders/PngLoader.hpp"
+
+#include <random>
+
+using namespace e00;
+
+namespace {
+// Says it is in memory through Map() only when `mapped`
+class PngStream : public Stream {
+  std::vector<uint8_t> _data;
+  bool _mapped;
+
+public:
+  explicit PngStream(std::vector<uint8_t> data, bool mapped = false) : Stream(data.size()), _data(std::move(data)), _mapped(mapped) {}
+
+protected:
+  std::error_code real_read(size_t size, void *data) override {
+    std::memcpy(data, _data.data() + _current_position, size);
+    return {};
+  }
+
+  std::error_code real_seek(size_t) override { return {}; }
+
+  [[nodiscard]] std::span<const uint8_t> real_map() const override {
+    return _mapped ? std::span<const uint8_t>(_data) : std::span<const uint8_t>();
+  }
+};
+
+void AppendUint32(std::vector<uint8_t> &out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+uint32_t Crc32(std::span<const uint8_t> data) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (const auto byte: data) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+    }
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+void AppendChunk(std::vector<uint8_t> &out, std::string_view type, const std::vector<uint8_t> &data) {
+  AppendUint32(out, static_cast<uint32_t>(data.size()));
+  const auto start = out.size();
+  out.insert(out.end(), type.begin(), type.end());
+  out.insert(out.end(), data.begin(), data.end());
+  AppendUint32(out, Crc32(std::span(out).subspan(start)));
+}
+
+// A zlib stream of stored (uncompressed) blocks
+std::vector<uint8_t> Deflate(const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> out{0x78, 0x01};
+  size_t offset = 0;
+  do {
+    const auto size = std::min<size_t>(data.size() - offset, 0xFFFF);
+    out.push_back(offset + size == data.size() ? 1 : 0);
+    out.push_back(static_cast<uint8_t>(size));
+    out.push_back(static_cast<uint8_t>(size >> 8));
+    out.push_back(static_cast<uint8_t>(~size));
+    out.push_back(static_cast<uint8_t>(~size >> 8));
+    const auto block = std::span(data).subspan(offset, size);
+    out.insert(out.end(), block.begin(), block.end());
+    offset += size;
+  } while (offset < data.size());
+
+  uint32_t a = 1, b = 0;
+  for (const auto byte: data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  AppendUint32(out, (b << 16) | a);
+  return out;
+}
+
+uint8_t Paeth(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+  return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+}
+
+// What the filter of `type` predicts for byte `x` of a row, from the unfiltered bytes
+uint8_t Predict(int type, const std::vector<uint8_t> &row, const std::vector<uint8_t> &above, size_t x, size_t bpp) {
+  const int a = x >= bpp ? row[x - bpp] : 0;
+  const int b = above[x];
+  const int c = x >= bpp ? above[x - bpp] : 0;
+  switch (type) {
+    case 1: return static_cast<uint8_t>(a);
+    case 2: return static_cast<uint8_t>(b);
+    case 3: return static_cast<uint8_t>((a + b) / 2);
+    case 4: return Paeth(a, b, c);
+    default: return 0;
+  }
+}
+
+/**
+ * An image of `channels` samples per pixel, each `bitDepth` bits
+ */
+struct TestImage {
+  uint32_t width;
+  uint32_t height;
+  uint8_t colorType;
+  uint8_t bitDepth;
+  size_t channels;
+  std::vector<uint16_t> samples;
+
+  [[nodiscard]] uint16_t Sample(size_t x, size_t y, size_t channel) const { return samples[(y * width + x) * channels + channel]; }
+
+  // The filtered rows of the pixels from (startX, startY) every stepX and stepY, filters cycling through all 5 types
+  void AppendPass(std::vector<uint8_t> &out, size_t startX, size_t startY, size_t stepX, size_t stepY) const {
+    if (startX >= width || startY >= height) return;
+
+    const size_t bpp = std::max<size_t>(1, channels * bitDepth / 8);
+    std::vector<uint8_t> above;
+    for (size_t y = startY, n = 0; y < height; y += stepY, ++n) {
+      std::vector<uint8_t> row;
+      size_t bits = 0;
+      for (size_t x = startX; x < width; x += stepX) {
+        for (size_t channel = 0; channel < channels; ++channel) {
+          for (int bit = bitDepth - 1; bit >= 0; --bit, ++bits) {
+            if (bits % 8 == 0) row.push_back(0);
+            row.back() |= static_cast<uint8_t>(((Sample(x, y, channel) >> bit) & 1) << (7 - bits % 8));
+          }
+        }
+      }
+      above.resize(row.size());
+
+      const int type = static_cast<int>(n % 5);
+      out.push_back(static_cast<uint8_t>(type));
+      for (size_t x = 0; x < row.size(); ++x) {
+        out.push_back(static_cast<uint8_t>(row[x] - Predict(type, row, above, x, bpp)));
+      }
+      above = row;
+    }
+  }
+
+  // The image data goes in IDAT chunks of `chunkSize` bytes after an empty one, or in two halves when 0
+  [[nodiscard]] std::vector<uint8_t> Encode(bool interlaced, size_t chunkSize = 0) const {
+    std::vector<uint8_t> data;
+    if (interlaced) {
+      static constexpr size_t passes[7][4]{{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+      for (const auto &pass: passes) {
+        AppendPass(data, pass[0], pass[1], pass[2], pass[3]);
+      }
+    } else {
+      AppendPass(data, 0, 0, 1, 1);
+    }
+
+    std::vector<uint8_t> png{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+    std::vector<uint8_t> header;
+    AppendUint32(header, width);
+    AppendUint32(header, height);
+    header.insert(header.end(), {bitDepth, colorType, 0, 0, static_cast<uint8_t>(interlaced ? 1 : 0)});
+    AppendChunk(png, "IHDR", header);
+
+    if (colorType == 3) {
+      std::vector<uint8_t> palette;
+      for (size_t i = 0; i < (size_t{1} << bitDepth); ++i) {
+        palette.insert(palette.end(), {static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i), 7});
+      }
+      AppendChunk(png, "PLTE", palette);
+    }
+
+    // Split, IDAT chunks only make sense together
+    const auto compressed = Deflate(data);
+    if (chunkSize == 0) {
+      const auto half = compressed.begin() + static_cast<ptrdiff_t>(compressed.size() / 2);
+      AppendChunk(png, "IDAT", {compressed.begin(), half});
+      AppendChunk(png, "IDAT", {half, compressed.end()});
+    } else {
+      AppendChunk(png, "IDAT", {});
+      for (size_t offset = 0; offset < compressed.size(); offset += chunkSize) {
+        const auto chunk = std::span(compressed).subspan(offset, std::min(chunkSize, compressed.size() - offset));
+        AppendChunk(png, "IDAT", {chunk.begin(), chunk.end()});
+      }
+    }
+    AppendChunk(png, "IEND", {});
+    return png;
+  }
+};
+
+TestImage RandomImage(uint8_t colorType, uint8_t bitDepth, std::mt19937 &random, uint32_t width = 13, uint32_t height = 11) {
+  static constexpr size_t channels[7]{1, 0, 3, 1, 2, 0, 4};
+  TestImage image{width, height, colorType, bitDepth, channels[colorType], {}};
+  image.samples.resize(image.width * image.height * image.channels);
+  for (auto &sample: image.samples) {
+    sample = static_cast<uint16_t>(random() & ((1u << bitDepth) - 1));
+  }
+  return image;
+}
+
+ResourceLoader::Result LoadPng(Stream &stream) {
+  impl::PNGLoader loader;
+  return loader.ReadLoad({stream, type_id<Bitmap>(), {}});
+}
+
+ResourceLoader::Result LoadPng(std::vector<uint8_t> data) {
+  PngStream stream(std::move(data));
+  return LoadPng(stream);
+}
+
+// The 8 bits of a sample the bitmap keeps
+uint8_t High(const TestImage &image, size_t x, size_t y, size_t channel) {
+  const auto sample = image.Sample(x, y, channel);
+  return static_cast<uint8_t>(image.bitDepth == 16 ? sample >> 8 : sample);
+}
+
+void CheckPixels(const TestImage &image, Bitmap &bitmap) {
+  REQUIRE(bitmap.Size() == Vec2D<BitmapSizeType>(static_cast<BitmapSizeType>(image.width), static_cast<BitmapSizeType>(image.height)));
+
+  const bool indexed = image.colorType == 0 || image.colorType == 3;
+  REQUIRE(bitmap.GetBitDepth() == (indexed ? Bitmap::BitDepth::DEPTH_8 : Bitmap::BitDepth::DEPTH_32));
+
+  size_t mismatches = 0;
+  for (BitmapSizeType y = 0; y < image.height; ++y) {
+    const auto line = bitmap.GetLineData(y);
+    for (size_t x = 0; x < image.width; ++x) {
+      if (indexed) {
+        mismatches += line[x] != High(image, x, y, 0);
+        continue;
+      }
+
+      const bool grey = image.colorType == 4;
+      const uint32_t alpha = image.channels % 2 == 0 ? High(image, x, y, image.channels - 1) : 0xFF;
+      const uint32_t expected = (alpha << 24)
+                                | (uint32_t{High(image, x, y, 0)} << 16)
+                                | (uint32_t{High(image, x, y, grey ? 0 : 1)} << 8)
+                                | High(image, x, y, grey ? 0 : 2);
+      uint32_t pixel;
+      std::memcpy(&pixel, line.data() + x * 4, 4);
+      mismatches += pixel != expected;
+    }
+  }
+  CHECK(mismatches == 0);
+}
+
+// The unfilters as the PNG specification writes them
+void ReferenceUnfilter(int type, std::vector<uint8_t> &row, const std::vector<uint8_t> &above, size_t bpp) {
+  for (size_t x = 0; x < row.size(); ++x) {
+    row[x] = static_cast<uint8_t>(row[x] + Predict(type, row, above, x, bpp));
+  }
+}
+}// namespace
+
+TEST_CASE("PNG loader - Colour types and bit depths", "[png]") {
+  std::mt19937 random(25);
+  const std::vector<std::pair<uint8_t, std::vector<uint8_t>>> formats{
+      {0, {1, 2, 4, 8, 16}},
+      {2, {8, 16}},
+      {3, {1, 2, 4, 8}},
+      {4, {8, 16}},
+      {6, {8, 16}},
+  };
+
+  for (const auto &[colorType, depths]: formats) {
+    for (const auto bitDepth: depths) {
+      for (const bool interlaced: {false, true}) {
+        CAPTURE(colorType, bitDepth, interlaced);
+        const auto image = RandomImage(colorType, bitDepth, random);
+        auto result = LoadPng(image.Encode(interlaced));
+        REQUIRE_FALSE(result.error);
+        REQUIRE(result.IsType<Bitmap>());
+        auto &bitmap = static_cast<Bitmap &>(*result.resource);
+        CheckPixels(image, bitmap);
+
+        if (colorType == 0) {
+          // A ramp of greys, as many as the samples allow
+          const auto levels = size_t{1} << std::min<uint8_t>(bitDepth, 8);
+          CHECK(bitmap.GetNumberOfColorsInPalette() == levels);
+          CHECK(bitmap.GetColorFromPalette(levels - 1) == Color(255, 255, 255));
+        } else if (colorType == 3) {
+          CHECK(bitmap.GetColorFromPalette(1) == Color(1, 254, 7));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("PNG loader - Tiny interlaced images", "[png]") {
+  // Images smaller than 8x8 leave some passes empty
+  std::mt19937 random(7);
+  for (uint32_t width = 1; width <= 3; ++width) {
+    for (uint32_t height = 1; height <= 5; height += 2) {
+      CAPTURE(width, height);
+      auto image = RandomImage(6, 8, random);
+      image.width = width;
+      image.height = height;
+      image.samples.resize(width * height * image.channels);
+      auto result = LoadPng(image.Encode(true));
+      REQUIRE(result.IsType<Bitmap>());
+      CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+    }
+  }
+}
+
+TEST_CASE("PNG loader - Mapped and unmapped streams", "[png]") {
+  std::mt19937 random(21);
+  for (const uint8_t colorType: std::initializer_list<uint8_t>{0, 2, 3, 6}) {
+    for (const bool interlaced: {false, true}) {
+      CAPTURE(colorType, interlaced);
+      const auto image = RandomImage(colorType, 8, random);
+      const auto png = image.Encode(interlaced);
+
+      PngStream mapped(png, true);
+      auto result = LoadPng(mapped);
+      REQUIRE(result.IsType<Bitmap>());
+      CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+
+      // Chunks are peeked out of the buffer when they fit, read through it otherwise
+      BufferedStream buffered(std::make_unique<PngStream>(png), 64);
+      result = LoadPng(buffered);
+      REQUIRE(result.IsType<Bitmap>());
+      CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+    }
+  }
+
+  // A real file, compressed
+  const auto file = TestFileStream::CreateFromFilename("tests/labeled_overworldtiles.png");
+  REQUIRE(file != nullptr);
+  std::vector<uint8_t> data(file->Size());
+  REQUIRE_FALSE(file->Read(data));
+
+  auto unmapped = LoadPng(data);
+  PngStream mappedFile(data, true);
+  auto mapped = LoadPng(mappedFile);
+  REQUIRE(unmapped.IsType<Bitmap>());
+  REQUIRE(mapped.IsType<Bitmap>());
+  auto &expected = static_cast<Bitmap &>(*unmapped.resource);
+  auto &bitmap = static_cast<Bitmap &>(*mapped.resource);
+  REQUIRE(bitmap.Size() == expected.Size());
+  for (BitmapSizeType y = 0; y < expected.Size().y; ++y) {
+    CHECK(std::ranges::equal(bitmap.GetNativeLine(y), expected.GetNativeLine(y)));
+  }
+}
+
+TEST_CASE("PNG loader - Image data split across IDAT chunks", "[png]") {
+  // Rows are unfiltered as soon as they are inflated, whatever chunk they started in
+  std::mt19937 random(24);
+  for (const size_t chunkSize: {size_t{1}, size_t{7}, size_t{4096}}) {
+    for (const bool interlaced: {false, true}) {
+      CAPTURE(chunkSize, interlaced);
+      const auto image = RandomImage(2, 8, random);
+      const auto png = image.Encode(interlaced, chunkSize);
+
+      auto result = LoadPng(png);
+      REQUIRE(result.IsType<Bitmap>());
+      CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+
+      PngStream mapped(png, true);
+      result = LoadPng(mapped);
+      REQUIRE(result.IsType<Bitmap>());
+      CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+    }
+  }
+}
+
+TEST_CASE("PNG loader - Rows longer than the inflate buffer", "[png]") {
+  // 8800 bytes a row, inflated in more than one go when the chunks are not peeked
+  std::mt19937 random(2024);
+  for (const bool interlaced: {false, true}) {
+    CAPTURE(interlaced);
+    const auto image = RandomImage(6, 16, random, 1100, 3);
+    const auto png = image.Encode(interlaced);
+
+    auto result = LoadPng(png);
+    REQUIRE(result.IsType<Bitmap>());
+    CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+
+    BufferedStream buffered(std::make_unique<PngStream>(png), 64);
+    result = LoadPng(buffered);
+    REQUIRE(result.IsType<Bitmap>());
+    CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+
+    PngStream mapped(png, true);
+    result = LoadPng(mapped);
+    REQUIRE(result.IsType<Bitmap>());
+    CheckPixels(image, static_cast<Bitmap &>(*result.resource));
+  }
+}
+
+TEST_CASE("PNG loader - Invalid images", "[png]") {
+  std::mt19937 random(3);
+
+  // Bit depth not allowed for the colour type
+  auto image = RandomImage(2, 8, random);
+  image.bitDepth = 4;
+  CHECK(LoadPng(image.Encode(false)).error);
+
+  // Image data missing rows
+  image = RandomImage(2, 8, random);
+  auto shorter = image;
+  shorter.height = image.height - 2;
+  shorter.samples.resize(shorter.width * shorter.height * shorter.channels);
+  auto png = shorter.Encode(false);
+  png[23] = static_cast<uint8_t>(image.height);
+  const auto crc = Crc32(std::span(png).subspan(12, 17));
+  for (size_t i = 0; i < 4; ++i) {
+    png[29 + i] = static_cast<uint8_t>(crc >> (24 - 8 * i));
+  }
+  CHECK(LoadPng(png).error);
+}
+
+TEST_CASE("PNG filters - Same as the specification", "[png]") {
+  std::mt19937 random(42);
+  for (size_t bpp = 1; bpp <= 8; ++bpp) {
+    for (int type = 1; type <= 4; ++type) {
+      CAPTURE(bpp, type);
+      const size_t rowBytes = bpp * 37;
+      std::vector<uint8_t> above(rowBytes);
+      std::vector<uint8_t> expected(rowBytes);
+      for (auto &byte: above) byte = static_cast<uint8_t>(random());
+      for (auto &byte: expected) byte = static_cast<uint8_t>(random());
+      auto row = expected;
+
+      ReferenceUnfilter(type, expected, above, bpp);
+      switch (type) {
+        case 1: impl::png::UnfilterSub(row.data(), rowBytes, bpp); break;
+        case 2: impl::png::UnfilterUp(row.data(), above.data(), rowBytes); break;
+        case 3: impl::png::UnfilterAverage(row.data(), above.data(), rowBytes, bpp); break;
+        case 4: impl::png::UnfilterPaeth(row.data(), above.data(), rowBytes, bpp); break;
+        default: break;
+      }
+      CHECK(row == expected);
+    }
+  }
+}
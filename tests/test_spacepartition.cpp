@@ -0,0 +1,163 @@
+#include "tests.hpp"
+
+#include <random>
+
+using namespace e00;
+
+namespace {
+using Tree = QuadTree<uint32_t, 4>;
+using Point = Vec2D<WorldCoordinateType>;
+
+std::vector<uint32_t> Sorted(std::vector<uint32_t> values) {
+  std::ranges::sort(values);
+  return values;
+}
+
+std::vector<uint32_t> BruteForceQuery(const std::vector<Point> &points, const std::vector<bool> &alive, const RectT<WorldCoordinateType> &area) {
+  std::vector<uint32_t> found;
+  for (uint32_t i = 0; i < points.size(); ++i) {
+    if (alive[i] && area.Contains(points[i])) {
+      found.push_back(i);
+    }
+  }
+  return found;
+}
+}// namespace
+
+TEST_CASE("QuadTree - Insert and query", "[spacepartition]") {
+  Tree tree({{0, 0}, {100, 60}});
+
+  REQUIRE(tree.Insert(1, {10, 10}));
+  REQUIRE(tree.Insert(2, {99, 59}));
+  REQUIRE_FALSE(tree.Insert(3, {100, 10}));
+  CHECK(tree.Size() == 2);
+
+  std::vector<uint32_t> found;
+  CHECK(tree.Query({{0, 0}, {20, 20}}, found) == std::vector<uint32_t>{1});
+
+  found.clear();
+  CHECK(Sorted(tree.Query({{0, 0}, {100, 60}}, found)) == std::vector<uint32_t>{1, 2});
+}
+
+TEST_CASE("QuadTree - Matches a linear scan", "[spacepartition]") {
+  // Odd size on purpose, quadrants have to cover every coordinate
+  const RectT<WorldCoordinateType> bounds{{0, 0}, {97, 61}};
+  Tree tree(bounds);
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> randomX(0, bounds.size.x - 1);
+  std::uniform_int_distribution<int> randomY(0, bounds.size.y - 1);
+  const auto randomPoint = [&] { return Point(static_cast<WorldCoordinateType>(randomX(rng)), static_cast<WorldCoordinateType>(randomY(rng))); };
+
+  std::vector<Point> points;
+  std::vector<bool> alive;
+  for (uint32_t i = 0; i < 300; ++i) {
+    points.push_back(randomPoint());
+    alive.push_back(true);
+    REQUIRE(tree.Insert(i, points.back()));
+  }
+
+  // Move a third, remove a third
+  for (uint32_t i = 0; i < 300; i += 3) {
+    const auto to = randomPoint();
+    REQUIRE(tree.Move(i, points[i], to));
+    points[i] = to;
+  }
+  for (uint32_t i = 1; i < 300; i += 3) {
+    REQUIRE(tree.Remove(i, points[i]));
+    alive[i] = false;
+  }
+  CHECK(tree.Size() == 200);
+
+  // Already gone
+  CHECK_FALSE(tree.Remove(1, points[1]));
+
+  for (int q = 0; q < 50; ++q) {
+    const auto from = randomPoint();
+    const RectT<WorldCoordinateType> area{from, {static_cast<WorldCoordinateType>(1 + q), static_cast<WorldCoordinateType>(1 + q / 2)}};
+
+    std::vector<uint32_t> found;
+    CHECK(Sorted(tree.Query(area, found)) == BruteForceQuery(points, alive, area));
+  }
+
+  SECTION("Nearest") {
+    const Point from = randomPoint();
+
+    std::vector<uint32_t> found;
+    tree.Nearest(from, 10, found);
+    REQUIRE(found.size() == 10);
+
+    // Closest first, and nothing left out is closer than the last one found
+    std::vector<uint64_t> distances;
+    for (const auto id : found) {
+      distances.push_back(detailsp::DistanceSquared(points[id], from));
+    }
+    CHECK(std::ranges::is_sorted(distances));
+
+    for (uint32_t i = 0; i < points.size(); ++i) {
+      if (alive[i] && std::ranges::find(found, i) == found.end()) {
+        CHECK(detailsp::DistanceSquared(points[i], from) >= distances.back());
+      }
+    }
+  }
+
+  SECTION("Removing everything") {
+    for (uint32_t i = 0; i < 300; ++i) {
+      if (alive[i]) {
+        REQUIRE(tree.Remove(i, points[i]));
+      }
+    }
+
+    CHECK(tree.Empty());
+    std::vector<uint32_t> found;
+    CHECK(tree.Query(bounds, found).empty());
+  }
+}
+
+TEST_CASE("QuadTree - Many items on one point", "[spacepartition]") {
+  Tree tree({{0, 0}, {16, 16}});
+  for (uint32_t i = 0; i < 50; ++i) {
+    REQUIRE(tree.Insert(i, {5, 5}));
+  }
+
+  std::vector<uint32_t> found;
+  CHECK(tree.Query({{5, 5}, {1, 1}}, found).size() == 50);
+}
+
+TEST_CASE("QuadTree - Node pool", "[spacepartition]") {
+  SECTION("Freed slots are handed out again") {
+    detailsp::Pool<detailsp::NodeItem, 4> pool;
+    auto *a = pool.Create();
+    auto *b = pool.Create();
+    pool.Destroy(a);
+    CHECK(pool.Create() == a);
+
+    // Past the first block
+    std::vector<detailsp::NodeItem *> more;
+    for (int i = 0; i < 10; ++i) {
+      more.push_back(pool.Create());
+    }
+    CHECK(std::ranges::find(more, b) == more.end());
+
+    // Blocks are kept, the first slot comes back after a reset
+    pool.Reset();
+    CHECK(pool.Create() == a);
+  }
+
+  SECTION("Reset drops every item") {
+    Tree tree({{0, 0}, {64, 64}});
+    for (uint32_t i = 0; i < 100; ++i) {
+      REQUIRE(tree.Insert(i, {static_cast<WorldCoordinateType>(i % 64), static_cast<WorldCoordinateType>(i / 2)}));
+    }
+
+    tree.Reset({{0, 0}, {32, 32}});
+    CHECK(tree.Empty());
+    CHECK(tree.Boundaries() == RectT<WorldCoordinateType>{{0, 0}, {32, 32}});
+
+    REQUIRE(tree.Insert(7, {3, 3}));
+    REQUIRE_FALSE(tree.Insert(8, {40, 3}));
+
+    std::vector<uint32_t> found;
+    CHECK(tree.Query({{0, 0}, {32, 32}}, found) == std::vector<uint32_t>{7});
+  }
+}
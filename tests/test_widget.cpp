@@ -44,3 +44,147 @@ TEST_CASE("Widget test", "Widgets") {
   REQUIRE(wstream != nullptr);
   target->SaveToBMP(*wstream);
 }
+
+TEST_CASE("Widget - Dirty rects", "Widgets") {
+  const std::unique_ptr<e00::World> noWorld;
+  e00::Widget root;
+  root.Resize({320, 200});
+  (void)root.TakeDirtyRects();
+
+  SECTION("Nothing changed, nothing to repaint") {
+    CHECK(root.TakeDirtyRects().empty());
+  }
+
+  SECTION("Adding a child dirties its area") {
+    auto *child = root.AddChild<e00::Widget>();
+    child->Move({10, 20});
+    child->SetFixedSize({30, 40});
+    (void)root.TakeDirtyRects();
+
+    child->Move({100, 20});
+    const auto dirty = root.TakeDirtyRects();
+    REQUIRE(dirty.size() == 2);
+    CHECK(dirty[0] == e00::RectT<uint16_t>(10, 20, 30, 40));
+    CHECK(dirty[1] == e00::RectT<uint16_t>(100, 20, 30, 40));
+  }
+
+  SECTION("Overlapping areas are merged") {
+    root.Invalidate({0, 0, 10, 10});
+    root.Invalidate({5, 5, 10, 10});
+    const auto dirty = root.TakeDirtyRects();
+    REQUIRE(dirty.size() == 1);
+    CHECK(dirty[0] == e00::RectT<uint16_t>(0, 0, 15, 15));
+  }
+
+  SECTION("Label text changes dirty the label") {
+    auto *label = root.AddChild<e00::LabelWidget>("Hello");
+    label->Move({50, 50});
+    (void)root.TakeDirtyRects();
+
+    label->SetText("Hallo");
+    const auto dirty = root.TakeDirtyRects();
+    REQUIRE(dirty.size() == 1);
+    CHECK(dirty[0].origin == e00::Vec2D<uint16_t>(50, 50));
+  }
+
+  SECTION("Painting is clipped to the dirty areas") {
+    auto target = e00::Bitmap::Create({320, 200}, e00::DrawableSurface::BitDepth::DEPTH_32);
+    (void)root.AddChild<e00::WorldWidget>(noWorld);
+
+    const auto dirty = root.TakeDirtyRects();
+    CHECK(dirty.size() == 1);
+
+    {
+      auto painter = target->BeginDraw();
+      painter->SetBrushColor({255, 255, 255});
+      painter->SetNoPen();
+      painter->DrawRect({0, 0, 320, 200});
+
+      const std::array<e00::RectT<uint16_t>, 1> area{e00::RectT<uint16_t>(10, 10, 5, 5)};
+      root.PaintDirtyRects(*painter, area);
+    }
+
+    CHECK(e00::helpers::BitmapDepth32::ReadColor(target->GetLineData(12), 12) == e00::Color(0, 0, 0));
+    CHECK(e00::helpers::BitmapDepth32::ReadColor(target->GetLineData(12), 16) == e00::Color(255, 255, 255));
+    CHECK(e00::helpers::BitmapDepth32::ReadColor(target->GetLineData(20), 12) == e00::Color(255, 255, 255));
+
+    // Always repainting widgets are dirty on every frame
+    CHECK(root.TakeDirtyRects().size() == 1);
+  }
+}
+
+TEST_CASE("Widget - World smooth scrolling", "Widgets") {
+  // 4 tiles of 2x2, every pixel of every tile is a different colour
+  auto tiles = e00::Bitmap::Create({8, 2}, e00::DrawableSurface::BitDepth::DEPTH_32);
+  for (e00::BitmapSizeType y = 0; y < 2; ++y) {
+    auto line = tiles->GetLineData(y);
+    for (e00::BitmapSizeType x = 0; x < 8; ++x) {
+      e00::helpers::BitmapDepth32::WriteColor(line, x, e00::Color(static_cast<uint8_t>(x * 30), static_cast<uint8_t>(y * 100 + 50), 200));
+    }
+  }
+
+  auto map = e00::ResourceManager::GlobalResourceManager().TakeOwnership(std::make_unique<e00::Map>(8, 6));
+  for (e00::WorldCoordinateType y = 0; y < 6; ++y) {
+    for (e00::WorldCoordinateType x = 0; x < 8; ++x) {
+      // Some empty tiles, they must come out black
+      map->Set({x, y}, static_cast<e00::TileIdType>((x + 2 * y) % 5));
+    }
+  }
+  map->SetTileset(e00::ResourceManager::GlobalResourceManager().TakeOwnership(std::move(tiles)));
+  map->SetTileSize({2, 2});
+
+  std::unique_ptr<e00::World> world = std::make_unique<e00::World>("scrolling");
+  world->AddMap(std::move(map));
+
+  const auto depth = GENERATE(e00::DrawableSurface::BitDepth::DEPTH_16, e00::DrawableSurface::BitDepth::DEPTH_32);
+  auto scrolledTarget = e00::Bitmap::Create({6, 5}, depth);
+  auto freshTarget = e00::Bitmap::Create({6, 5}, depth);
+
+  e00::WorldWidget scrolled(world);
+  scrolled.Resize({6, 5});
+
+  // Small moves in every direction, then a jump further than the view
+  const std::vector<e00::Vec2D<uint32_t>> cameraPath{{6, 5}, {7, 5}, {7, 7}, {5, 6}, {4, 3}, {4, 4}, {12, 9}};
+  for (const auto &camera : cameraPath) {
+    scrolled.SetCameraCenterPixels(camera);
+    scrolled.Paint(*scrolledTarget->BeginDraw());
+
+    // Same camera painted from scratch
+    e00::WorldWidget fresh(world);
+    fresh.Resize({6, 5});
+    fresh.SetCameraCenterPixels(camera);
+    fresh.Paint(*freshTarget->BeginDraw());
+
+    for (e00::BitmapSizeType y = 0; y < 5; ++y) {
+      const auto a = scrolledTarget->GetLineData(y);
+      const auto b = freshTarget->GetLineData(y);
+      CHECK(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+    }
+  }
+
+  // Changing a tile repaints the whole view
+  world->Map()->Set({6, 4}, 1);
+  scrolled.Paint(*scrolledTarget->BeginDraw());
+  e00::WorldWidget fresh(world);
+  fresh.Resize({6, 5});
+  fresh.SetCameraCenterPixels(cameraPath.back());
+  fresh.Paint(*freshTarget->BeginDraw());
+  for (e00::BitmapSizeType y = 0; y < 5; ++y) {
+    const auto a = scrolledTarget->GetLineData(y);
+    const auto b = freshTarget->GetLineData(y);
+    CHECK(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+  }
+
+  // A smaller view gets a buffer of its own size
+  scrolled.Resize({4, 3});
+  scrolled.Paint(*scrolledTarget->BeginDraw());
+  e00::WorldWidget smaller(world);
+  smaller.Resize({4, 3});
+  smaller.SetCameraCenterPixels(cameraPath.back());
+  smaller.Paint(*freshTarget->BeginDraw());
+  for (e00::BitmapSizeType y = 0; y < 3; ++y) {
+    const auto a = scrolledTarget->GetLineData(y).first(4 * e00::DepthEnumToBits(depth) / 8);
+    const auto b = freshTarget->GetLineData(y).first(4 * e00::DepthEnumToBits(depth) / 8);
+    CHECK(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+  }
+}
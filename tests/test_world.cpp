@@ -32,3 +32,162 @@ e00::ResourcePtrT<e00::Map> LoadMap() {
 TEST_CASE("Can load a basic world with map", "[world]") {
 
 }
+
+TEST_CASE("World - Spatial queries", "[world]") {
+  auto world = std::make_unique<e00::World>("query world");
+  world->AddMap(LoadMap());
+
+  std::vector<NPCActor> actors(40);
+  std::vector<e00::World::NodeID> ids;
+  for (uint16_t i = 0; i < actors.size(); ++i) {
+    ids.push_back(world->Insert(&actors[i], {static_cast<uint16_t>(i * 4), i}));
+    REQUIRE(ids.back() != e00::World::InvalidNodeID);
+  }
+  CHECK(world->NumActors() == 40);
+
+  // Outside of the map
+  CHECK(world->Insert(&actors[0], {200, 10}) == e00::World::InvalidNodeID);
+
+  std::vector<e00::World::NodeID> found;
+  world->Query({{0, 0}, {20, 50}}, found);
+  std::ranges::sort(found);
+  CHECK(found == std::vector<e00::World::NodeID>{ids[0], ids[1], ids[2], ids[3], ids[4]});
+
+  // Moved out of the area, removed, and the freed slot is handed out again
+  world->Update(ids[1], {150, 40});
+  world->Remove(ids[2]);
+  CHECK(world->NumActors() == 39);
+
+  found.clear();
+  world->Query({{0, 0}, {20, 50}}, found);
+  std::ranges::sort(found);
+  CHECK(found == std::vector<e00::World::NodeID>{ids[0], ids[3], ids[4]});
+
+  // The slot is reused, the old handle stays dead
+  const auto reused = world->Insert(&actors[2], {1, 1});
+  CHECK(reused != ids[2]);
+  CHECK(world->Contains(reused));
+  CHECK_FALSE(world->Contains(ids[2]));
+  CHECK(world->GetActor(ids[2]) == nullptr);
+  world->Update(ids[2], {5, 5});
+  CHECK(world->PositionOf(reused) == e00::Vec2D<uint16_t>{1, 1});
+
+  found.clear();
+  world->Nearest({150, 41}, 2, found);
+  REQUIRE(found.size() == 2);
+  CHECK(found[0] == ids[1]);
+  CHECK(found[1] == ids[38]);
+}
+
+TEST_CASE("World - Packed actor columns", "[world]") {
+  auto world = std::make_unique<e00::World>("packed world");
+  world->AddMap(LoadMap());
+
+  std::vector<NPCActor> actors(10);
+  std::vector<e00::World::NodeID> ids;
+  for (uint16_t i = 0; i < actors.size(); ++i) {
+    actors[i].Size({2, 3});
+    ids.push_back(world->Insert(&actors[i], {static_cast<uint16_t>(i * 10), 5}));
+  }
+
+  // Removing from the middle moves the last actor into the hole, its handle still works
+  world->Remove(ids[3]);
+  auto columns = world->Actors();
+  REQUIRE(columns.actor.size() == 9);
+  CHECK(columns.actor[3] == &actors[9]);
+  CHECK(columns.handle[3] == ids[9]);
+  CHECK(world->PositionOf(ids[9]) == e00::Vec2D<uint16_t>{90, 5});
+  CHECK(world->BoundsOf(ids[9]) == e00::RectT<uint16_t>{90, 5, 2, 3});
+
+  // Bounds overlap, not just the position
+  std::vector<e00::World::NodeID> found;
+  world->Overlapping({{11, 7}, {10, 10}}, found);
+  std::ranges::sort(found);
+  CHECK(found == std::vector<e00::World::NodeID>{ids[1], ids[2]});
+
+  // Moving flags the actor
+  world->Update(ids[4], {41, 6});
+  columns = world->Actors();
+  for (size_t i = 0; i < columns.flags.size(); ++i) {
+    CHECK(((columns.flags[i] & e00::World::FlagMoved) != 0) == (columns.handle[i] == ids[4]));
+  }
+  world->ClearFlags(e00::World::FlagMoved);
+  CHECK(std::ranges::all_of(world->Actors().flags, [](auto f) { return f == 0; }));
+}
+
+TEST_CASE("World - Positions stay inside the map", "[world]") {
+  auto world = std::make_unique<e00::World>("bounded world");
+  world->AddMap(LoadMap());
+
+  NPCActor actor;
+  const auto id = world->Insert(&actor, {150, 40});
+  REQUIRE(id != e00::World::InvalidNodeID);
+  CHECK(world->Insert(&actor, {160, 0}) == e00::World::InvalidNodeID);
+
+  world->Update(id, {200, 40});
+  CHECK(world->PositionOf(id) == e00::Vec2D<uint16_t>{150, 40});
+
+  // A smaller map pulls the actor back onto its edge, where queries still find it
+  world->AddMap(e00::ResourceManager::GlobalResourceManager().TakeOwnership(std::make_unique<e00::Map>(20, 10)));
+  CHECK(world->PositionOf(id) == e00::Vec2D<uint16_t>{19, 9});
+
+  std::vector<e00::World::NodeID> found;
+  world->Query({{15, 5}, {5, 5}}, found);
+  CHECK(found == std::vector<e00::World::NodeID>{id});
+}
+
+TEST_CASE("World - Broad phase overlaps", "[world]") {
+  auto world = std::make_unique<e00::World>("overlap world");
+  world->AddMap(LoadMap());
+
+  NPCActor hero, wall, otherWall, trigger, far;
+  hero.Type(e00::Actor::BodyType::Dynamic);
+  trigger.Type(e00::Actor::BodyType::None);
+  for (auto *actor : {&hero, &wall, &otherWall, &trigger, &far}) {
+    actor->Size({4, 4});
+  }
+
+  const auto heroId = world->Insert(&hero, {10, 10});
+  const auto wallId = world->Insert(&wall, {12, 12});
+  world->Insert(&otherWall, {15, 15});
+  const auto triggerId = world->Insert(&trigger, {8, 8});
+  world->Insert(&far, {100, 10});
+
+  // Static/static and static/trigger never pair, the dynamic actor always comes first
+  std::vector<e00::World::OverlapPair> pairs;
+  world->FindOverlaps(pairs);
+  std::ranges::sort(pairs, {}, &e00::World::OverlapPair::second);
+  CHECK(pairs == std::vector<e00::World::OverlapPair>{{heroId, wallId}, {heroId, triggerId}});
+
+  // Same result as testing every pair
+  world = std::make_unique<e00::World>("crowded world");
+  world->AddMap(LoadMap());
+
+  std::vector<NPCActor> crowd(512);
+  std::vector<e00::World::NodeID> ids;
+  uint32_t seed = 12345;
+  const auto next = [&seed](uint32_t range) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) % range;
+  };
+  for (auto &actor : crowd) {
+    actor.Type(static_cast<e00::Actor::BodyType>(next(3)));
+    actor.Size({static_cast<uint16_t>(1 + next(6)), static_cast<uint16_t>(1 + next(6))});
+    ids.push_back(world->Insert(&actor, {static_cast<uint16_t>(next(150)), static_cast<uint16_t>(next(45))}));
+  }
+
+  size_t expected = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    for (size_t j = i + 1; j < ids.size(); ++j) {
+      if (crowd[i].Type() != e00::Actor::BodyType::Dynamic && crowd[j].Type() != e00::Actor::BodyType::Dynamic) continue;
+      if (world->BoundsOf(ids[i]).Contains(world->BoundsOf(ids[j]))) ++expected;
+    }
+  }
+
+  pairs.clear();
+  world->FindOverlaps(pairs);
+  CHECK(pairs.size() == expected);
+  CHECK(std::ranges::all_of(pairs, [&world](const auto &pair) {
+    return world->GetActor(pair.first)->Type() == e00::Actor::BodyType::Dynamic;
+  }));
+}
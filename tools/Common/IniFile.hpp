@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Just enough of an ini reader for the tools: `[section]` lines, `key = value` lines, `#` and `;` comments
+ */
+namespace tools {
+struct IniItem {
+  std::string section;
+  std::string key;
+  std::string value;
+};
+
+inline std::string_view Trim(std::string_view str) {
+  const auto first = str.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return str.substr(first, str.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+inline std::vector<IniItem> ReadIni(std::string_view text) {
+  std::vector<IniItem> items;
+  std::string_view section;
+
+  while (!text.empty()) {
+    const auto end = text.find('\n');
+    const auto line = Trim(text.substr(0, end));
+    text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+
+    if (line.empty() || line.front() == '#' || line.front() == ';') {
+      continue;
+    }
+
+    if (line.front() == '[' && line.back() == ']') {
+      section = Trim(line.substr(1, line.size() - 2));
+      continue;
+    }
+
+    if (const auto equals = line.find('='); equals != std::string_view::npos) {
+      items.push_back({std::string(section), std::string(Trim(line.substr(0, equals))), std::string(Trim(line.substr(equals + 1)))});
+    }
+  }
+
+  return items;
+}
+}// namespace tools
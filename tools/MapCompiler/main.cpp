@@ -0,0 +1,213 @@
+/**
+ * Compiles a map, its world ini and comma separated tile set, into the format the engine loads fastest,
+ * see MapFormat.hpp
+ *
+ * Usage: e00mapc <world ini> <compiled map>
+ *
+ * The `set` of the world is looked up in the `resourcemap` section of the game.ini next to the world ini,
+ * then as a file name.
+ */
+#include <Engine/Platform/MapFormat.hpp>
+#include <Engine/Resource.hpp>
+
+#include "../Common/IniFile.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+namespace fs = std::filesystem;
+
+bool ReadFile(const fs::path &path, std::string &data) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+bool ToNumber(std::string_view str, unsigned &value) {
+  const auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+  return result.ec == std::errc{} && result.ptr == str.data() + str.size();
+}
+
+// The file a resource name refers to: its game.ini alias if it has one, the name itself otherwise
+fs::path ResolveResource(const fs::path &directory, const std::string &name) {
+  if (std::string gameIni; ReadFile(directory / "game.ini", gameIni)) {
+    for (const auto &item: tools::ReadIni(gameIni)) {
+      if (item.section == "resourcemap" && item.key == name) {
+        return directory / item.value;
+      }
+    }
+  }
+  return directory / name;
+}
+
+/**
+ * Reads the tiles the way the engine reads the text set: numbers separated by commas, anything else
+ * ignored. Unlike the engine, empty entries and extra tiles are errors.
+ */
+bool ParseSet(std::string_view text, std::vector<uint32_t> &tiles) {
+  size_t tile = 0;
+  long current = -1;
+
+  const auto place = [&]() {
+    if (current == -1) {
+      std::fprintf(stderr, "Tile %zu of the set is empty\n", tile);
+      return false;
+    }
+    if (tile >= tiles.size()) {
+      std::fprintf(stderr, "The set has more than the %zu tiles of the map\n", tiles.size());
+      return false;
+    }
+    tiles[tile++] = static_cast<uint32_t>(current);
+    current = -1;
+    return true;
+  };
+
+  for (const char c: text) {
+    if (c >= '0' && c <= '9') {
+      current = (current == -1 ? 0 : current * 10) + (c - '0');
+      if (current > UINT16_MAX) {
+        std::fprintf(stderr, "Tile %zu of the set is larger than %u\n", tile, UINT16_MAX);
+        return false;
+      }
+    } else if (c == ',' && !place()) {
+      return false;
+    }
+  }
+
+  return current == -1 || place();
+}
+
+void AppendId(std::vector<uint8_t> &out, uint32_t id, size_t idSize) {
+  out.push_back(static_cast<uint8_t>(id));
+  if (idSize == 2) {
+    out.push_back(static_cast<uint8_t>(id >> 8));
+  }
+}
+
+std::vector<uint8_t> EncodeRaw(const std::vector<uint32_t> &tiles, size_t idSize) {
+  std::vector<uint8_t> out;
+  out.reserve(tiles.size() * idSize);
+  for (const auto id: tiles) {
+    AppendId(out, id, idSize);
+  }
+  return out;
+}
+
+std::vector<uint8_t> EncodeRunLength(const std::vector<uint32_t> &tiles, size_t idSize) {
+  std::vector<uint8_t> out;
+  for (size_t i = 0; i < tiles.size();) {
+    size_t count = 1;
+    while (i + count < tiles.size() && count < UINT8_MAX && tiles[i + count] == tiles[i]) {
+      ++count;
+    }
+    out.push_back(static_cast<uint8_t>(count));
+    AppendId(out, tiles[i], idSize);
+    i += count;
+  }
+  return out;
+}
+}// namespace
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s <world ini> <compiled map>\n", argv[0]);
+    return 1;
+  }
+
+  const fs::path input(argv[1]);
+  const fs::path output(argv[2]);
+
+  std::string worldIni;
+  if (!ReadFile(input, worldIni)) {
+    std::fprintf(stderr, "Unable to read %s\n", input.string().c_str());
+    return 1;
+  }
+
+  unsigned width = 0;
+  unsigned height = 0;
+  std::string tileset;
+  std::string set;
+  for (const auto &item: tools::ReadIni(worldIni)) {
+    if (item.section != "map") {
+      continue;
+    }
+
+    if ((item.key == "width" && !ToNumber(item.value, width)) || (item.key == "height" && !ToNumber(item.value, height))) {
+      std::fprintf(stderr, "Invalid %s %s\n", item.key.c_str(), item.value.c_str());
+      return 1;
+    }
+    if (item.key == "tileset") {
+      tileset = item.value;
+    } else if (item.key == "set") {
+      set = item.value;
+    }
+  }
+
+  if (width == 0 || height == 0 || width > UINT16_MAX || height > UINT16_MAX) {
+    std::fprintf(stderr, "%s needs a width and a height, from 1 to %u, in its [map] section\n", input.string().c_str(), UINT16_MAX);
+    return 1;
+  }
+
+  // Tiles the set doesn't give are left empty, as in the engine
+  std::vector<uint32_t> tiles(static_cast<size_t>(width) * height);
+  if (!set.empty()) {
+    const auto setFile = ResolveResource(input.parent_path(), set);
+    std::string text;
+    if (!ReadFile(setFile, text)) {
+      std::fprintf(stderr, "Unable to read set %s\n", setFile.string().c_str());
+      return 1;
+    }
+    if (!ParseSet(text, tiles)) {
+      std::fprintf(stderr, "Invalid set %s\n", setFile.string().c_str());
+      return 1;
+    }
+  }
+
+  const size_t idSize = std::ranges::max(tiles) <= UINT8_MAX ? 1 : 2;
+  auto raw = EncodeRaw(tiles, idSize);
+  auto runs = EncodeRunLength(tiles, idSize);
+  const bool useRuns = runs.size() < raw.size();
+  const auto &layerData = useRuns ? runs : raw;
+
+  std::ofstream out(output, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::fprintf(stderr, "Unable to create %s\n", output.string().c_str());
+    return 1;
+  }
+
+  const e00::mapfile::Header header{
+      .magic = e00::mapfile::Magic,
+      .version = e00::mapfile::Version,
+      .width = static_cast<std::uint16_t>(width),
+      .height = static_cast<std::uint16_t>(height),
+      .tileset = tileset.empty() ? 0 : e00::HashName(tileset),
+      .tile_id_size = static_cast<std::uint8_t>(idSize),
+      .layer_count = 1,
+      .reserved = 0};
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  const e00::mapfile::LayerHeader layer{
+      .encoding = static_cast<std::uint8_t>(useRuns ? e00::mapfile::Encoding::RunLength : e00::mapfile::Encoding::Raw),
+      .reserved = {},
+      .size = static_cast<std::uint32_t>(layerData.size())};
+  out.write(reinterpret_cast<const char *>(&layer), sizeof(layer));
+  out.write(reinterpret_cast<const char *>(layerData.data()), static_cast<std::streamsize>(layerData.size()));
+
+  if (!out) {
+    std::fprintf(stderr, "Unable to write %s\n", output.string().c_str());
+    return 1;
+  }
+
+  std::printf("Compiled %ux%u map into %s: %zu bytes of %s tile ids\n", width, height, output.string().c_str(), layerData.size(), useRuns ? "run length" : "raw");
+  return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * Packs a resource directory into one archive the engine mounts at startup, see ArchiveFormat.hpp
+ *
+ * Usage: e00pack <resource directory> <archive>
+ */
+#include <Engine/Platform/ArchiveFormat.hpp>
+#include <Engine/Resource.hpp>
+
+#include "../Common/IniFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+namespace fs = std::filesystem;
+
+struct PackedFile {
+  std::string name;
+  std::vector<char> data;
+  std::uint32_t offset{};
+};
+
+bool ReadFile(const fs::path &path, std::vector<char> &data) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+// The `resourcemap` section of game.ini: alias -> file name
+std::vector<std::pair<std::string, std::string>> ReadResourceMap(const std::vector<char> &ini) {
+  std::vector<std::pair<std::string, std::string>> aliases;
+  for (auto &item: tools::ReadIni(std::string_view(ini.data(), ini.size()))) {
+    if (item.section == "resourcemap") {
+      aliases.emplace_back(std::move(item.key), std::move(item.value));
+    }
+  }
+  return aliases;
+}
+}// namespace
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s <resource directory> <archive>\n", argv[0]);
+    return 1;
+  }
+
+  const fs::path directory(argv[1]);
+  const fs::path output(argv[2]);
+
+  // Every file of the directory, archives excepted; sorted so the archive doesn't depend on the file system
+  std::vector<PackedFile> files;
+  std::error_code ec;
+  for (const auto &item: fs::directory_iterator(directory, ec)) {
+    if (!item.is_regular_file() || item.path().extension() == fs::path(e00::archive::DefaultName).extension()) {
+      continue;
+    }
+
+    PackedFile file;
+    file.name = item.path().filename().string();
+    if (!ReadFile(item.path(), file.data)) {
+      std::fprintf(stderr, "Unable to read %s\n", item.path().string().c_str());
+      return 1;
+    }
+    files.push_back(std::move(file));
+  }
+
+  if (ec) {
+    std::fprintf(stderr, "Unable to list %s: %s\n", directory.string().c_str(), ec.message().c_str());
+    return 1;
+  }
+  std::ranges::sort(files, {}, &PackedFile::name);
+
+  // Index every file by name, then by the aliases game.ini gives it
+  std::map<e00::ResourceId, const PackedFile *> index;
+  const auto addEntry = [&](std::string_view name, const PackedFile &file) {
+    const auto [it, added] = index.emplace(e00::HashName(name), &file);
+    if (!added && it->second != &file) {
+      std::fprintf(stderr, "%.*s and %s have the same id %u\n", static_cast<int>(name.size()), name.data(), it->second->name.c_str(), it->first);
+      return false;
+    }
+    return true;
+  };
+
+  for (const auto &file: files) {
+    if (!addEntry(file.name, file)) {
+      return 1;
+    }
+  }
+
+  if (const auto ini = std::ranges::find(files, std::string_view("game.ini"), &PackedFile::name); ini != files.end()) {
+    for (const auto &[alias, name]: ReadResourceMap(ini->data)) {
+      const auto file = std::ranges::find(files, name, &PackedFile::name);
+      if (file == files.end()) {
+        std::fprintf(stderr, "Alias %s refers to %s, which isn't in %s\n", alias.c_str(), name.c_str(), directory.string().c_str());
+        return 1;
+      }
+      if (!addEntry(alias, *file)) {
+        return 1;
+      }
+    }
+  }
+
+  // Data follows the index
+  std::uint64_t offset = sizeof(e00::archive::Header) + index.size() * sizeof(e00::archive::IndexEntry);
+  for (auto &file: files) {
+    if (offset + file.data.size() > UINT32_MAX) {
+      std::fprintf(stderr, "Archive would be larger than 4GB\n");
+      return 1;
+    }
+    file.offset = static_cast<std::uint32_t>(offset);
+    offset += file.data.size();
+  }
+
+  std::ofstream out(output, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::fprintf(stderr, "Unable to create %s\n", output.string().c_str());
+    return 1;
+  }
+
+  const e00::archive::Header header{
+      .magic = e00::archive::Magic,
+      .version = e00::archive::Version,
+      .entry_count = static_cast<std::uint32_t>(index.size()),
+      .reserved = 0};
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  // std::map keeps the ids sorted, as the engine expects
+  for (const auto &[id, file]: index) {
+    const e00::archive::IndexEntry entry{
+        .id = id,
+        .offset = file->offset,
+        .size = static_cast<std::uint32_t>(file->data.size())};
+    out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+  }
+
+  for (const auto &file: files) {
+    out.write(file.data.data(), static_cast<std::streamsize>(file.data.size()));
+  }
+
+  if (!out) {
+    std::fprintf(stderr, "Unable to write %s\n", output.string().c_str());
+    return 1;
+  }
+
+  std::printf("Packed %zu files under %zu ids into %s\n", files.size(), index.size(), output.string().c_str());
+  return 0;
+}